@@ -1,5 +1,227 @@
+#include "EastlAllocator.hpp"
+
+#include <EASTL/sort.h>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace RR::Common
+{
+    namespace
+    {
+        // Aligned allocations are freed by the same call as plain ones, so every block keeps a header
+        // right before the returned pointer with the block start, the size and the tracker slot.
+        struct BlockHeader
+        {
+            void* base;
+            size_t size;
+            uint32_t tagIndex;
+        };
+
+        constexpr size_t HeaderSpace = (sizeof(BlockHeader) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        constexpr uint32_t UntrackedTag = ~0u;
+
+        struct TagSlot
+        {
+            std::atomic<const char*> tag;
+            std::atomic<size_t> bytes;
+            std::atomic<size_t> peakBytes;
+            std::atomic<size_t> count;
+            std::atomic<size_t> totalCount;
+        };
+
+        // Zero initialized before any dynamic initialization, so allocations from static constructors are safe.
+        TagSlot tagSlots[EastlAllocationTracker::MaxTagsCount];
+        std::atomic<bool> trackingEnabled = false;
+
+        constexpr const char* UnnamedTag = "unnamed";
+        // Last slot collects tags that didn't fit into the table.
+        constexpr const char* OverflowTag = "other";
+
+        uint32_t hashTag(const char* tag)
+        {
+            uint32_t hash = 2166136261u;
+            for (; *tag; tag++)
+                hash = (hash ^ uint8_t(*tag)) * 16777619u;
+            return hash;
+        }
+
+        uint32_t findTagSlot(const char* tag)
+        {
+            if (!tag)
+                tag = UnnamedTag;
+
+            // Same name may come from different string literals, so slots are matched by content.
+            // First pointer seen for a name is stored as is, names are expected to be static.
+            constexpr uint32_t probeCount = EastlAllocationTracker::MaxTagsCount - 1;
+            const uint32_t hash = hashTag(tag);
+            for (uint32_t probe = 0; probe < probeCount; probe++)
+            {
+                const uint32_t index = (hash + probe) % probeCount;
+                auto& slot = tagSlots[index];
+
+                const char* slotTag = slot.tag.load(std::memory_order_acquire);
+                if (!slotTag && slot.tag.compare_exchange_strong(slotTag, tag, std::memory_order_acq_rel))
+                    return index;
+
+                if (std::strcmp(slotTag, tag) == 0)
+                    return index;
+            }
+
+            const uint32_t overflowIndex = probeCount;
+            const char* expected = nullptr;
+            tagSlots[overflowIndex].tag.compare_exchange_strong(expected, OverflowTag, std::memory_order_acq_rel);
+            return overflowIndex;
+        }
+
+        void trackAllocation(uint32_t tagIndex, size_t size)
+        {
+            auto& slot = tagSlots[tagIndex];
+            const size_t bytes = slot.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            slot.totalCount.fetch_add(1, std::memory_order_relaxed);
+
+            size_t peak = slot.peakBytes.load(std::memory_order_relaxed);
+            while (peak < bytes && !slot.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) { }
+        }
+
+        void trackDeallocation(uint32_t tagIndex, size_t size)
+        {
+            auto& slot = tagSlots[tagIndex];
+            slot.bytes.fetch_sub(size, std::memory_order_relaxed);
+            slot.count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // Address of (result + alignmentOffset) is aligned to alignment, as EASTL expects.
+        void* allocateBlock(size_t size, size_t alignment, size_t alignmentOffset, const char* tag)
+        {
+            alignment = eastl::max(alignment, alignof(std::max_align_t));
+            ASSERT(IsPowerOfTwo(alignment));
+
+            // malloc already gives max_align_t alignment, extra space is only needed for stricter requests.
+            const bool isDefaultAligned = alignment == alignof(std::max_align_t) && alignmentOffset % alignment == 0;
+            const size_t extra = isDefaultAligned ? 0 : alignment - 1;
+
+            auto* base = static_cast<std::byte*>(std::malloc(size + HeaderSpace + extra));
+            if (!base)
+                return nullptr;
+
+            std::byte* memory = isDefaultAligned ? base + HeaderSpace : AlignTo(base + HeaderSpace + alignmentOffset, alignment) - alignmentOffset;
+
+            BlockHeader header {base, size, UntrackedTag};
+            if (trackingEnabled.load(std::memory_order_relaxed))
+            {
+                header.tagIndex = findTagSlot(tag);
+                trackAllocation(header.tagIndex, size);
+            }
+
+            // Header is not necessarily aligned when alignment offset is odd.
+            std::memcpy(memory - sizeof(BlockHeader), &header, sizeof(BlockHeader));
+            return memory;
+        }
 
+        void deallocateBlock(void* memory)
+        {
+            if (!memory)
+                return;
+
+            BlockHeader header;
+            std::memcpy(&header, static_cast<std::byte*>(memory) - sizeof(BlockHeader), sizeof(BlockHeader));
+
+            if (header.tagIndex != UntrackedTag)
+                trackDeallocation(header.tagIndex, header.size);
+
+            std::free(header.base);
+        }
+
+        void* allocateOrThrow(size_t size, size_t alignment, size_t alignmentOffset, const char* tag)
+        {
+            void* memory = allocateBlock(size, alignment, alignmentOffset, tag);
+            if (!memory)
+                throw std::bad_alloc();
+
+            return memory;
+        }
+    }
+
+    void* EastlAllocator::allocate(size_t size, int flags)
+    {
+        UNUSED(flags);
+        return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, 0, name);
+    }
+
+    void* EastlAllocator::allocate(size_t size, size_t alignment, size_t alignmentOffset, int flags)
+    {
+        UNUSED(flags);
+        return allocateOrThrow(size, alignment, alignmentOffset, name);
+    }
+
+    void EastlAllocator::deallocate(void* memory, size_t size)
+    {
+        UNUSED(size);
+        deallocateBlock(memory);
+    }
+
+    EastlAllocator* GetDefaultEastlAllocator()
+    {
+        static EastlAllocator allocator;
+        return &allocator;
+    }
+
+    void EastlAllocationTracker::SetEnabled(bool enabled)
+    {
+        trackingEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool EastlAllocationTracker::IsEnabled()
+    {
+        return trackingEnabled.load(std::memory_order_relaxed);
+    }
+
+    size_t EastlAllocationTracker::GetStats(TagStats* stats, size_t maxCount)
+    {
+        size_t written = 0;
+        for (const auto& slot : tagSlots)
+        {
+            if (written == maxCount)
+                break;
+
+            const char* tag = slot.tag.load(std::memory_order_acquire);
+            if (!tag)
+                continue;
+
+            stats[written++] = {
+                tag,
+                slot.bytes.load(std::memory_order_relaxed),
+                slot.peakBytes.load(std::memory_order_relaxed),
+                slot.count.load(std::memory_order_relaxed),
+                slot.totalCount.load(std::memory_order_relaxed)};
+        }
+
+        return written;
+    }
+
+    void EastlAllocationTracker::Dump()
+    {
+        eastl::array<TagStats, MaxTagsCount> stats;
+        const size_t count = GetStats(stats.data(), stats.size());
+        eastl::sort(stats.begin(), stats.begin() + count, [](const TagStats& lhs, const TagStats& rhs) { return lhs.bytes > rhs.bytes; });
+
+        std::string report = fmt::format("EASTL allocations, {} tags:\n", count);
+        for (size_t index = 0; index < count; index++)
+        {
+            const auto& tag = stats[index];
+            report += fmt::format("  {}: {} bytes in {} blocks, peak {} bytes, {} allocations total\n", tag.tag, tag.bytes, tag.count, tag.peakBytes, tag.totalCount);
+        }
+
+        LOG_INFO("{}", report);
+    }
+}
+
+// Used only by eastl::allocator, which EASTL library itself may use and which frees with plain delete[].
+// Containers go through EastlAllocator, so these don't need alignment or tracking.
 void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
 {
     UNUSED(name, flags, debugFlags, file, line);
@@ -10,4 +232,4 @@ void* __cdecl operator new[](size_t size, size_t alignment, size_t alignmentOffs
 {
     UNUSED(alignment, alignmentOffset, pName, flags, debugFlags, file, line);
     return new uint8_t[size];
-}
\ No newline at end of file
+}
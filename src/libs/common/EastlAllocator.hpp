@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+// Included by EASTL config through EASTL_USER_CONFIG_HEADER, see CMakeLists.txt, so it's seen before any EASTL container.
+
+namespace RR::Common
+{
+    // Allocator of EASTL containers. Honors alignment and alignment offset of EASTL requests and reports allocations
+    // to EastlAllocationTracker by allocator name. Global operators new and delete are left to the standard library.
+    class EastlAllocator
+    {
+    public:
+        // Not explicit, the same as eastl::allocator, as EASTL converts names to allocators.
+        EastlAllocator(const char* name = nullptr) : name(name) { }
+        EastlAllocator(const EastlAllocator& other) = default;
+        EastlAllocator(const EastlAllocator&, const char* name) : name(name) { }
+        EastlAllocator& operator=(const EastlAllocator& other) = default;
+
+        void* allocate(size_t size, int flags = 0);
+        void* allocate(size_t size, size_t alignment, size_t alignmentOffset, int flags = 0);
+        void deallocate(void* memory, size_t size);
+
+        const char* get_name() const { return name; }
+        void set_name(const char* newName) { name = newName; }
+
+    private:
+        const char* name;
+    };
+
+    // Name is the only state, so memory allocated by one allocator is freed by any other.
+    inline bool operator==(const EastlAllocator&, const EastlAllocator&) { return true; }
+    inline bool operator!=(const EastlAllocator&, const EastlAllocator&) { return false; }
+
+    EastlAllocator* GetDefaultEastlAllocator();
+
+    // Opt-in accounting of EASTL allocations grouped by allocator name (pName) of the container.
+    // Only allocations made while tracking is enabled are counted, so toggling it doesn't skew the numbers.
+    // Tags are kept by pointer and never released, so allocator names must have static storage duration,
+    // like the string literals EASTL_NAME_VAL produces.
+    class EastlAllocationTracker final
+    {
+    public:
+        struct TagStats
+        {
+            const char* tag;
+            size_t bytes;
+            size_t peakBytes;
+            size_t count;
+            size_t totalCount;
+        };
+
+        static constexpr size_t MaxTagsCount = 256;
+
+        static void SetEnabled(bool enabled);
+        [[nodiscard]] static bool IsEnabled();
+
+        // Copies up to maxCount tags into stats, returns how many were written.
+        static size_t GetStats(TagStats* stats, size_t maxCount);
+        // Logs every tag sorted by live bytes.
+        static void Dump();
+    };
+}
+
+#define EASTLAllocatorType RR::Common::EastlAllocator
+#define EASTLAllocatorDefault RR::Common::GetDefaultEastlAllocator
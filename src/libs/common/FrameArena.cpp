@@ -0,0 +1,224 @@
+#include "FrameArena.hpp"
+
+namespace RR::Common
+{
+    namespace
+    {
+        struct LocalArenaCache
+        {
+            struct Entry
+            {
+                uint64_t instanceId = 0;
+                FrameArena* arena = nullptr;
+            };
+
+            // Entries of destroyed instances never match again, as instance ids are not reused.
+            Entry entries[ThreadFrameArenas::LocalCacheSize];
+            // Oldest entry, replaced by the next registered instance.
+            size_t next = 0;
+        };
+
+        thread_local LocalArenaCache localArenaCache;
+        std::atomic<uint64_t> nextInstanceId = 1;
+    }
+
+    ArenaPagePool::ArenaPagePool(size_t pageSize) : pageSize(pageSize)
+    {
+        static_assert(sizeof(void*) == sizeof(uint64_t), "Tagged free list expects 64 bit pointers");
+        ASSERT(pageSize >= sizeof(FreePage));
+    }
+
+    ArenaPagePool::~ArenaPagePool()
+    {
+        ASSERT_MSG(GetFreePagesCount() == GetPagesCount(), "Pages are still held by arenas");
+
+        FreePage* page = unpackPage(freeHead.load(std::memory_order_acquire));
+        while (page)
+        {
+            FreePage* next = page->next.load(std::memory_order_relaxed);
+            page->~FreePage();
+            delete[] reinterpret_cast<std::byte*>(page);
+            page = next;
+        }
+    }
+
+    std::byte* ArenaPagePool::Acquire()
+    {
+        uint64_t head = freeHead.load(std::memory_order_acquire);
+        while (FreePage* page = unpackPage(head))
+        {
+            // Tag changes on every successful exchange, so a page taken and returned in between fails the exchange.
+            const uint64_t next = pack(page->next.load(std::memory_order_relaxed), unpackTag(head) + 1);
+            if (freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                freePagesCount.fetch_sub(1, std::memory_order_relaxed);
+                page->~FreePage();
+                return reinterpret_cast<std::byte*>(page);
+            }
+        }
+
+        pagesCount.fetch_add(1, std::memory_order_relaxed);
+        return new std::byte[pageSize];
+    }
+
+    void ArenaPagePool::Release(std::byte* memory)
+    {
+        ASSERT(memory);
+
+        FreePage* page = new (memory) FreePage();
+        uint64_t head = freeHead.load(std::memory_order_relaxed);
+        do
+        {
+            page->next.store(unpackPage(head), std::memory_order_relaxed);
+        } while (!freeHead.compare_exchange_weak(head, pack(page, unpackTag(head) + 1), std::memory_order_release, std::memory_order_relaxed));
+
+        freePagesCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ArenaPagePool& ArenaPagePool::Global()
+    {
+        static ArenaPagePool pool;
+        return pool;
+    }
+
+    FrameArena::~FrameArena()
+    {
+        for (auto page : pages)
+            pool.Release(page);
+    }
+
+    void FrameArena::rollback(const Marker& marker)
+    {
+        ASSERT(marker.usedBytes <= stats.usedBytes);
+        ASSERT(marker.oversizedCount <= oversized.size());
+
+        oversized.resize(marker.oversizedCount);
+        stats.usedBytes = marker.usedBytes;
+        stats.wasteBytes = marker.wasteBytes;
+        stats.oversizedCount = marker.oversizedCount;
+
+        if (pages.empty())
+            return;
+
+        // Marker taken before the first page was acquired points to the start of the first page.
+        setPage(marker.cursor ? marker.pageIndex : 0);
+        if (marker.cursor)
+            cursor = marker.cursor;
+    }
+
+    void FrameArena::trim(size_t keepPagesCount)
+    {
+        ASSERT_MSG(stats.usedBytes == 0, "Arena should be reset before trim");
+
+        while (pages.size() > keepPagesCount)
+        {
+            pool.Release(pages.back());
+            pages.pop_back();
+        }
+        stats.pagesCount = pages.size();
+
+        if (pages.empty())
+        {
+            pageIndex = 0;
+            cursor = limit = 0;
+        }
+    }
+
+    void* FrameArena::allocateSlow(std::size_t size, std::size_t alignment)
+    {
+        ASSERT(IsPowerOfTwo(alignment));
+
+        if (size + alignment - 1 > pool.GetPageSize())
+        {
+            auto& block = oversized.emplace_back(new std::byte[size + alignment - 1]);
+            std::byte* aligned = AlignTo(block.get(), alignment);
+
+            stats.wasteBytes += alignment - 1;
+            stats.usedBytes += size + alignment - 1;
+            stats.peakBytes = eastl::max(stats.peakBytes, stats.usedBytes);
+            stats.oversizedCount = oversized.size();
+            return aligned;
+        }
+
+        // Tail of the current page is left behind.
+        stats.wasteBytes += limit - cursor;
+
+        const size_t nextIndex = pages.empty() ? 0 : pageIndex + 1;
+        if (nextIndex == pages.size())
+        {
+            pages.push_back(pool.Acquire());
+            stats.pagesCount = pages.size();
+        }
+
+        setPage(nextIndex);
+        return allocate(size, alignment);
+    }
+
+    void FrameArena::setPage(size_t index)
+    {
+        pageIndex = index;
+        cursor = reinterpret_cast<uintptr_t>(pages[index]);
+        limit = cursor + pool.GetPageSize();
+    }
+
+    FrameArena& FrameArena::ForCurrentThread()
+    {
+        thread_local FrameArena arena;
+        return arena;
+    }
+
+    ThreadFrameArenas::ThreadFrameArenas(ArenaPagePool& pool)
+        : pool(pool),
+          instanceId(nextInstanceId.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    FrameArena& ThreadFrameArenas::local()
+    {
+        for (const auto& entry : localArenaCache.entries)
+            if (entry.instanceId == instanceId)
+                return *entry.arena;
+
+        return registerThread();
+    }
+
+    FrameArena& ThreadFrameArenas::registerThread()
+    {
+        const auto threadId = std::this_thread::get_id();
+
+        Threading::ReadWriteGuard<Threading::SpinLock> guard(lock);
+        auto it = eastl::find_if(arenas.begin(), arenas.end(), [threadId](const ThreadArena& entry) { return entry.threadId == threadId; });
+        if (it == arenas.end())
+            it = arenas.insert(arenas.end(), ThreadArena {threadId, std::make_unique<FrameArena>(pool)});
+
+        localArenaCache.entries[localArenaCache.next] = {instanceId, it->arena.get()};
+        localArenaCache.next = (localArenaCache.next + 1) % ThreadFrameArenas::LocalCacheSize;
+        return *it->arena;
+    }
+
+    void ThreadFrameArenas::reset()
+    {
+        Threading::ReadWriteGuard<Threading::SpinLock> guard(lock);
+        for (auto& entry : arenas)
+            entry.arena->reset();
+    }
+
+    FrameArena::Stats ThreadFrameArenas::getStats() const
+    {
+        FrameArena::Stats result;
+
+        Threading::ReadWriteGuard<Threading::SpinLock> guard(lock);
+        for (const auto& entry : arenas)
+        {
+            const auto& stats = entry.arena->getStats();
+            result.usedBytes += stats.usedBytes;
+            // Sum of per thread peaks, an upper bound of the combined one.
+            result.peakBytes += stats.peakBytes;
+            result.wasteBytes += stats.wasteBytes;
+            result.pagesCount += stats.pagesCount;
+            result.oversizedCount += stats.oversizedCount;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "common/Config.hpp"
+#include "common/NonCopyableMovable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
+#include "math/Base.hpp"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+namespace RR::Common
+{
+    // Fixed size pages shared between arenas.
+    // Free pages form a lock-free stack, pages are kept until the pool is destroyed so reused memory stays hot.
+    class ArenaPagePool final : public Common::NonCopyable
+    {
+    public:
+        static constexpr size_t DefaultPageSize = 64 * 1024;
+
+        explicit ArenaPagePool(size_t pageSize = DefaultPageSize);
+        ~ArenaPagePool();
+
+        std::byte* Acquire();
+        void Release(std::byte* page);
+
+        [[nodiscard]] size_t GetPageSize() const { return pageSize; }
+        [[nodiscard]] size_t GetPagesCount() const { return pagesCount.load(std::memory_order_relaxed); }
+        [[nodiscard]] size_t GetFreePagesCount() const { return freePagesCount.load(std::memory_order_relaxed); }
+
+        static ArenaPagePool& Global();
+
+    private:
+        struct FreePage
+        {
+            // Atomic because a losing Acquire may still read it after another thread took the page.
+            std::atomic<FreePage*> next;
+        };
+
+        // Pointer in low 48 bits, ABA tag in high 16 bits.
+        static constexpr uint64_t PointerMask = (uint64_t(1) << 48) - 1;
+        static uint64_t pack(FreePage* page, uint64_t tag) { return uint64_t(reinterpret_cast<uintptr_t>(page)) | (tag << 48); }
+        static FreePage* unpackPage(uint64_t head) { return reinterpret_cast<FreePage*>(uintptr_t(head & PointerMask)); }
+        static uint64_t unpackTag(uint64_t head) { return head >> 48; }
+
+    private:
+        const size_t pageSize;
+        std::atomic<uint64_t> freeHead = 0;
+        std::atomic<size_t> pagesCount = 0;
+        std::atomic<size_t> freePagesCount = 0;
+    };
+
+    // Linear allocator for per frame data, single threaded.
+    // Memory comes in pages from ArenaPagePool, reset() rewinds to the first page and keeps all of them,
+    // so steady state frames never touch the system allocator. Allocations larger than a page get dedicated blocks.
+    class FrameArena final : public Common::NonCopyable
+    {
+    public:
+        struct Marker
+        {
+            size_t pageIndex;
+            uintptr_t cursor;
+            size_t usedBytes;
+            size_t wasteBytes;
+            size_t oversizedCount;
+        };
+
+        struct Stats
+        {
+            // Bytes handed out since last reset, alignment padding included.
+            size_t usedBytes = 0;
+            // High-water mark of usedBytes over arena lifetime.
+            size_t peakBytes = 0;
+            // Padding and unused page tails skipped since last reset.
+            size_t wasteBytes = 0;
+            size_t pagesCount = 0;
+            size_t oversizedCount = 0;
+        };
+
+        // Rolls arena back to the point of construction on scope exit.
+        class ScopedMarker final : public Common::NonCopyable
+        {
+        public:
+            explicit ScopedMarker(FrameArena& arena) : arena(arena), marker(arena.getMarker()) { }
+            ~ScopedMarker() { arena.rollback(marker); }
+
+        private:
+            FrameArena& arena;
+            Marker marker;
+        };
+
+    public:
+        explicit FrameArena(ArenaPagePool& pool = ArenaPagePool::Global()) : pool(pool) { }
+        ~FrameArena();
+
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+        {
+            if (size == 0)
+                return nullptr;
+
+            const uintptr_t aligned = AlignTo(cursor, alignment);
+            if LIKELY (aligned + size <= limit)
+            {
+                stats.wasteBytes += aligned - cursor;
+                stats.usedBytes += aligned - cursor + size;
+                stats.peakBytes = eastl::max(stats.peakBytes, stats.usedBytes);
+                cursor = aligned + size;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            return allocateSlow(size, alignment);
+        }
+
+        char* allocateString(std::string_view str)
+        {
+            char* ptr = static_cast<char*>(allocate(str.size() + 1, 1));
+            std::memcpy(ptr, str.data(), str.size());
+            ptr[str.size()] = '\0';
+            return ptr;
+        }
+
+        template <typename T>
+        T* allocateArray(size_t count)
+        {
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        template <typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            void* memory = allocate(sizeof(T), alignof(T));
+            return new (memory) T(std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] Marker getMarker() const { return {pageIndex, cursor, stats.usedBytes, stats.wasteBytes, oversized.size()}; }
+        // Frees everything allocated after the marker. Pages stay with the arena.
+        void rollback(const Marker& marker);
+
+        // Frees everything, keeps pages for the next frame.
+        void reset() { rollback({0, 0, 0, 0, 0}); }
+        // Returns pages above keepPagesCount to the pool. Arena must be reset.
+        void trim(size_t keepPagesCount = 0);
+
+        [[nodiscard]] const Stats& getStats() const { return stats; }
+
+        // Arena private to the calling thread, backed by the global pool.
+        static FrameArena& ForCurrentThread();
+
+    private:
+        void* allocateSlow(std::size_t size, std::size_t alignment);
+        void setPage(size_t index);
+
+    private:
+        ArenaPagePool& pool;
+        eastl::vector<std::byte*> pages;
+        eastl::vector<std::unique_ptr<std::byte[]>> oversized;
+        size_t pageIndex = 0;
+        uintptr_t cursor = 0;
+        uintptr_t limit = 0;
+        Stats stats;
+    };
+
+    // Thread-safe front end: every thread that allocates gets its own FrameArena, all of them share one page pool.
+    // reset() and getStats() must not run concurrently with allocations.
+    // Each thread caches lookups of the last LocalCacheSize instances it used, threads that alternate
+    // between more instances than that fall back to a locked search.
+    class ThreadFrameArenas final : public Common::NonCopyable
+    {
+    public:
+        static constexpr size_t LocalCacheSize = 4;
+
+        explicit ThreadFrameArenas(ArenaPagePool& pool = ArenaPagePool::Global());
+
+        FrameArena& local();
+
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) { return local().allocate(size, alignment); }
+
+        template <typename T, typename... Args>
+        T* create(Args&&... args) { return local().create<T>(std::forward<Args>(args)...); }
+
+        void reset();
+        [[nodiscard]] FrameArena::Stats getStats() const;
+
+    private:
+        struct ThreadArena
+        {
+            std::thread::id threadId;
+            std::unique_ptr<FrameArena> arena;
+        };
+
+        FrameArena& registerThread();
+
+    private:
+        ArenaPagePool& pool;
+        // Distinguishes instances in the thread local lookup cache, addresses can be reused.
+        const uint64_t instanceId;
+        mutable Threading::SpinLock lock;
+        eastl::vector<ThreadArena> arenas;
+    };
+}
@@ -0,0 +1,8 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch_session.hpp>
+
+int main(int argc, char** argv)
+{
+    auto session = Catch::Session();
+    return session.run(argc, argv);
+}
@@ -0,0 +1,105 @@
+#include "common/ChunkAllocator.hpp"
+#include "common/FrameArena.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+
+using namespace RR::Common;
+
+namespace
+{
+    struct Allocation
+    {
+        uint32_t size;
+        uint32_t alignment;
+    };
+
+    // Mix of small command structs and occasional arrays, like a recorded command list.
+    eastl::vector<Allocation> makeCommandPattern(uint32_t commandsCount)
+    {
+        ankerl::nanobench::Rng rng(42);
+        eastl::vector<Allocation> pattern;
+        pattern.reserve(commandsCount);
+
+        for (uint32_t index = 0; index < commandsCount; index++)
+        {
+            if (rng.bounded(8) == 0)
+                pattern.push_back({uint32_t(4 * (4 + rng.bounded(60))), 4});
+            else
+                pattern.push_back({uint32_t(16 + 8 * rng.bounded(11)), 8});
+        }
+
+        return pattern;
+    }
+}
+
+TEST_CASE("Command recording allocations", "[FrameArena]")
+{
+    constexpr uint32_t commandsCount = 4096;
+    const auto pattern = makeCommandPattern(commandsCount);
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Command recording allocations")
+        .warmup(10)
+        .relative(true)
+        .batch(commandsCount)
+        .unit("allocation")
+        .minEpochIterations(20);
+
+    bench.run("malloc", [&](ankerl::nanobench::Meter meter) {
+        eastl::vector<void*> pointers(commandsCount);
+
+        return meter.measure([&]() {
+            for (uint32_t index = 0; index < commandsCount; index++)
+                pointers[index] = std::malloc(pattern[index].size);
+
+            ankerl::nanobench::doNotOptimizeAway(pointers.data());
+
+            for (auto pointer : pointers)
+                std::free(pointer);
+        });
+    });
+
+    bench.run("ChunkAllocator", [&](ankerl::nanobench::Meter meter) {
+        ChunkAllocator allocator(4096);
+
+        return meter.measure([&]() {
+            for (const auto& allocation : pattern)
+                ankerl::nanobench::doNotOptimizeAway(allocator.allocate(allocation.size, allocation.alignment));
+
+            allocator.reset();
+        });
+    });
+
+    bench.run("FrameArena", [&](ankerl::nanobench::Meter meter) {
+        FrameArena arena;
+
+        return meter.measure([&]() {
+            for (const auto& allocation : pattern)
+                ankerl::nanobench::doNotOptimizeAway(arena.allocate(allocation.size, allocation.alignment));
+
+            arena.reset();
+        });
+    });
+
+    bench.run("FrameArena scoped marker", [&](ankerl::nanobench::Meter meter) {
+        FrameArena arena;
+
+        return meter.measure([&]() {
+            FrameArena::ScopedMarker marker(arena);
+            for (const auto& allocation : pattern)
+                ankerl::nanobench::doNotOptimizeAway(arena.allocate(allocation.size, allocation.alignment));
+        });
+    });
+
+    bench.run("ThreadFrameArenas", [&](ankerl::nanobench::Meter meter) {
+        ThreadFrameArenas arenas;
+
+        return meter.measure([&]() {
+            for (const auto& allocation : pattern)
+                ankerl::nanobench::doNotOptimizeAway(arenas.allocate(allocation.size, allocation.alignment));
+
+            arenas.reset();
+        });
+    });
+}
@@ -0,0 +1,105 @@
+#include "common/threading/JobSystem.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+
+using namespace RR::Common::Threading;
+
+TEST_CASE("Job spawn", "[JobSystem]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Job spawn")
+        .warmup(100)
+        .relative(true)
+        .minEpochIterations(1000);
+
+    JobSystem jobSystem;
+
+    bench.run("Run and wait single job", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&jobSystem]() {
+            JobCounter counter;
+            jobSystem.Run([] { }, counter);
+            jobSystem.Wait(counter);
+        });
+    });
+
+    for (uint32_t jobsCount : {16u, 256u})
+    {
+        bench.batch(jobsCount);
+        bench.run("Run and wait " + std::to_string(jobsCount) + " jobs", [&](ankerl::nanobench::Meter meter) {
+            return meter.measure([&jobSystem, jobsCount]() {
+                JobCounter counter;
+                for (uint32_t index = 0; index < jobsCount; index++)
+                    jobSystem.Run([] { }, counter);
+                jobSystem.Wait(counter);
+            });
+        });
+    }
+}
+
+TEST_CASE("Job steal", "[JobSystem]")
+{
+    JobSystem jobSystem;
+    if (jobSystem.GetWorkersCount() == 0)
+        return;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Job steal")
+        .warmup(100)
+        .minEpochIterations(100);
+
+    for (uint32_t jobsCount : {1u, 64u})
+    {
+        bench.batch(jobsCount);
+        bench.run("Steal " + std::to_string(jobsCount) + " jobs", [&](ankerl::nanobench::Meter meter) {
+            return meter.measure([&jobSystem, jobsCount]() {
+                JobCounter counter;
+                // Parent spins instead of executing its children. When a worker took the parent, children
+                // sit in that worker deque and every one of them is stolen by other workers or the waiting thread.
+                jobSystem.Run([&jobSystem, jobsCount] {
+                    JobCounter children;
+                    for (uint32_t index = 0; index < jobsCount; index++)
+                        jobSystem.Run([] { }, children);
+
+                    while (!children.IsDone())
+                        std::this_thread::yield();
+                    jobSystem.Wait(children);
+                }, counter);
+                jobSystem.Wait(counter);
+            });
+        });
+    }
+}
+
+TEST_CASE("ParallelFor scaling", "[JobSystem]")
+{
+    constexpr uint32_t elementsCount = 1 << 20;
+    eastl::vector<float> values(elementsCount, 1.0f);
+
+    ankerl::nanobench::Bench bench;
+    bench.title("ParallelFor scaling")
+        .warmup(3)
+        .relative(true)
+        .batch(elementsCount)
+        .unit("element")
+        .minEpochIterations(10);
+
+    const uint32_t coresCount = eastl::max(Thread::HardwareConcurrency(), 1u);
+    for (uint32_t cores = 1;; cores = eastl::min(cores * 2, coresCount))
+    {
+        JobSystem jobSystem(cores - 1);
+
+        bench.run("Cores " + std::to_string(cores), [&](ankerl::nanobench::Meter meter) {
+            return meter.measure([&]() {
+                jobSystem.ParallelFor(0, elementsCount, 0, [&values](uint32_t begin, uint32_t end) {
+                    for (uint32_t index = begin; index < end; index++)
+                        values[index] = values[index] * 0.5f + 1.0f;
+                });
+                ankerl::nanobench::doNotOptimizeAway(values.data());
+            });
+        });
+
+        if (cores == coresCount)
+            break;
+    }
+}
@@ -0,0 +1,140 @@
+#include "common/threading/BlockingRingQueue.hpp"
+#include "common/threading/MpscRingQueue.hpp"
+#include "common/threading/SpscRingQueue.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <nanobench.h>
+
+using namespace RR::Common::Threading;
+
+namespace
+{
+    // Same capacity as the render submission queue.
+    constexpr std::size_t QueueCapacity = 64;
+    constexpr uint64_t StopValue = ~0ull;
+
+    // Another thread echoes every item back, measures one full round trip through both queues.
+    template <typename Queue>
+    void runLatency(ankerl::nanobench::Bench& bench, const char* name)
+    {
+        bench.run(name, [&](ankerl::nanobench::Meter meter) {
+            auto requests = eastl::make_unique<Queue>();
+            auto responses = eastl::make_unique<Queue>();
+
+            Thread echo("Echo", [&] {
+                for (;;)
+                {
+                    const uint64_t value = requests->Pop();
+                    responses->Push(value);
+                    if (value == StopValue)
+                        return;
+                }
+            });
+
+            const auto elapsed = meter.measure([&]() {
+                requests->Push(1);
+                ankerl::nanobench::doNotOptimizeAway(responses->Pop());
+            });
+
+            requests->Push(StopValue);
+            responses->Pop();
+            echo.Join();
+            return elapsed;
+        });
+    }
+
+    // Producer thread streams items, consumer is the benchmark thread.
+    template <typename Queue>
+    void runThroughput(ankerl::nanobench::Bench& bench, const char* name, uint32_t itemsCount)
+    {
+        bench.run(name, [&](ankerl::nanobench::Meter meter) {
+            auto queue = eastl::make_unique<Queue>();
+
+            return meter.measure([&]() {
+                Thread producer("Producer", [&] {
+                    for (uint32_t index = 0; index < itemsCount; index++)
+                        queue->Push(uint64_t(index));
+                });
+
+                uint64_t summ = 0;
+                for (uint32_t index = 0; index < itemsCount; index++)
+                    summ += queue->Pop();
+
+                producer.Join();
+                ankerl::nanobench::doNotOptimizeAway(summ);
+            });
+        });
+    }
+
+    template <typename Queue>
+    void runBatchThroughput(ankerl::nanobench::Bench& bench, const char* name, uint32_t itemsCount)
+    {
+        constexpr uint32_t batchSize = 16;
+
+        bench.run(name, [&](ankerl::nanobench::Meter meter) {
+            auto queue = eastl::make_unique<Queue>();
+
+            return meter.measure([&]() {
+                Thread producer("Producer", [&] {
+                    uint64_t items[batchSize];
+                    for (uint32_t index = 0; index < itemsCount; index += batchSize)
+                    {
+                        for (uint32_t item = 0; item < batchSize; item++)
+                            items[item] = index + item;
+
+                        while (!queue->TryPushBatch(items, batchSize))
+                            std::this_thread::yield();
+                    }
+                });
+
+                uint64_t summ = 0;
+                uint64_t items[batchSize];
+                for (uint32_t popped = 0; popped < itemsCount;)
+                {
+                    const std::size_t count = queue->TryPopBatch(items, batchSize);
+                    for (std::size_t item = 0; item < count; item++)
+                        summ += items[item];
+
+                    popped += uint32_t(count);
+                }
+
+                producer.Join();
+                ankerl::nanobench::doNotOptimizeAway(summ);
+            });
+        });
+    }
+}
+
+TEST_CASE("Ring queue latency", "[RingQueue]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Ring queue round trip")
+        .warmup(100)
+        .relative(true)
+        .minEpochIterations(1000);
+
+    runLatency<BlockingRingQueue<uint64_t, QueueCapacity>>(bench, "BlockingRingQueue");
+    runLatency<SpscRingQueue<uint64_t, QueueCapacity>>(bench, "SpscRingQueue");
+    runLatency<MpscRingQueue<uint64_t, QueueCapacity>>(bench, "MpscRingQueue");
+}
+
+TEST_CASE("Ring queue throughput", "[RingQueue]")
+{
+    constexpr uint32_t itemsCount = 1 << 18;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Ring queue throughput")
+        .warmup(1)
+        .relative(true)
+        .batch(itemsCount)
+        .unit("item")
+        .epochs(10)
+        .epochIterations(1);
+
+    runThroughput<BlockingRingQueue<uint64_t, QueueCapacity>>(bench, "BlockingRingQueue", itemsCount);
+    runThroughput<SpscRingQueue<uint64_t, QueueCapacity>>(bench, "SpscRingQueue", itemsCount);
+    runThroughput<MpscRingQueue<uint64_t, QueueCapacity>>(bench, "MpscRingQueue", itemsCount);
+    runBatchThroughput<SpscRingQueue<uint64_t, QueueCapacity>>(bench, "SpscRingQueue batch", itemsCount);
+    runBatchThroughput<MpscRingQueue<uint64_t, QueueCapacity>>(bench, "MpscRingQueue batch", itemsCount);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+
+#if OS_WINDOWS
+#include "platform/windows/MappedFile.hpp"
+#else
+#include "platform/posix/MappedFile.hpp"
+#endif
+
+namespace RR::Common
+{
+    enum class RResult : int32_t;
+
+    namespace IO
+    {
+        enum class MappedFileMode : uint32_t
+        {
+            ReadOnly,   // Views are read only and share physical pages with every process mapping the file.
+            CopyOnWrite // Views are writable, written pages become private copies and never reach the file.
+        };
+
+        enum class MappedAccessHint : uint32_t
+        {
+            Normal,     // No special treatment.
+            Sequential, // Range will be read front to back, read ahead aggressively.
+            Random,     // Range will be accessed randomly, don't read ahead.
+            WillNeed,   // Range will be accessed soon, start loading it now.
+            DontNeed    // Range won't be accessed soon, its pages can be dropped.
+        };
+
+        // Mapped window of a file. Mapping itself starts at a page boundary, data points at the requested offset.
+        // View stays valid after the MappedFile it came from is closed.
+        class MappedView final : public Common::NonCopyable
+        {
+        public:
+            MappedView() = default;
+            MappedView(MappedView&& other) noexcept { *this = eastl::move(other); }
+            ~MappedView() { Unmap(); }
+
+            MappedView& operator=(MappedView&& other) noexcept
+            {
+                if (this == &other)
+                    return *this;
+
+                Unmap();
+                eastl::swap(base_, other.base_);
+                eastl::swap(mappedSize_, other.mappedSize_);
+                eastl::swap(data_, other.data_);
+                eastl::swap(size_, other.size_);
+                eastl::swap(fileOffset_, other.fileOffset_);
+                eastl::swap(writable_, other.writable_);
+                return *this;
+            }
+
+            void Unmap();
+            bool IsMapped() const { return base_ != nullptr; }
+
+            const std::byte* GetData() const { return data_; }
+            // Only copy-on-write views can be written.
+            std::byte* GetMutableData() const
+            {
+                ASSERT_MSG(writable_, "View is read only");
+                return writable_ ? data_ : nullptr;
+            }
+
+            size_t GetSize() const { return size_; }
+            uint64_t GetFileOffset() const { return fileOffset_; }
+            eastl::span<const std::byte> GetSpan() const { return {data_, size_}; }
+            // Range of the view without a mapping of its own, valid while this view stays mapped.
+            eastl::span<const std::byte> SubView(size_t offset, size_t size) const
+            {
+                ASSERT(offset <= size_ && size <= size_ - offset);
+                return {data_ + offset, size};
+            }
+
+            // Hints are best effort, range is widened to page boundaries.
+            void Advise(MappedAccessHint hint) const { Advise(hint, 0, size_); }
+            void Advise(MappedAccessHint hint, size_t offset, size_t size) const;
+
+        private:
+            friend class MappedFile;
+
+            void* base_ = nullptr;
+            size_t mappedSize_ = 0;
+            std::byte* data_ = nullptr;
+            size_t size_ = 0;
+            uint64_t fileOffset_ = 0;
+            bool writable_ = false;
+        };
+
+        class MappedFile final : public Common::NonCopyable, protected MappedFileData
+        {
+        public:
+            ~MappedFile();
+
+            RResult Open(std::string_view path, MappedFileMode mode = MappedFileMode::ReadOnly);
+            void Close();
+            bool IsOpen() const { return handle_ != InvalidHandle; }
+
+            uint64_t GetFileSize() const { return fileSize_; }
+            MappedFileMode GetMode() const { return mode_; }
+
+            // Maps [offset, offset + size) of the file, zero size maps up to the end of file.
+            RResult Map(uint64_t offset, size_t size, MappedView& view) const;
+            RResult Map(MappedView& view) const { return Map(0, 0, view); }
+
+            // Granularity mapping offsets are rounded down to.
+            static size_t GetMappingGranularity();
+
+        private:
+            uint64_t fileSize_ = 0;
+            MappedFileMode mode_ = MappedFileMode::ReadOnly;
+        };
+    }
+}
@@ -0,0 +1,162 @@
+#include "common/io/MappedFile.hpp"
+
+#include "common/Result.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "EASTL/fixed_string.h"
+
+namespace RR::Common::IO
+{
+    namespace
+    {
+        RResult errnoToResult(int error)
+        {
+            switch (error)
+            {
+                case EACCES:
+                case EPERM: return RResult::AccessDenied;
+                case ENOENT: return RResult::FileNotFound;
+                case ENOMEM:
+                case EMFILE:
+                case ENFILE: return RResult::OutOfMemory;
+                case EINVAL: return RResult::InvalidArgument;
+                default: return RResult::CannotOpen;
+            }
+        }
+    }
+
+    void MappedView::Unmap()
+    {
+        if (!base_)
+            return;
+
+        munmap(base_, mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+        fileOffset_ = 0;
+        writable_ = false;
+    }
+
+    void MappedView::Advise(MappedAccessHint hint, size_t offset, size_t size) const
+    {
+        if (!base_ || size == 0)
+            return;
+
+        ASSERT(offset + size <= size_);
+
+        int advice = MADV_NORMAL;
+        switch (hint)
+        {
+            case MappedAccessHint::Normal: advice = MADV_NORMAL; break;
+            case MappedAccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+            case MappedAccessHint::Random: advice = MADV_RANDOM; break;
+            case MappedAccessHint::WillNeed: advice = MADV_WILLNEED; break;
+            case MappedAccessHint::DontNeed:
+                // Dropping pages of a private mapping throws away the written copies.
+                if (writable_)
+                    return;
+                advice = MADV_DONTNEED;
+                break;
+            default: ASSERT_MSG(false, "Unknown access hint"); return;
+        }
+
+        // Mapping base is page aligned, so rounding down never leaves the mapping.
+        const uintptr_t pageMask = MappedFile::GetMappingGranularity() - 1;
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(data_ + offset) & ~pageMask;
+        const uintptr_t end = reinterpret_cast<uintptr_t>(data_ + offset + size);
+        madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+    }
+
+    MappedFile::~MappedFile() { Close(); }
+
+    RResult MappedFile::Open(std::string_view path, MappedFileMode mode)
+    {
+        Close();
+
+        if (path.empty())
+            return RResult::NotFound;
+
+        eastl::fixed_string<char, 512> pathStr(path.begin(), path.end());
+
+        // Copy-on-write mapping never writes back, so the file is opened read only in both modes.
+        const int handle = open(pathStr.c_str(), O_RDONLY);
+        if (handle < 0)
+            return errnoToResult(errno);
+
+        struct stat fileStat;
+        if (fstat(handle, &fileStat) != 0)
+        {
+            const int error = errno;
+            close(handle);
+            return errnoToResult(error);
+        }
+
+        handle_ = handle;
+        fileSize_ = uint64_t(fileStat.st_size);
+        mode_ = mode;
+        return RResult::Ok;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!IsOpen())
+            return;
+
+        close(handle_);
+        handle_ = InvalidHandle;
+        fileSize_ = 0;
+    }
+
+    RResult MappedFile::Map(uint64_t offset, size_t size, MappedView& view) const
+    {
+        view.Unmap();
+
+        if (!IsOpen())
+        {
+            ASSERT_MSG(false, "File is not opened");
+            return RResult::InvalidHandle;
+        }
+
+        if (offset > fileSize_)
+            return RResult::InvalidArgument;
+
+        if (size == 0)
+            size = size_t(fileSize_ - offset);
+
+        if (size > fileSize_ - offset)
+            return RResult::InvalidArgument;
+
+        // Nothing to map, mmap refuses zero length.
+        if (size == 0)
+            return RResult::Ok;
+
+        const uint64_t mappingOffset = offset & ~uint64_t(GetMappingGranularity() - 1);
+        const size_t delta = size_t(offset - mappingOffset);
+        const bool writable = mode_ == MappedFileMode::CopyOnWrite;
+
+        void* base = mmap(nullptr, size + delta, PROT_READ | (writable ? PROT_WRITE : 0), writable ? MAP_PRIVATE : MAP_SHARED, handle_, off_t(mappingOffset));
+        if (base == MAP_FAILED)
+            return errnoToResult(errno);
+
+        view.base_ = base;
+        view.mappedSize_ = size + delta;
+        view.data_ = static_cast<std::byte*>(base) + delta;
+        view.size_ = size;
+        view.fileOffset_ = offset;
+        view.writable_ = writable;
+        return RResult::Ok;
+    }
+
+    size_t MappedFile::GetMappingGranularity()
+    {
+        static const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace RR::Common::IO
+{
+    class MappedFileData
+    {
+    protected:
+        static inline int InvalidHandle = -1;
+        int handle_ = InvalidHandle;
+    };
+}
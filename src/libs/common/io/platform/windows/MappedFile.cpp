@@ -0,0 +1,180 @@
+#include "common/io/MappedFile.hpp"
+#include "common/StringEncoding.hpp"
+#include "common/Result.hpp"
+
+#include <windows.h>
+
+#include "EASTL\fixed_string.h"
+
+namespace RR::Common::IO
+{
+    namespace
+    {
+        RResult lastErrorToResult()
+        {
+            switch (GetLastError())
+            {
+                case ERROR_SHARING_VIOLATION:
+                case ERROR_ACCESS_DENIED:
+                case ERROR_LOCK_VIOLATION:
+                    return RResult::AccessDenied;
+                case ERROR_FILE_NOT_FOUND:
+                case ERROR_PATH_NOT_FOUND:
+                    return RResult::FileNotFound;
+                case ERROR_TOO_MANY_OPEN_FILES:
+                case ERROR_OUTOFMEMORY:
+                case ERROR_NOT_ENOUGH_MEMORY:
+                case ERROR_COMMITMENT_LIMIT:
+                    return RResult::OutOfMemory;
+                case ERROR_INVALID_PARAMETER:
+                    return RResult::InvalidArgument;
+                default: return RResult::CannotOpen;
+            }
+        }
+    }
+
+    void MappedView::Unmap()
+    {
+        if (!base_)
+            return;
+
+        UnmapViewOfFile(base_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+        fileOffset_ = 0;
+        writable_ = false;
+    }
+
+    void MappedView::Advise(MappedAccessHint hint, size_t offset, size_t size) const
+    {
+        if (!base_ || size == 0)
+            return;
+
+        ASSERT(offset + size <= size_);
+
+        // Windows has no read ahead policy for existing views, only explicit prefetch.
+        if (hint != MappedAccessHint::WillNeed)
+            return;
+
+        const uintptr_t pageMask = MappedFile::GetMappingGranularity() - 1;
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(data_ + offset) & ~pageMask;
+        const uintptr_t end = reinterpret_cast<uintptr_t>(data_ + offset + size);
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = reinterpret_cast<PVOID>(begin);
+        range.NumberOfBytes = end - begin;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    MappedFile::~MappedFile() { Close(); }
+
+    RResult MappedFile::Open(std::string_view path, MappedFileMode mode)
+    {
+        Close();
+
+        if (path.empty())
+            return RResult::NotFound;
+
+        eastl::fixed_string<WCHAR, 512> wpath;
+        Common::StringEncoding::UTF8ToWide(path.begin(), path.end(), eastl::back_inserter(wpath));
+
+        // Copy-on-write mapping never writes back, so the file is opened read only in both modes.
+        HANDLE handle = ::CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            return lastErrorToResult();
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(handle, &fileSize))
+        {
+            const RResult result = lastErrorToResult();
+            CloseHandle(handle);
+            return result;
+        }
+
+        // Empty file can't be mapped, it is opened anyway and every view of it is empty.
+        HANDLE mapping = nullptr;
+        if (fileSize.QuadPart > 0)
+        {
+            mapping = CreateFileMappingW(handle, nullptr, mode == MappedFileMode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping)
+            {
+                const RResult result = lastErrorToResult();
+                CloseHandle(handle);
+                return result;
+            }
+        }
+
+        handle_ = handle;
+        mapping_ = mapping;
+        fileSize_ = uint64_t(fileSize.QuadPart);
+        mode_ = mode;
+        return RResult::Ok;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!IsOpen())
+            return;
+
+        if (mapping_)
+            CloseHandle(mapping_);
+
+        CloseHandle(handle_);
+        handle_ = InvalidHandle;
+        mapping_ = nullptr;
+        fileSize_ = 0;
+    }
+
+    RResult MappedFile::Map(uint64_t offset, size_t size, MappedView& view) const
+    {
+        view.Unmap();
+
+        if (!IsOpen())
+        {
+            ASSERT_MSG(false, "File is not opened");
+            return RResult::InvalidHandle;
+        }
+
+        if (offset > fileSize_)
+            return RResult::InvalidArgument;
+
+        if (size == 0)
+            size = size_t(fileSize_ - offset);
+
+        if (size > fileSize_ - offset)
+            return RResult::InvalidArgument;
+
+        if (size == 0)
+            return RResult::Ok;
+
+        const uint64_t mappingOffset = offset & ~uint64_t(GetMappingGranularity() - 1);
+        const size_t delta = size_t(offset - mappingOffset);
+        const bool writable = mode_ == MappedFileMode::CopyOnWrite;
+
+        void* base = MapViewOfFile(mapping_, writable ? FILE_MAP_COPY : FILE_MAP_READ, DWORD(mappingOffset >> 32), DWORD(mappingOffset & 0xFFFFFFFF), size + delta);
+        if (!base)
+            return lastErrorToResult();
+
+        view.base_ = base;
+        view.mappedSize_ = size + delta;
+        view.data_ = static_cast<std::byte*>(base) + delta;
+        view.size_ = size;
+        view.fileOffset_ = offset;
+        view.writable_ = writable;
+        return RResult::Ok;
+    }
+
+    size_t MappedFile::GetMappingGranularity()
+    {
+        // View offsets have to be multiples of allocation granularity, not page size.
+        static const size_t granularity = [] {
+            SYSTEM_INFO systemInfo;
+            GetSystemInfo(&systemInfo);
+            return size_t(systemInfo.dwAllocationGranularity);
+        }();
+
+        return granularity;
+    }
+}
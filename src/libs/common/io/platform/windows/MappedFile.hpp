@@ -0,0 +1,14 @@
+#pragma once
+
+#include <wtypes.h>
+
+namespace RR::Common::IO
+{
+    class MappedFileData
+    {
+    protected:
+        static inline HANDLE InvalidHandle = INVALID_HANDLE_VALUE;
+        HANDLE handle_ = InvalidHandle;
+        HANDLE mapping_ = nullptr;
+    };
+}
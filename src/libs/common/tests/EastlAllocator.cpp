@@ -0,0 +1,199 @@
+#include "common/EastlAllocator.hpp"
+
+#include <EASTL/vector.h>
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <new>
+
+using namespace RR::Common;
+
+namespace
+{
+    struct alignas(64) CacheLine
+    {
+        uint32_t values[16];
+    };
+
+    bool isAligned(const void* pointer, size_t alignment) { return reinterpret_cast<uintptr_t>(pointer) % alignment == 0; }
+
+    // Allocates the same way EASTL containers named with tag do.
+    char* allocateTagged(size_t size, const char* tag)
+    {
+        return static_cast<char*>(EastlAllocator(tag).allocate(size));
+    }
+
+    void deallocate(char* memory)
+    {
+        // Size is not needed, block header keeps it.
+        EastlAllocator().deallocate(memory, 0);
+    }
+
+    EastlAllocationTracker::TagStats getTagStats(const char* tag)
+    {
+        eastl::array<EastlAllocationTracker::TagStats, EastlAllocationTracker::MaxTagsCount> stats;
+        const size_t count = EastlAllocationTracker::GetStats(stats.data(), stats.size());
+        for (size_t index = 0; index < count; index++)
+            if (std::strcmp(stats[index].tag, tag) == 0)
+                return stats[index];
+
+        return {tag, 0, 0, 0, 0};
+    }
+
+    // Tracking is process wide, restore it for other tests.
+    struct TrackingScope
+    {
+        TrackingScope() : wasEnabled(EastlAllocationTracker::IsEnabled()) { }
+        ~TrackingScope() { EastlAllocationTracker::SetEnabled(wasEnabled); }
+
+        bool wasEnabled;
+    };
+}
+
+TEST_CASE("Aligned allocations", "[EastlAllocator]")
+{
+    SECTION("Over-aligned vector")
+    {
+        eastl::vector<CacheLine> vector;
+        for (uint32_t index = 0; index < 100; index++)
+        {
+            vector.push_back({});
+            REQUIRE(isAligned(vector.data(), alignof(CacheLine)));
+        }
+    }
+
+    SECTION("Alignment offset")
+    {
+        for (const size_t alignment : {8u, 16u, 32u, 64u, 256u, 4096u})
+            for (const size_t offset : {0u, 1u, 4u, 8u, 24u, 100u})
+            {
+                auto* memory = static_cast<char*>(EastlAllocator("AlignmentOffset").allocate(offset + 64, alignment, offset));
+                REQUIRE(isAligned(memory + offset, alignment));
+
+                // Whole block is writable, header before it stays intact.
+                std::memset(memory, 0xCD, offset + 64);
+                deallocate(memory);
+            }
+    }
+
+    SECTION("Default alignment")
+    {
+        for (const size_t size : {1u, 7u, 64u, 1000u})
+        {
+            auto* memory = allocateTagged(size, "DefaultAlignment");
+            REQUIRE(isAligned(memory, __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+            deallocate(memory);
+        }
+
+        deallocate(nullptr);
+    }
+}
+
+TEST_CASE("Allocation tracker", "[EastlAllocator]")
+{
+    TrackingScope scope;
+
+    SECTION("Counts")
+    {
+        constexpr const char* Tag = "TrackerCounts";
+        EastlAllocationTracker::SetEnabled(true);
+
+        auto* first = allocateTagged(100, Tag);
+        auto* second = allocateTagged(50, Tag);
+        REQUIRE(getTagStats(Tag).bytes == 150);
+        REQUIRE(getTagStats(Tag).count == 2);
+
+        deallocate(first);
+        REQUIRE(getTagStats(Tag).bytes == 50);
+        REQUIRE(getTagStats(Tag).count == 1);
+        REQUIRE(getTagStats(Tag).peakBytes == 150);
+        REQUIRE(getTagStats(Tag).totalCount == 2);
+
+        deallocate(second);
+        REQUIRE(getTagStats(Tag).bytes == 0);
+        REQUIRE(getTagStats(Tag).count == 0);
+    }
+
+    SECTION("Tags matched by content")
+    {
+        static const char first[] = "TrackerSameName";
+        static const char second[] = "TrackerSameName";
+        REQUIRE(static_cast<const void*>(first) != static_cast<const void*>(second));
+
+        EastlAllocationTracker::SetEnabled(true);
+        auto* firstMemory = allocateTagged(10, first);
+        auto* secondMemory = allocateTagged(20, second);
+        REQUIRE(getTagStats(first).bytes == 30);
+        REQUIRE(getTagStats(first).count == 2);
+
+        deallocate(firstMemory);
+        deallocate(secondMemory);
+        REQUIRE(getTagStats(first).bytes == 0);
+    }
+
+    SECTION("Toggled mid-lifetime")
+    {
+        constexpr const char* Tag = "TrackerToggled";
+
+        // Allocated while disabled, never counted.
+        EastlAllocationTracker::SetEnabled(false);
+        auto* untracked = allocateTagged(64, Tag);
+
+        EastlAllocationTracker::SetEnabled(true);
+        auto* tracked = allocateTagged(128, Tag);
+        REQUIRE(getTagStats(Tag).bytes == 128);
+        REQUIRE(getTagStats(Tag).count == 1);
+
+        // Freeing an untracked block doesn't touch the counters even with tracking enabled.
+        deallocate(untracked);
+        REQUIRE(getTagStats(Tag).bytes == 128);
+        REQUIRE(getTagStats(Tag).count == 1);
+
+        // Tracked block is still accounted when freed after tracking is disabled.
+        EastlAllocationTracker::SetEnabled(false);
+        deallocate(tracked);
+        REQUIRE(getTagStats(Tag).bytes == 0);
+        REQUIRE(getTagStats(Tag).count == 0);
+        REQUIRE(getTagStats(Tag).totalCount == 1);
+        REQUIRE(getTagStats(Tag).peakBytes == 128);
+    }
+
+    SECTION("Unnamed")
+    {
+        EastlAllocationTracker::SetEnabled(true);
+        const auto before = getTagStats("unnamed");
+
+        auto* memory = allocateTagged(32, nullptr);
+        REQUIRE(getTagStats("unnamed").bytes == before.bytes + 32);
+        deallocate(memory);
+        REQUIRE(getTagStats("unnamed").bytes == before.bytes);
+    }
+
+    SECTION("Containers")
+    {
+        static_assert(eastl::is_same_v<eastl::vector<int>::allocator_type, EastlAllocator>);
+
+        constexpr const char* Tag = "TrackerVector";
+        EastlAllocationTracker::SetEnabled(true);
+        {
+            eastl::vector<int> vector {EastlAllocator(Tag)};
+            vector.resize(100);
+            REQUIRE(getTagStats(Tag).bytes >= 100 * sizeof(int));
+            REQUIRE(getTagStats(Tag).count == 1);
+        }
+        REQUIRE(getTagStats(Tag).bytes == 0);
+        REQUIRE(getTagStats(Tag).count == 0);
+    }
+
+    SECTION("Global operators untracked")
+    {
+        EastlAllocationTracker::SetEnabled(true);
+        const auto before = getTagStats("unnamed");
+
+        auto* ints = new int[100];
+        auto* strings = new std::string[10];
+        REQUIRE(getTagStats("unnamed").totalCount == before.totalCount);
+        delete[] strings;
+        delete[] ints;
+        REQUIRE(getTagStats("unnamed").bytes == before.bytes);
+    }
+}
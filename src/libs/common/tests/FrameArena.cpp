@@ -0,0 +1,290 @@
+#include "common/FrameArena.hpp"
+
+#include <EASTL/optional.h>
+#include <catch2/catch_all.hpp>
+#include <thread>
+
+using namespace RR::Common;
+
+namespace
+{
+    constexpr size_t PageSize = 1024;
+
+    bool isAligned(const void* pointer, size_t alignment) { return reinterpret_cast<uintptr_t>(pointer) % alignment == 0; }
+}
+
+TEST_CASE("Frame arena", "[FrameArena]")
+{
+    ArenaPagePool pool(PageSize);
+    FrameArena arena(pool);
+
+    SECTION("Alignment")
+    {
+        for (const size_t alignment : {1u, 2u, 8u, 16u, 64u, 256u})
+        {
+            arena.allocate(1, 1);
+            REQUIRE(isAligned(arena.allocate(8, alignment), alignment));
+        }
+
+        // Oversized blocks are aligned too.
+        REQUIRE(isAligned(arena.allocate(PageSize * 2, 256), 256));
+        REQUIRE(arena.getStats().oversizedCount == 1);
+
+        REQUIRE(arena.allocate(0) == nullptr);
+        REQUIRE(std::string_view(arena.allocateString("frame")) == "frame");
+    }
+
+    SECTION("Rollback across pages")
+    {
+        arena.allocate(100);
+        const auto marker = arena.getMarker();
+        const auto first = arena.allocate(200);
+
+        // Fill a few pages and add an oversized block in between.
+        for (uint32_t index = 0; index < 8; index++)
+            arena.allocate(300);
+        arena.allocate(PageSize * 4);
+        arena.allocate(300);
+
+        const auto pagesCount = arena.getStats().pagesCount;
+        REQUIRE(pagesCount > 2);
+        REQUIRE(arena.getStats().oversizedCount == 1);
+
+        arena.rollback(marker);
+        REQUIRE(arena.getStats().usedBytes == marker.usedBytes);
+        REQUIRE(arena.getStats().wasteBytes == marker.wasteBytes);
+        REQUIRE(arena.getStats().oversizedCount == 0);
+        // Pages stay with the arena.
+        REQUIRE(arena.getStats().pagesCount == pagesCount);
+        REQUIRE(pool.GetFreePagesCount() == 0);
+
+        REQUIRE(arena.allocate(200) == first);
+    }
+
+    SECTION("Marker in the middle page")
+    {
+        for (uint32_t index = 0; index < 5; index++)
+            arena.allocate(300);
+
+        const auto marker = arena.getMarker();
+        const auto first = arena.allocate(300);
+        const auto usedBytes = arena.getStats().usedBytes;
+
+        for (uint32_t index = 0; index < 6; index++)
+            arena.allocate(300);
+
+        {
+            FrameArena::ScopedMarker scope(arena);
+            arena.allocate(PageSize * 2);
+            arena.allocate(300);
+        }
+        REQUIRE(arena.getStats().oversizedCount == 0);
+
+        arena.rollback(marker);
+        REQUIRE(arena.allocate(300) == first);
+        REQUIRE(arena.getStats().usedBytes == usedBytes);
+    }
+
+    SECTION("Marker before first page")
+    {
+        const auto marker = arena.getMarker();
+        REQUIRE(arena.getStats().pagesCount == 0);
+
+        // Rollback without pages is a no-op.
+        arena.rollback(marker);
+        REQUIRE(arena.getStats().pagesCount == 0);
+
+        const auto first = arena.allocate(64);
+        for (uint32_t index = 0; index < 8; index++)
+            arena.allocate(300);
+        arena.allocate(PageSize * 2);
+
+        arena.rollback(marker);
+        REQUIRE(arena.getStats().usedBytes == 0);
+        REQUIRE(arena.getStats().wasteBytes == 0);
+        REQUIRE(arena.getStats().oversizedCount == 0);
+        REQUIRE(arena.allocate(64) == first);
+    }
+
+    SECTION("Reset and trim")
+    {
+        for (uint32_t index = 0; index < 10; index++)
+            arena.allocate(300);
+        arena.allocate(PageSize * 2);
+
+        const auto pagesCount = arena.getStats().pagesCount;
+        REQUIRE(pagesCount > 2);
+        REQUIRE(pool.GetPagesCount() == pagesCount);
+
+        arena.reset();
+        REQUIRE(arena.getStats().usedBytes == 0);
+        REQUIRE(arena.getStats().oversizedCount == 0);
+        REQUIRE(arena.getStats().pagesCount == pagesCount);
+        REQUIRE(pool.GetFreePagesCount() == 0);
+
+        arena.trim(1);
+        REQUIRE(arena.getStats().pagesCount == 1);
+        REQUIRE(pool.GetFreePagesCount() == pagesCount - 1);
+
+        // Arena grows again with pages taken back from the pool.
+        for (uint32_t index = 0; index < 4; index++)
+            arena.allocate(300);
+        REQUIRE(arena.getStats().pagesCount == 2);
+        REQUIRE(pool.GetPagesCount() == pagesCount);
+        REQUIRE(pool.GetFreePagesCount() == pagesCount - 2);
+
+        arena.reset();
+        arena.trim();
+        REQUIRE(arena.getStats().pagesCount == 0);
+        REQUIRE(pool.GetFreePagesCount() == pagesCount);
+
+        // Arena is usable after all pages are gone.
+        REQUIRE(arena.allocate(64));
+        REQUIRE(pool.GetFreePagesCount() == pagesCount - 1);
+    }
+
+    SECTION("Peak")
+    {
+        arena.allocate(512, 1);
+        arena.reset();
+        arena.allocate(128, 1);
+        REQUIRE(arena.getStats().usedBytes == 128);
+        REQUIRE(arena.getStats().peakBytes == 512);
+    }
+}
+
+TEST_CASE("Arena page pool", "[FrameArena]")
+{
+    constexpr uint32_t ThreadsCount = 4;
+    constexpr uint32_t Iterations = 20000;
+    constexpr uint32_t PagesPerIteration = 3;
+
+    ArenaPagePool pool(PageSize);
+    std::atomic<uint32_t> corrupted = 0;
+
+    // Page handed out twice would get its stamp overwritten by the other owner.
+    eastl::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < ThreadsCount; thread++)
+        threads.emplace_back([&pool, &corrupted, thread] {
+            std::byte* pages[PagesPerIteration];
+            for (uint32_t iteration = 0; iteration < Iterations; iteration++)
+            {
+                const uint64_t stamp = (uint64_t(thread) << 32) | iteration;
+                for (auto& page : pages)
+                {
+                    page = pool.Acquire();
+                    std::memcpy(page, &stamp, sizeof(stamp));
+                    std::memcpy(page + PageSize - sizeof(stamp), &stamp, sizeof(stamp));
+                }
+
+                std::this_thread::yield();
+
+                for (auto page : pages)
+                {
+                    uint64_t front, back;
+                    std::memcpy(&front, page, sizeof(front));
+                    std::memcpy(&back, page + PageSize - sizeof(back), sizeof(back));
+                    corrupted.fetch_add(front != stamp || back != stamp, std::memory_order_relaxed);
+                    pool.Release(page);
+                }
+            }
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(corrupted.load() == 0);
+    REQUIRE(pool.GetPagesCount() <= ThreadsCount * PagesPerIteration);
+    REQUIRE(pool.GetFreePagesCount() == pool.GetPagesCount());
+}
+
+TEST_CASE("Thread frame arenas", "[FrameArena]")
+{
+    ArenaPagePool pool(PageSize);
+
+    SECTION("Instances used alternately")
+    {
+        ThreadFrameArenas first(pool);
+        ThreadFrameArenas second(pool);
+
+        FrameArena& firstLocal = first.local();
+        FrameArena& secondLocal = second.local();
+        REQUIRE(&firstLocal != &secondLocal);
+
+        for (uint32_t index = 0; index < 10; index++)
+        {
+            REQUIRE(&first.local() == &firstLocal);
+            first.allocate(16);
+            REQUIRE(&second.local() == &secondLocal);
+            second.allocate(32);
+        }
+
+        REQUIRE(first.getStats().usedBytes == 10 * 16);
+        REQUIRE(second.getStats().usedBytes == 10 * 32);
+    }
+
+    SECTION("More instances than cached")
+    {
+        constexpr size_t InstancesCount = ThreadFrameArenas::LocalCacheSize * 2 + 1;
+
+        eastl::vector<eastl::unique_ptr<ThreadFrameArenas>> instances;
+        eastl::vector<FrameArena*> locals;
+        for (size_t index = 0; index < InstancesCount; index++)
+        {
+            instances.push_back(eastl::make_unique<ThreadFrameArenas>(pool));
+            locals.push_back(&instances.back()->local());
+        }
+
+        for (uint32_t round = 0; round < 3; round++)
+            for (size_t index = 0; index < InstancesCount; index++)
+            {
+                REQUIRE(&instances[index]->local() == locals[index]);
+                instances[index]->allocate(16);
+            }
+
+        for (const auto& instance : instances)
+            REQUIRE(instance->getStats().usedBytes == 3 * 16);
+    }
+
+    SECTION("Instance replaced at the same address")
+    {
+        // Lookup cache must not hand out the arena of a destroyed instance.
+        eastl::optional<ThreadFrameArenas> instance;
+        instance.emplace(pool);
+        instance->allocate(16);
+
+        instance.emplace(pool);
+        REQUIRE(instance->getStats().usedBytes == 0);
+        instance->allocate(32);
+        REQUIRE(instance->getStats().usedBytes == 32);
+    }
+
+    SECTION("Threads")
+    {
+        constexpr uint32_t ThreadsCount = 4;
+        constexpr uint32_t AllocationsCount = 1000;
+
+        ThreadFrameArenas arenas(pool);
+        std::atomic<uint32_t> shared = 0;
+        FrameArena* threadArenas[ThreadsCount];
+
+        eastl::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < ThreadsCount; thread++)
+            threads.emplace_back([&arenas, &threadArenas, &shared, thread] {
+                threadArenas[thread] = &arenas.local();
+                for (uint32_t index = 0; index < AllocationsCount; index++)
+                    arenas.allocate(16);
+                shared.fetch_add(&arenas.local() != threadArenas[thread], std::memory_order_relaxed);
+            });
+
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(shared.load() == 0);
+
+        REQUIRE(arenas.getStats().usedBytes == ThreadsCount * AllocationsCount * 16);
+
+        arenas.reset();
+        REQUIRE(arenas.getStats().usedBytes == 0);
+    }
+}
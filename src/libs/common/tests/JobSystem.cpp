@@ -0,0 +1,251 @@
+#include "common/threading/JobSystem.hpp"
+#include "common/threading/WorkStealingDeque.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <thread>
+
+using namespace RR::Common::Threading;
+
+namespace
+{
+    // Catch assertions are not thread safe, so workers count hits and the test checks them afterwards.
+    struct HitCounters
+    {
+        explicit HitCounters(uint32_t count) : count(count), hits(new std::atomic<uint32_t>[count]()) { }
+
+        void Hit(uint32_t index) { hits[index].fetch_add(1, std::memory_order_relaxed); }
+
+        // Number of indices, which were not hit exactly once.
+        uint32_t CountMismatches() const
+        {
+            uint32_t mismatches = 0;
+            for (uint32_t index = 0; index < count; index++)
+                mismatches += hits[index].load(std::memory_order_relaxed) != 1;
+            return mismatches;
+        }
+
+        uint32_t count;
+        eastl::unique_ptr<std::atomic<uint32_t>[]> hits;
+    };
+}
+
+TEST_CASE("Work stealing deque", "[Threading][JobSystem]")
+{
+    SECTION("Owner order")
+    {
+        WorkStealingDeque<uint32_t, 4> deque;
+        for (uint32_t item = 0; item < 4; item++)
+            REQUIRE(deque.Push(item));
+        REQUIRE(!deque.Push(4));
+
+        uint32_t item;
+        REQUIRE(deque.Steal(item));
+        REQUIRE(item == 0);
+        REQUIRE(deque.Pop(item));
+        REQUIRE(item == 3);
+        REQUIRE(deque.GetSize() == 2);
+
+        // Freed slots are reused after wrapping around.
+        REQUIRE(deque.Push(4));
+        REQUIRE(deque.Push(5));
+        REQUIRE(!deque.Push(6));
+
+        eastl::vector<uint32_t> popped;
+        while (deque.Pop(item))
+            popped.push_back(item);
+        REQUIRE(popped == eastl::vector<uint32_t> {5, 4, 2, 1});
+        REQUIRE(!deque.Steal(item));
+    }
+
+    SECTION("Pop and steal race")
+    {
+        constexpr uint32_t ItemsCount = 200000;
+        constexpr uint32_t ThievesCount = 3;
+
+        WorkStealingDeque<uint32_t, 64> deque;
+        HitCounters taken(ItemsCount);
+        std::atomic<uint32_t> takenCount = 0;
+        std::atomic<bool> stop = false;
+
+        const auto take = [&taken, &takenCount](uint32_t item) {
+            taken.Hit(item);
+            takenCount.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        eastl::vector<std::thread> thieves;
+        for (uint32_t index = 0; index < ThievesCount; index++)
+            thieves.emplace_back([&deque, &stop, &take] {
+                uint32_t item;
+                while (!stop.load(std::memory_order_acquire))
+                    if (deque.Steal(item))
+                        take(item);
+            });
+
+        // Owner keeps the deque short, so pops of the last item race with thieves.
+        uint32_t item;
+        for (uint32_t next = 0; next < ItemsCount;)
+        {
+            for (uint32_t pushed = 0; pushed < 3 && next < ItemsCount && deque.Push(next); pushed++)
+                next++;
+
+            if (deque.Pop(item))
+                take(item);
+        }
+
+        // Failed pop means the deque is empty, the last item could only go to a thief.
+        while (deque.Pop(item))
+            take(item);
+
+        while (takenCount.load(std::memory_order_relaxed) < ItemsCount)
+            std::this_thread::yield();
+
+        stop.store(true, std::memory_order_release);
+        for (auto& thief : thieves)
+            thief.join();
+
+        REQUIRE(takenCount.load() == ItemsCount);
+        REQUIRE(taken.CountMismatches() == 0);
+    }
+}
+
+TEST_CASE("Job counters", "[Threading][JobSystem]")
+{
+    JobSystem jobSystem(3);
+
+    SECTION("Wait")
+    {
+        constexpr uint32_t JobsCount = 10000;
+        HitCounters executed(JobsCount);
+
+        JobCounter counter;
+        for (uint32_t index = 0; index < JobsCount; index++)
+            jobSystem.Run([&executed, index] { executed.Hit(index); }, counter);
+        jobSystem.Wait(counter);
+
+        REQUIRE(counter.IsDone());
+        REQUIRE(executed.CountMismatches() == 0);
+    }
+
+    SECTION("Jobs spawned by jobs")
+    {
+        constexpr uint32_t OuterCount = 64;
+        constexpr uint32_t InnerCount = 64;
+        HitCounters executed(OuterCount * InnerCount);
+
+        // Inner jobs are pushed to deques of workers, counter can't drop to zero while the outer job is running.
+        JobCounter counter;
+        for (uint32_t outer = 0; outer < OuterCount; outer++)
+            jobSystem.Run([&jobSystem, &executed, &counter, outer] {
+                for (uint32_t inner = 0; inner < InnerCount; inner++)
+                    jobSystem.Run([&executed, outer, inner] { executed.Hit(outer * InnerCount + inner); }, counter);
+            }, counter);
+        jobSystem.Wait(counter);
+
+        REQUIRE(executed.CountMismatches() == 0);
+    }
+
+    SECTION("Dependency")
+    {
+        constexpr uint32_t JobsCount = 16;
+
+        for (uint32_t iteration = 0; iteration < 200; iteration++)
+        {
+            std::atomic<uint32_t> firstDone = 0;
+            std::atomic<uint32_t> secondDone = 0;
+            std::atomic<uint32_t> startedEarly = 0;
+
+            JobCounter first;
+            JobCounter second;
+            for (uint32_t index = 0; index < JobsCount; index++)
+                jobSystem.Run([&firstDone] { firstDone.fetch_add(1, std::memory_order_relaxed); }, first);
+            for (uint32_t index = 0; index < JobsCount; index++)
+                jobSystem.Run([&firstDone, &secondDone, &startedEarly] {
+                    startedEarly.fetch_add(firstDone.load(std::memory_order_relaxed) != JobsCount, std::memory_order_relaxed);
+                    secondDone.fetch_add(1, std::memory_order_relaxed);
+                }, second, first);
+
+            jobSystem.Wait(second);
+            jobSystem.Wait(first);
+
+            REQUIRE(startedEarly.load() == 0);
+            REQUIRE(secondDone.load() == JobsCount);
+        }
+    }
+
+    SECTION("Done dependency")
+    {
+        JobCounter dependency;
+        jobSystem.Wait(dependency);
+
+        bool executed = false;
+        JobCounter counter;
+        jobSystem.Run([&executed] { executed = true; }, counter, dependency);
+        jobSystem.Wait(counter);
+        REQUIRE(executed);
+    }
+
+    SECTION("No workers")
+    {
+        // Waiting thread executes jobs itself.
+        JobSystem serial(0);
+
+        uint32_t executed = 0;
+        JobCounter counter;
+        for (uint32_t index = 0; index < 100; index++)
+            serial.Run([&executed] { executed++; }, counter);
+        serial.Wait(counter);
+        REQUIRE(executed == 100);
+    }
+}
+
+TEST_CASE("Parallel for", "[Threading][JobSystem]")
+{
+    JobSystem jobSystem(3);
+
+    const auto run = [&jobSystem](uint32_t begin, uint32_t end, uint32_t grainSize) {
+        HitCounters visited(end - begin);
+        std::atomic<uint32_t> wrongRanges = 0;
+
+        jobSystem.ParallelFor(begin, end, grainSize, [&visited, &wrongRanges, begin, end, grainSize](uint32_t rangeBegin, uint32_t rangeEnd) {
+            const bool wrongRange = rangeBegin < begin || rangeEnd > end || rangeBegin >= rangeEnd || (grainSize && rangeEnd - rangeBegin > grainSize);
+            wrongRanges.fetch_add(wrongRange, std::memory_order_relaxed);
+            if (wrongRange)
+                return;
+
+            for (uint32_t index = rangeBegin; index < rangeEnd; index++)
+                visited.Hit(index - begin);
+        });
+
+        REQUIRE(wrongRanges.load() == 0);
+        REQUIRE(visited.CountMismatches() == 0);
+    };
+
+    SECTION("Grain sizes")
+    {
+        for (const uint32_t grainSize : {0u, 1u, 7u, 64u, 4999u, 5000u, 10000u})
+            run(0, 5000, grainSize);
+    }
+
+    SECTION("Small ranges")
+    {
+        run(10, 11, 0);
+        run(10, 11, 4);
+        run(100, 133, 8);
+    }
+
+    SECTION("End of index range")
+    {
+        constexpr uint32_t Max = eastl::numeric_limits<uint32_t>::max();
+        run(Max - 1000, Max, 64);
+        run(Max - 1000, Max, 999);
+        run(Max - 1000, Max, 0);
+    }
+
+    SECTION("Empty range")
+    {
+        bool called = false;
+        jobSystem.ParallelFor(10, 10, 1, [&called](uint32_t, uint32_t) { called = true; });
+        jobSystem.ParallelFor(10, 5, 1, [&called](uint32_t, uint32_t) { called = true; });
+        REQUIRE(!called);
+    }
+}
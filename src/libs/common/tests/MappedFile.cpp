@@ -0,0 +1,201 @@
+#include "common/Result.hpp"
+#include "common/io/File.hpp"
+#include "common/io/MappedFile.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <filesystem>
+
+using namespace RR::Common;
+using namespace RR::Common::IO;
+
+namespace
+{
+    std::byte patternByte(uint64_t offset) { return std::byte(offset % 251); }
+
+    // File with a known pattern in the temp directory, removed on scope exit.
+    struct TempFile
+    {
+        TempFile(const char* name, uint64_t size) : path((std::filesystem::temp_directory_path() / name).string())
+        {
+            eastl::vector<std::byte> content(size);
+            for (uint64_t offset = 0; offset < size; offset++)
+                content[offset] = patternByte(offset);
+
+            File file;
+            REQUIRE(file.Open(path, FileOpenMode::CreateTruncate) == RResult::Ok);
+            REQUIRE(file.Write(content.data(), content.size()) == content.size());
+        }
+
+        ~TempFile() { std::filesystem::remove(path); }
+
+        std::string path;
+    };
+
+    // Number of bytes that don't match the pattern at their file offset.
+    size_t countMismatches(eastl::span<const std::byte> data, uint64_t fileOffset)
+    {
+        size_t mismatches = 0;
+        for (size_t index = 0; index < data.size(); index++)
+            mismatches += data[index] != patternByte(fileOffset + index);
+        return mismatches;
+    }
+}
+
+TEST_CASE("Mapped file", "[IO][MappedFile]")
+{
+    const size_t granularity = MappedFile::GetMappingGranularity();
+    REQUIRE(granularity > 0);
+    REQUIRE(RR::IsPowerOfTwo(granularity));
+
+    SECTION("Unaligned offsets")
+    {
+        const uint64_t fileSize = granularity * 3 + 123;
+        TempFile temp("rr_mapped_file_offsets.bin", fileSize);
+
+        MappedFile file;
+        REQUIRE(file.Open(temp.path) == RResult::Ok);
+        REQUIRE(file.GetFileSize() == fileSize);
+
+        for (const uint64_t offset : {uint64_t(0), uint64_t(1), uint64_t(17), granularity - 1, granularity, granularity + 5, granularity * 2 + 100, fileSize - 1})
+            for (const size_t size : {size_t(0), size_t(1), size_t(100), granularity + 1})
+            {
+                if (offset + size > fileSize)
+                    continue;
+
+                MappedView view;
+                REQUIRE(file.Map(offset, size, view) == RResult::Ok);
+                REQUIRE(view.IsMapped());
+                REQUIRE(view.GetFileOffset() == offset);
+                // Zero size maps up to the end of file.
+                REQUIRE(view.GetSize() == (size ? size : fileSize - offset));
+                REQUIRE(countMismatches(view.GetSpan(), offset) == 0);
+            }
+    }
+
+    SECTION("Out of range")
+    {
+        TempFile temp("rr_mapped_file_range.bin", 1000);
+
+        MappedFile file;
+        REQUIRE(file.Open(temp.path) == RResult::Ok);
+
+        MappedView view;
+        REQUIRE(file.Map(1001, 0, view) == RResult::InvalidArgument);
+        REQUIRE(file.Map(500, 501, view) == RResult::InvalidArgument);
+        REQUIRE(!view.IsMapped());
+
+        // Mapping at the very end has nothing to map.
+        REQUIRE(file.Map(1000, 0, view) == RResult::Ok);
+        REQUIRE(!view.IsMapped());
+        REQUIRE(view.GetSize() == 0);
+
+        // Failed map leaves the view unmapped.
+        REQUIRE(file.Map(view) == RResult::Ok);
+        REQUIRE(view.IsMapped());
+        REQUIRE(file.Map(2000, 1, view) == RResult::InvalidArgument);
+        REQUIRE(!view.IsMapped());
+    }
+
+    SECTION("Empty file")
+    {
+        TempFile temp("rr_mapped_file_empty.bin", 0);
+
+        MappedFile file;
+        REQUIRE(file.Open(temp.path) == RResult::Ok);
+        REQUIRE(file.GetFileSize() == 0);
+
+        MappedView view;
+        REQUIRE(file.Map(view) == RResult::Ok);
+        REQUIRE(!view.IsMapped());
+        REQUIRE(view.GetSize() == 0);
+        REQUIRE(view.GetSpan().empty());
+    }
+
+    SECTION("Missing file")
+    {
+        MappedFile file;
+        REQUIRE(file.Open((std::filesystem::temp_directory_path() / "rr_mapped_file_missing.bin").string()) == RResult::FileNotFound);
+        REQUIRE(!file.IsOpen());
+    }
+
+    SECTION("Copy on write")
+    {
+        const uint64_t fileSize = granularity * 2;
+        TempFile temp("rr_mapped_file_cow.bin", fileSize);
+
+        {
+            MappedFile file;
+            REQUIRE(file.Open(temp.path, MappedFileMode::CopyOnWrite) == RResult::Ok);
+
+            MappedView view;
+            REQUIRE(file.Map(granularity - 8, 16, view) == RResult::Ok);
+            std::memset(view.GetMutableData(), 0xAB, view.GetSize());
+            REQUIRE(view.GetData()[0] == std::byte(0xAB));
+            REQUIRE(view.GetData()[15] == std::byte(0xAB));
+
+            // Other mappings of the same file don't see private copies.
+            MappedFile readOnly;
+            REQUIRE(readOnly.Open(temp.path) == RResult::Ok);
+            MappedView original;
+            REQUIRE(readOnly.Map(original) == RResult::Ok);
+            REQUIRE(countMismatches(original.GetSpan(), 0) == 0);
+        }
+
+        // Nor does the file itself.
+        eastl::vector<std::byte> content(fileSize);
+        File file;
+        REQUIRE(file.Open(temp.path, FileOpenMode::Read) == RResult::Ok);
+        REQUIRE(file.Read(content.data(), content.size()) == content.size());
+        REQUIRE(countMismatches({content.data(), content.size()}, 0) == 0);
+    }
+
+    SECTION("View outlives file")
+    {
+        const uint64_t fileSize = granularity + 10;
+        TempFile temp("rr_mapped_file_outlive.bin", fileSize);
+
+        MappedView view;
+        MappedView moved;
+        {
+            MappedFile file;
+            REQUIRE(file.Open(temp.path) == RResult::Ok);
+            REQUIRE(file.Map(3, 0, view) == RResult::Ok);
+            REQUIRE(file.Map(moved) == RResult::Ok);
+
+            file.Close();
+            REQUIRE(!file.IsOpen());
+            REQUIRE(file.GetFileSize() == 0);
+        }
+
+        REQUIRE(view.IsMapped());
+        REQUIRE(countMismatches(view.GetSpan(), 3) == 0);
+
+        MappedView target = eastl::move(moved);
+        REQUIRE(!moved.IsMapped());
+        REQUIRE(target.GetSize() == fileSize);
+        REQUIRE(countMismatches(target.GetSpan(), 0) == 0);
+
+        view.Advise(MappedAccessHint::DontNeed);
+        REQUIRE(countMismatches(view.GetSpan(), 3) == 0);
+    }
+
+    SECTION("Sub view")
+    {
+        TempFile temp("rr_mapped_file_sub.bin", granularity * 2);
+
+        MappedFile file;
+        REQUIRE(file.Open(temp.path) == RResult::Ok);
+
+        MappedView view;
+        REQUIRE(file.Map(granularity / 2, granularity, view) == RResult::Ok);
+
+        const auto subView = view.SubView(10, 100);
+        REQUIRE(subView.size() == 100);
+        REQUIRE(subView.data() == view.GetData() + 10);
+        REQUIRE(countMismatches(subView, granularity / 2 + 10) == 0);
+
+        REQUIRE(view.SubView(view.GetSize(), 0).empty());
+        REQUIRE(view.SubView(0, view.GetSize()).size() == view.GetSize());
+    }
+}
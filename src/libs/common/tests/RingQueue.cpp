@@ -0,0 +1,281 @@
+#include "common/threading/MpscRingQueue.hpp"
+#include "common/threading/SpscRingQueue.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <thread>
+
+using namespace RR::Common::Threading;
+
+namespace
+{
+    // Item carries its producer and sequence number, so consumer can check the order of every producer.
+    constexpr uint32_t SequenceBits = 24;
+    constexpr uint32_t SequenceMask = (1u << SequenceBits) - 1;
+
+    uint32_t makeItem(uint32_t producer, uint32_t sequence) { return (producer << SequenceBits) | sequence; }
+    uint32_t getProducer(uint32_t item) { return item >> SequenceBits; }
+    uint32_t getSequence(uint32_t item) { return item & SequenceMask; }
+
+    // Catch assertions are not thread safe, so only the consumer thread checks items and the test checks the counters afterwards.
+    struct OrderChecker
+    {
+        explicit OrderChecker(uint32_t producersCount) : nextSequence(producersCount, 0) { }
+
+        void Check(uint32_t item)
+        {
+            const uint32_t producer = getProducer(item);
+            if (producer >= nextSequence.size() || getSequence(item) != nextSequence[producer])
+            {
+                mismatches++;
+                return;
+            }
+
+            nextSequence[producer]++;
+        }
+
+        // Every producer sequence arrived in order without gaps or duplicates.
+        bool AllReceived(uint32_t itemsPerProducer) const
+        {
+            return mismatches == 0 && eastl::all_of(nextSequence.begin(), nextSequence.end(),
+                                                    [itemsPerProducer](uint32_t next) { return next == itemsPerProducer; });
+        }
+
+        eastl::vector<uint32_t> nextSequence;
+        uint32_t mismatches = 0;
+    };
+
+    struct Tracked
+    {
+        explicit Tracked(uint32_t value) : value(value) { alive.fetch_add(1, std::memory_order_relaxed); }
+        Tracked(const Tracked& other) : value(other.value) { alive.fetch_add(1, std::memory_order_relaxed); }
+        Tracked(Tracked&& other) noexcept : value(other.value) { alive.fetch_add(1, std::memory_order_relaxed); }
+        Tracked& operator=(const Tracked& other) = default;
+        Tracked& operator=(Tracked&& other) noexcept = default;
+        ~Tracked() { alive.fetch_sub(1, std::memory_order_relaxed); }
+
+        uint32_t value;
+        static inline std::atomic<int32_t> alive = 0;
+    };
+
+    // Other thread echoes every item back, each round trip makes both sides park on an empty queue.
+    template <typename Queue>
+    bool runPingPong(uint32_t roundsCount)
+    {
+        auto requests = eastl::make_unique<Queue>();
+        auto responses = eastl::make_unique<Queue>();
+
+        std::thread echo([&requests, &responses, roundsCount] {
+            for (uint32_t round = 0; round < roundsCount; round++)
+                responses->Push(requests->Pop());
+        });
+
+        uint32_t mismatches = 0;
+        for (uint32_t round = 0; round < roundsCount; round++)
+        {
+            // Give the echo thread time to run out of spins and sleep.
+            if (round % 64 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+            requests->Push(round);
+            mismatches += responses->Pop() != round;
+        }
+
+        echo.join();
+        return mismatches == 0;
+    }
+
+    // Queue is pushed while the consumer is not looking, destructor has to destroy the items left.
+    template <typename Queue>
+    void checkDestructor()
+    {
+        REQUIRE(Tracked::alive.load() == 0);
+        {
+            Queue queue;
+            for (uint32_t index = 0; index < 4; index++)
+                REQUIRE(queue.TryPush(Tracked(index)));
+
+            Tracked item(0);
+            for (uint32_t index = 0; index < 3; index++)
+            {
+                REQUIRE(queue.TryPop(item));
+                REQUIRE(item.value == index);
+            }
+
+            // Items left wrap around the end of the storage.
+            REQUIRE(queue.TryPush(Tracked(4)));
+            REQUIRE(queue.TryPush(Tracked(5)));
+            REQUIRE(queue.Size() == 3);
+            REQUIRE(Tracked::alive.load() == 4);
+        }
+        REQUIRE(Tracked::alive.load() == 0);
+    }
+}
+
+TEST_CASE("Mpsc ring queue", "[Threading][RingQueue]")
+{
+    SECTION("Producers order")
+    {
+        constexpr uint32_t ProducersCount = 4;
+        constexpr uint32_t ItemsPerProducer = 50000;
+
+        auto queue = eastl::make_unique<MpscRingQueue<uint32_t, 64>>();
+
+        eastl::vector<std::thread> producers;
+        for (uint32_t producer = 0; producer < ProducersCount; producer++)
+            producers.emplace_back([&queue, producer] {
+                for (uint32_t sequence = 0; sequence < ItemsPerProducer; sequence++)
+                    queue->Push(makeItem(producer, sequence));
+            });
+
+        OrderChecker checker(ProducersCount);
+        for (uint32_t index = 0; index < ProducersCount * ItemsPerProducer; index++)
+            checker.Check(queue->Pop());
+
+        for (auto& producer : producers)
+            producer.join();
+
+        REQUIRE(checker.AllReceived(ItemsPerProducer));
+        REQUIRE(queue->Empty());
+    }
+
+    SECTION("Batches and single pushes")
+    {
+        constexpr uint32_t ProducersCount = 4;
+        constexpr uint32_t ItemsPerProducer = 40000;
+        constexpr uint32_t BatchSize = 8;
+
+        auto queue = eastl::make_unique<MpscRingQueue<uint32_t, 64>>();
+
+        // Even producers push batches, odd ones push single items into the same slots.
+        eastl::vector<std::thread> producers;
+        for (uint32_t producer = 0; producer < ProducersCount; producer++)
+            producers.emplace_back([&queue, producer] {
+                if (producer % 2)
+                {
+                    for (uint32_t sequence = 0; sequence < ItemsPerProducer; sequence++)
+                        queue->Push(makeItem(producer, sequence));
+                    return;
+                }
+
+                uint32_t batch[BatchSize];
+                for (uint32_t sequence = 0; sequence < ItemsPerProducer; sequence += BatchSize)
+                {
+                    for (uint32_t index = 0; index < BatchSize; index++)
+                        batch[index] = makeItem(producer, sequence + index);
+
+                    while (!queue->TryPushBatch(batch, BatchSize))
+                        std::this_thread::yield();
+                }
+            });
+
+        OrderChecker checker(ProducersCount);
+        uint32_t brokenBatches = 0;
+        uint32_t previous = ~0u;
+        const auto receive = [&checker, &brokenBatches, &previous](uint32_t item) {
+            checker.Check(item);
+
+            // Batch is claimed as one run, so nothing can be interleaved between its items.
+            if (getProducer(item) % 2 == 0 && getSequence(item) % BatchSize != 0)
+                brokenBatches += previous != item - 1;
+
+            previous = item;
+        };
+
+        uint32_t received = 0;
+        uint32_t items[BatchSize / 2 + 1];
+        while (received < ProducersCount * ItemsPerProducer)
+        {
+            // Pop sizes don't match the batch size, so batches are split between pops.
+            const std::size_t count = queue->TryPopBatch(items, BatchSize / 2 + 1);
+            for (std::size_t index = 0; index < count; index++)
+                receive(items[index]);
+            received += uint32_t(count);
+
+            if (count == 0)
+            {
+                receive(queue->Pop());
+                received++;
+            }
+        }
+
+        for (auto& producer : producers)
+            producer.join();
+
+        REQUIRE(checker.AllReceived(ItemsPerProducer));
+        REQUIRE(brokenBatches == 0);
+        REQUIRE(queue->Empty());
+    }
+
+    SECTION("Parking")
+    {
+        REQUIRE(runPingPong<MpscRingQueue<uint32_t, 64>>(5000));
+    }
+
+    SECTION("Destructor")
+    {
+        checkDestructor<MpscRingQueue<Tracked, 4>>();
+    }
+}
+
+TEST_CASE("Spsc ring queue", "[Threading][RingQueue]")
+{
+    SECTION("Order")
+    {
+        constexpr uint32_t ItemsCount = 200000;
+        constexpr uint32_t BatchSize = 8;
+
+        auto queue = eastl::make_unique<SpscRingQueue<uint32_t, 64>>();
+
+        // Producer mixes single and batch pushes.
+        std::thread producer([&queue] {
+            uint32_t batch[BatchSize];
+            for (uint32_t sequence = 0; sequence < ItemsCount;)
+            {
+                if ((sequence / BatchSize) % 2)
+                {
+                    queue->Push(makeItem(0, sequence++));
+                    continue;
+                }
+
+                for (uint32_t index = 0; index < BatchSize; index++)
+                    batch[index] = makeItem(0, sequence + index);
+
+                while (!queue->TryPushBatch(batch, BatchSize))
+                    std::this_thread::yield();
+                sequence += BatchSize;
+            }
+        });
+
+        OrderChecker checker(1);
+        uint32_t received = 0;
+        uint32_t items[5];
+        while (received < ItemsCount)
+        {
+            const std::size_t count = queue->TryPopBatch(items, 5);
+            for (std::size_t index = 0; index < count; index++)
+                checker.Check(items[index]);
+            received += uint32_t(count);
+
+            if (count == 0)
+            {
+                checker.Check(queue->Pop());
+                received++;
+            }
+        }
+
+        producer.join();
+
+        REQUIRE(checker.AllReceived(ItemsCount));
+        REQUIRE(queue->Empty());
+    }
+
+    SECTION("Parking")
+    {
+        REQUIRE(runPingPong<SpscRingQueue<uint32_t, 64>>(5000));
+    }
+
+    SECTION("Destructor")
+    {
+        checkDestructor<SpscRingQueue<Tracked, 4>>();
+    }
+}
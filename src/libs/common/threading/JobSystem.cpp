@@ -0,0 +1,224 @@
+#include "JobSystem.hpp"
+
+namespace RR::Common::Threading
+{
+    struct Job
+    {
+        JobSystem::JobFunction function;
+        JobCounter* counter;
+    };
+
+    namespace
+    {
+        // Worker identity of the current thread, jobs spawned by a worker go to its own deque.
+        thread_local JobSystem* currentSystem = nullptr;
+        thread_local uint32_t currentWorker = 0;
+    }
+
+    JobSystem::JobSystem(uint32_t workersCount)
+        : workersCount(workersCount),
+          workerQueues(new Worker[workersCount])
+    {
+        workers.reserve(workersCount);
+        for (uint32_t index = 0; index < workersCount; index++)
+            workers.emplace_back(fmt::format("Job worker {}", index), [this, index] { workerLoop(index); });
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            ReadWriteGuard<Mutex> lock(wakeMutex);
+            stop = true;
+        }
+        wakeCondition.notify_all();
+
+        for (auto& worker : workers)
+            worker.Join();
+
+        ASSERT_MSG(queuedCount.load(std::memory_order_relaxed) == 0, "Job system destroyed with pending jobs");
+    }
+
+    void JobSystem::Run(JobFunction function, JobCounter& counter)
+    {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        submit(new Job {eastl::move(function), &counter});
+        wake();
+    }
+
+    void JobSystem::Run(JobFunction function, JobCounter& counter, JobCounter& dependency)
+    {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        auto job = new Job {eastl::move(function), &counter};
+
+        {
+            ReadWriteGuard<SpinLock> lock(dependency.lock);
+            if (dependency.pending.load(std::memory_order_acquire) > 0)
+            {
+                dependency.continuations.push_back(job);
+                return;
+            }
+        }
+
+        submit(job);
+        wake();
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            Job* job;
+            if (tryGetJob(job))
+                execute(job);
+            else
+                std::this_thread::yield();
+        }
+
+        // Last finisher may still be releasing continuations, counter can't go away before it leaves.
+        ReadWriteGuard<SpinLock> lock(counter.lock);
+    }
+
+    void JobSystem::ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function)
+    {
+        if (begin >= end)
+            return;
+
+        const uint32_t count = end - begin;
+        if (grainSize == 0)
+            grainSize = eastl::max(count / ((workersCount + 1) * 4), 1u);
+
+        if (count <= grainSize)
+        {
+            function(begin, end);
+            return;
+        }
+
+        JobCounter counter;
+        // Caller keeps the first range to itself, it would have to wait for it anyway.
+        // Loop runs on the remaining count, so ranges near the end of uint32_t range don't wrap.
+        uint32_t rangeBegin = begin + grainSize;
+        for (uint32_t remaining = count - grainSize; remaining > 0;)
+        {
+            const uint32_t rangeSize = eastl::min(remaining, grainSize);
+            const uint32_t rangeEnd = rangeBegin + rangeSize;
+            counter.pending.fetch_add(1, std::memory_order_relaxed);
+            submit(new Job {[&function, rangeBegin, rangeEnd] { function(rangeBegin, rangeEnd); }, &counter});
+
+            rangeBegin = rangeEnd;
+            remaining -= rangeSize;
+        }
+        wake();
+
+        function(begin, begin + grainSize);
+        Wait(counter);
+    }
+
+    void JobSystem::submit(Job* job)
+    {
+        // Counted before it becomes visible, so a thief never takes the counter below zero.
+        queuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+        if (currentSystem != this || !workerQueues[currentWorker].deque.Push(job))
+        {
+            ReadWriteGuard<SpinLock> lock(injectionLock);
+            injectionQueue.push_back(job);
+        }
+    }
+
+    void JobSystem::finish(JobCounter& counter)
+    {
+        // Fast path while there are other jobs left, only the last one has to release continuations.
+        uint32_t pending = counter.pending.load(std::memory_order_relaxed);
+        while (pending > 1)
+            if (counter.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return;
+
+        eastl::vector<Job*> continuations;
+        {
+            ReadWriteGuard<SpinLock> lock(counter.lock);
+            if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                continuations.swap(counter.continuations);
+        }
+
+        if (continuations.empty())
+            return;
+
+        for (auto job : continuations)
+            submit(job);
+        wake();
+    }
+
+    bool JobSystem::tryGetJob(Job*& job)
+    {
+        if (queuedCount.load(std::memory_order_acquire) == 0)
+            return false;
+
+        const bool isWorker = currentSystem == this;
+        bool found = isWorker && workerQueues[currentWorker].deque.Pop(job);
+
+        if (!found)
+        {
+            ReadWriteGuard<SpinLock> lock(injectionLock);
+            if (!injectionQueue.empty())
+            {
+                job = injectionQueue.front();
+                injectionQueue.pop_front();
+                found = true;
+            }
+        }
+
+        const uint32_t start = isWorker ? currentWorker + 1 : 0;
+        for (uint32_t offset = 0; !found && offset < workersCount; offset++)
+            found = workerQueues[(start + offset) % workersCount].deque.Steal(job);
+
+        if (found)
+            queuedCount.fetch_sub(1, std::memory_order_relaxed);
+
+        return found;
+    }
+
+    void JobSystem::execute(Job* job)
+    {
+        job->function();
+
+        JobCounter& counter = *job->counter;
+        delete job;
+        finish(counter);
+    }
+
+    void JobSystem::wake()
+    {
+        // Pairs with sleepingCount increment in workerLoop: either pusher sees a sleeper or sleeper sees the job.
+        if (sleepingCount.load(std::memory_order_seq_cst) == 0)
+            return;
+
+        {
+            ReadWriteGuard<Mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_all();
+    }
+
+    void JobSystem::workerLoop(uint32_t workerIndex)
+    {
+        currentSystem = this;
+        currentWorker = workerIndex;
+
+        for (;;)
+        {
+            Job* job;
+            if (tryGetJob(job))
+            {
+                execute(job);
+                continue;
+            }
+
+            UniqueLock<Mutex> lock(wakeMutex);
+            sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+            wakeCondition.wait(lock, [this] { return stop || queuedCount.load(std::memory_order_seq_cst) > 0; });
+            sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+
+            if (stop)
+                return;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
+#include "common/threading/Thread.hpp"
+#include "common/threading/WorkStealingDeque.hpp"
+
+#include <EASTL/deque.h>
+#include <atomic>
+#include <condition_variable>
+
+namespace RR::Common::Threading
+{
+    class JobSystem;
+    struct Job;
+
+    // Counts jobs that are not finished yet. Jobs can be chained on a counter and will be spawned once it drops to zero.
+    // Counter must outlive jobs that are attached to it, waiting on it is enough to guarantee that.
+    class JobCounter final : public Common::NonCopyable
+    {
+    public:
+        JobCounter() = default;
+        ~JobCounter() { ASSERT(IsDone()); }
+
+        [[nodiscard]] bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> pending = 0;
+        // Guards the transition to zero together with continuations.
+        SpinLock lock;
+        eastl::vector<Job*> continuations;
+    };
+
+    // Work stealing job scheduler.
+    // Every worker owns a Chase-Lev deque: it pushes and pops at the bottom while idle workers steal from the top.
+    // Jobs spawned outside of workers go to the shared injection queue. Threads waiting on a counter execute jobs
+    // instead of blocking, so main thread takes part in the work as well.
+    class JobSystem final : public Common::NonCopyable
+    {
+    public:
+        using JobFunction = std::function<void()>;
+        using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+        static constexpr size_t DequeCapacity = 4096;
+
+        explicit JobSystem(uint32_t workersCount = DefaultWorkersCount());
+        ~JobSystem();
+
+        // Spawns function, counter is incremented until it finishes.
+        void Run(JobFunction function, JobCounter& counter);
+        // Spawns function once dependency is done.
+        void Run(JobFunction function, JobCounter& counter, JobCounter& dependency);
+
+        // Executes pending jobs until counter is done.
+        void Wait(JobCounter& counter);
+
+        // Invokes function over [begin, end) split into ranges of grainSize and waits for them.
+        // Zero grain size picks one that gives few ranges per thread.
+        void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function);
+
+        [[nodiscard]] uint32_t GetWorkersCount() const { return workersCount; }
+
+        static uint32_t DefaultWorkersCount()
+        {
+            const uint32_t concurrency = Thread::HardwareConcurrency();
+            return concurrency > 1 ? concurrency - 1 : 0;
+        }
+
+    private:
+        struct alignas(64) Worker
+        {
+            WorkStealingDeque<Job*, DequeCapacity> deque;
+        };
+
+        void submit(Job* job);
+        void finish(JobCounter& counter);
+        bool tryGetJob(Job*& job);
+        void execute(Job* job);
+        void wake();
+        void workerLoop(uint32_t workerIndex);
+
+    private:
+        const uint32_t workersCount;
+        eastl::unique_ptr<Worker[]> workerQueues;
+        eastl::vector<Thread> workers;
+
+        SpinLock injectionLock;
+        eastl::deque<Job*> injectionQueue;
+
+        alignas(64) std::atomic<uint32_t> queuedCount = 0;
+        alignas(64) std::atomic<uint32_t> sleepingCount = 0;
+        bool stop = false;
+        Mutex wakeMutex;
+        std::condition_variable wakeCondition;
+    };
+}
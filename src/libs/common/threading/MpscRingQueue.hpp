@@ -0,0 +1,188 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+#include "common/threading/Parker.hpp"
+
+#include <EASTL/algorithm.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+namespace RR::Common::Threading
+{
+    // Bounded lock-free queue for any number of producers and a single consumer.
+    // Producers claim slots by advancing the shared tail, every slot carries a sequence number that tells
+    // whether it is free for the current lap or holds a published item, so consumer never waits on a lock.
+    template <typename T, std::size_t Capacity>
+    class MpscRingQueue final : public Common::NonCopyable
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static constexpr std::size_t Mask = Capacity - 1;
+
+    public:
+        MpscRingQueue()
+        {
+            for (std::size_t index = 0; index < Capacity; index++)
+                cells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+
+        // Note: The queue should not be accessed concurrently while it's
+        // being deleted. It's up to the user to synchronize this.
+        ~MpscRingQueue()
+        {
+            for (std::size_t position = head.load(std::memory_order_relaxed); hasItem(position); position++)
+                cells[position & Mask].get()->~T();
+        }
+
+        bool TryPush(const T& obj) { return TryEmplace(obj); }
+        bool TryPush(T&& obj) { return TryEmplace(std::move(obj)); }
+
+        void Push(const T& obj) { Emplace(obj); }
+        void Push(T&& obj) { Emplace(std::move(obj)); }
+
+        template <typename... Args>
+        bool TryEmplace(Args&&... args)
+        {
+            std::size_t tail;
+            if (!claim(tail, 1))
+                return false;
+
+            publish(tail, std::forward<Args>(args)...);
+            parker.Unpark();
+            return true;
+        }
+
+        // Spins while the queue is full.
+        template <typename... Args>
+        void Emplace(Args&&... args)
+        {
+            while (!TryEmplace(std::forward<Args>(args)...))
+                std::this_thread::yield();
+        }
+
+        // Pushes all items as a contiguous run or nothing at all.
+        bool TryPushBatch(T* items, std::size_t count)
+        {
+            ASSERT(count <= Capacity);
+            if (count == 0)
+                return true;
+
+            std::size_t tail;
+            if (!claim(tail, count))
+                return false;
+
+            for (std::size_t index = 0; index < count; index++)
+                publish(tail + index, std::move(items[index]));
+
+            parker.Unpark();
+            return true;
+        }
+
+        // Consumer only.
+        bool TryPop(T& out)
+        {
+            const std::size_t position = head.load(std::memory_order_relaxed);
+            if (!hasItem(position))
+                return false;
+
+            out = consume(position);
+            return true;
+        }
+
+        // Consumer only. Sleeps while the queue is empty.
+        T Pop()
+        {
+            const std::size_t position = head.load(std::memory_order_relaxed);
+            if (!hasItem(position))
+                parker.Park([this, position] { return hasItem(position); });
+
+            return consume(position);
+        }
+
+        // Consumer only. Pops up to maxCount items, returns how many were popped.
+        std::size_t TryPopBatch(T* out, std::size_t maxCount)
+        {
+            const std::size_t position = head.load(std::memory_order_relaxed);
+            std::size_t count = 0;
+            while (count < maxCount && hasItem(position + count))
+            {
+                out[count] = consume(position + count);
+                count++;
+            }
+
+            return count;
+        }
+
+        // Approximate when called concurrently with producers.
+        bool Empty() const { return Size() == 0; }
+        std::size_t Size() const
+        {
+            const std::size_t tailIndex = tail.load(std::memory_order_acquire);
+            const std::size_t headIndex = head.load(std::memory_order_relaxed);
+            return tailIndex > headIndex ? tailIndex - headIndex : 0;
+        }
+
+    private:
+        struct alignas(64) Cell
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        bool claim(std::size_t& position, std::size_t count)
+        {
+            position = tail.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                // Consumer frees cells in order, so the last cell of the run being free means the whole run is.
+                const std::size_t last = position + count - 1;
+                const std::size_t sequence = cells[last & Mask].sequence.load(std::memory_order_acquire);
+                const intptr_t difference = intptr_t(sequence) - intptr_t(last);
+
+                if (difference == 0)
+                {
+                    if (tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                        return true;
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        template <typename... Args>
+        void publish(std::size_t position, Args&&... args)
+        {
+            Cell& cell = cells[position & Mask];
+            new (cell.get()) T(std::forward<Args>(args)...);
+            cell.sequence.store(position + 1, std::memory_order_release);
+        }
+
+        bool hasItem(std::size_t position) const
+        {
+            return cells[position & Mask].sequence.load(std::memory_order_acquire) == position + 1;
+        }
+
+        T consume(std::size_t position)
+        {
+            Cell& cell = cells[position & Mask];
+            T temp = std::move(*cell.get());
+            cell.get()->~T();
+            cell.sequence.store(position + Capacity, std::memory_order_release);
+            head.store(position + 1, std::memory_order_relaxed);
+            return temp;
+        }
+
+    private:
+        alignas(64) std::atomic<std::size_t> tail = 0;
+        // Atomic only so Size can be read from producers, consumer is the only writer.
+        alignas(64) std::atomic<std::size_t> head = 0;
+        Parker parker;
+        Cell cells[Capacity];
+    };
+}
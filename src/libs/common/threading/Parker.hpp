@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
+
+namespace RR::Common::Threading
+{
+    // Lets a single consumer sleep until a condition becomes true.
+    // Waker only touches the mutex when consumer is actually parked, so the uncontended path is a fence and a load.
+    class Parker final : public Common::NonCopyable
+    {
+    public:
+        static constexpr uint32_t SpinCount = 64;
+
+        template <typename Predicate>
+        void Park(Predicate&& isReady)
+        {
+            for (uint32_t spin = 0; spin < SpinCount; spin++)
+            {
+                if (isReady())
+                    return;
+
+                std::this_thread::yield();
+            }
+
+            UniqueLock<Mutex> lock(mutex);
+            parked.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in Unpark: either waker sees parked flag or we see the published state.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            condition.wait(lock, isReady);
+            parked.store(false, std::memory_order_relaxed);
+        }
+
+        // Must be called after the state Park waits for is published.
+        void Unpark()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!parked.load(std::memory_order_relaxed))
+                return;
+
+            {
+                ReadWriteGuard<Mutex> lock(mutex);
+            }
+            condition.notify_one();
+        }
+
+    private:
+        std::atomic<bool> parked = false;
+        Mutex mutex;
+        std::condition_variable condition;
+    };
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+#include "common/threading/Parker.hpp"
+
+#include <EASTL/algorithm.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+namespace RR::Common::Threading
+{
+    // Bounded lock-free queue for exactly one producer and one consumer thread.
+    // Head and tail live on separate cache lines and each side caches the other's index,
+    // so the shared line is only read when the cached value says the queue is full or empty.
+    template <typename T, std::size_t Capacity>
+    class SpscRingQueue final : public Common::NonCopyable
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static constexpr std::size_t Mask = Capacity - 1;
+
+    public:
+        SpscRingQueue() = default;
+        // Note: The queue should not be accessed concurrently while it's
+        // being deleted. It's up to the user to synchronize this.
+        ~SpscRingQueue()
+        {
+            const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+            for (std::size_t head = consumer.head.load(std::memory_order_relaxed); head != tail; head++)
+                slot(head)->~T();
+        }
+
+        bool TryPush(const T& obj) { return TryEmplace(obj); }
+        bool TryPush(T&& obj) { return TryEmplace(std::move(obj)); }
+
+        void Push(const T& obj) { Emplace(obj); }
+        void Push(T&& obj) { Emplace(std::move(obj)); }
+
+        template <typename... Args>
+        bool TryEmplace(Args&&... args)
+        {
+            const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+            if (!hasFreeSlots(tail, 1))
+                return false;
+
+            new (slot(tail)) T(std::forward<Args>(args)...);
+            producer.tail.store(tail + 1, std::memory_order_release);
+            parker.Unpark();
+            return true;
+        }
+
+        // Spins while the queue is full.
+        template <typename... Args>
+        void Emplace(Args&&... args)
+        {
+            while (!TryEmplace(std::forward<Args>(args)...))
+                std::this_thread::yield();
+        }
+
+        // Pushes all items with a single publish or nothing at all.
+        bool TryPushBatch(T* items, std::size_t count)
+        {
+            ASSERT(count <= Capacity);
+            const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+            if (!hasFreeSlots(tail, count))
+                return false;
+
+            for (std::size_t index = 0; index < count; index++)
+                new (slot(tail + index)) T(std::move(items[index]));
+
+            producer.tail.store(tail + count, std::memory_order_release);
+            parker.Unpark();
+            return true;
+        }
+
+        bool TryPop(T& out)
+        {
+            const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+            if (!hasItems(head))
+                return false;
+
+            out = std::move(*slot(head));
+            slot(head)->~T();
+            consumer.head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Sleeps while the queue is empty.
+        T Pop()
+        {
+            const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+            if (!hasItems(head))
+                parker.Park([this, head] { return hasItems(head); });
+
+            T temp = std::move(*slot(head));
+            slot(head)->~T();
+            consumer.head.store(head + 1, std::memory_order_release);
+            return temp;
+        }
+
+        // Pops up to maxCount items, returns how many were popped.
+        std::size_t TryPopBatch(T* out, std::size_t maxCount)
+        {
+            const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+            if (!hasItems(head))
+                return 0;
+
+            const std::size_t count = eastl::min(maxCount, consumer.cachedTail - head);
+            for (std::size_t index = 0; index < count; index++)
+            {
+                out[index] = std::move(*slot(head + index));
+                slot(head + index)->~T();
+            }
+
+            consumer.head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        // Approximate when called concurrently with the other side.
+        bool Empty() const { return Size() == 0; }
+        std::size_t Size() const
+        {
+            const std::size_t head = consumer.head.load(std::memory_order_acquire);
+            return producer.tail.load(std::memory_order_acquire) - head;
+        }
+
+    private:
+        T* slot(std::size_t index) { return std::launder(reinterpret_cast<T*>(&storage[(index & Mask) * sizeof(T)])); }
+
+        bool hasFreeSlots(std::size_t tail, std::size_t count)
+        {
+            if (tail + count - producer.cachedHead <= Capacity)
+                return true;
+
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            return tail + count - producer.cachedHead <= Capacity;
+        }
+
+        bool hasItems(std::size_t head)
+        {
+            if (head != consumer.cachedTail)
+                return true;
+
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            return head != consumer.cachedTail;
+        }
+
+    private:
+        struct alignas(64) ProducerState
+        {
+            std::atomic<std::size_t> tail = 0;
+            std::size_t cachedHead = 0;
+        };
+
+        struct alignas(64) ConsumerState
+        {
+            std::atomic<std::size_t> head = 0;
+            std::size_t cachedTail = 0;
+        };
+
+        ProducerState producer;
+        ConsumerState consumer;
+        Parker parker;
+        alignas(64) alignas(T) std::byte storage[Capacity * sizeof(T)];
+    };
+}
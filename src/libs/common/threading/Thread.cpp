@@ -18,6 +18,9 @@ namespace RR::Common::Threading
         SetThreadDescription(static_cast<HANDLE>(GetNativeHandle()), wThreadName.c_str());
 #elif defined(OS_APPLE)
         pthread_setname_np(threadName.c_str());
+#elif defined(OS_LINUX)
+        // Linux limits thread name to 16 bytes including terminator.
+        pthread_setname_np(GetNativeHandle(), threadName.substr(0, 15).c_str());
 #else
         UNUSED(threadName);
         ASSERT_MSG(false, "Not implemented");
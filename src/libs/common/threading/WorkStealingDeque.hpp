@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace RR::Common::Threading
+{
+    // Bounded Chase-Lev deque.
+    // Owner thread pushes and pops at the bottom, any other thread steals from the top.
+    // Items are expected to be trivially copyable handles (pointers or indices).
+    template <typename T, size_t Capacity>
+    class WorkStealingDeque final : public Common::NonCopyable
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static constexpr int64_t Mask = int64_t(Capacity) - 1;
+
+    public:
+        WorkStealingDeque() = default;
+
+        // Owner only. Returns false when deque is full.
+        bool Push(T item)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_acquire);
+
+            if (b - t >= int64_t(Capacity))
+                return false;
+
+            items[b & Mask].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Owner only. Takes the most recently pushed item.
+        bool Pop(T& item)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            item = items[b & Mask].load(std::memory_order_relaxed);
+            if (t != b)
+                return true;
+
+            // Last item, race against thieves for it.
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        // Any thread. Takes the oldest item.
+        bool Steal(T& item)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return false;
+
+            item = items[t & Mask].load(std::memory_order_relaxed);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        // Approximate, only meaningful for the owner or when deque is quiescent.
+        [[nodiscard]] size_t GetSize() const
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_relaxed);
+            return b > t ? size_t(b - t) : 0;
+        }
+
+    private:
+        alignas(64) std::atomic<int64_t> top = 0;
+        alignas(64) std::atomic<int64_t> bottom = 0;
+        alignas(64) std::atomic<T> items[Capacity];
+    };
+}
@@ -3,6 +3,9 @@
 #include "ecs/EntityStorage.hpp"
 #include "ecs/World.hpp"
 
+#include <EASTL/algorithm.h>
+#include <cstring>
+
 namespace RR::Ecs
 {
     ArchetypeEntityIndex Archetype::Insert(EntityId entityId)
@@ -13,9 +16,10 @@ namespace RR::Ecs
         return index;
     }
 
-    ArchetypeEntityIndex Archetype::Mutate(EntityStorage& entityStorage, Archetype& from, ArchetypeEntityIndex fromIndex)
+    ArchetypeEntityIndex Archetype::Mutate(EntityStorage& entityStorage, Archetype& from, ArchetypeEntityIndex fromIndex, const ArchetypeEdge* edge)
     {
         ASSERT(&from != this);
+        ASSERT(!edge || edge->to == this);
 
         auto index = componentsData.Insert();
 
@@ -26,8 +30,7 @@ namespace RR::Ecs
            if (componentInfo.size == 0)
                 continue;
 
-           // TODO Could be faster find if we start from previous finded, to not iterate over same components id.
-           auto fromComponentIndex = from.GetComponentIndex(componentInfo.id);
+           const auto fromComponentIndex = edge ? edge->fromComponents[componentIndex] : from.GetComponentIndex(componentInfo.id);
 
            if (!fromComponentIndex)
                continue;
@@ -36,7 +39,12 @@ namespace RR::Ecs
            ComponentData src = from.componentsData.GetComponentData(fromComponentIndex, fromIndex);
            componentInfo.move(dst.data, src.data);
            if (componentInfo.isTrackable)
+           {
                componentInfo.move(dst.trackedData, src.trackedData);
+               // Pending change should follow the entity.
+               if (from.GetDirtyFlags(fromComponentIndex)[fromIndex.GetChunkIndex()])
+                   GetDirtyFlags(ArchetypeComponentIndex(componentIndex))[index.GetChunkIndex()] = 1;
+           }
         }
 
         entityStorage.Mutate(from.GetEntityIdData(fromIndex), *this, index);
@@ -68,7 +76,12 @@ namespace RR::Ecs
             {
                 componentInfo.move(removedData.data, lastIndexData.data);
                 if (componentInfo.isTrackable)
+                {
                     componentInfo.move(removedData.trackedData, lastIndexData.trackedData);
+                    // Pending change should follow the entity.
+                    uint8_t* dirtyFlags = GetDirtyFlags(ArchetypeComponentIndex(componentIndex));
+                    dirtyFlags[index.GetChunkIndex()] |= dirtyFlags[lastIndex.GetChunkIndex()];
+                }
             }
 
             if (componentInfo.destructor != nullptr)
@@ -79,7 +92,152 @@ namespace RR::Ecs
             }
         }
 
+        if (index != lastIndex)
+            componentsData.MarkChunkChanged(index.GetChunkIndex());
+
         componentsData.entitiesCount--;
+        componentsData.ReleaseEmptyChunk();
+    }
+
+    void Archetype::ResetTrackedChanges(ArchetypeEntityIndex begin, size_t count)
+    {
+        for (auto& trackedComponent : componentsData.trackedComponents)
+        {
+            const auto& componentInfo = *componentsData.componentsInfo[trackedComponent.columnIndex];
+            const auto& column = componentsData.columns[trackedComponent.columnIndex];
+            const auto& trackedColumn = componentsData.columns[trackedComponent.trackedColumnIndex];
+
+            size_t remaining = count;
+            for (size_t chunkIndex = begin.GetChunkIndex(), indexInChunk = begin.GetIndexInChunk(); remaining > 0; chunkIndex++, indexInChunk = 0)
+            {
+                const size_t chunkCount = eastl::min(componentsData.chunkCapacity - indexInChunk, remaining);
+                for (size_t index = indexInChunk; index < indexInChunk + chunkCount; index++)
+                {
+                    const size_t offset = index * column.size;
+                    componentInfo.compareAndAssign(trackedColumn.chunks[chunkIndex] + offset, column.chunks[chunkIndex] + offset);
+                }
+
+                remaining -= chunkCount;
+            }
+        }
+    }
+
+    void Archetype::CopyComponentsFrom(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex begin, size_t count, const std::byte* src)
+    {
+        ASSERT(componentIndex);
+
+        const auto& componentInfo = GetComponentInfo(componentIndex);
+        ASSERT(componentInfo.isTriviallyCopyable);
+        if (!componentInfo.size)
+            return;
+
+        const auto& column = componentsData.columns[componentIndex.GetRaw()];
+        for (size_t chunkIndex = begin.GetChunkIndex(), indexInChunk = begin.GetIndexInChunk(); count > 0; chunkIndex++, indexInChunk = 0)
+        {
+            const size_t chunkCount = eastl::min(componentsData.chunkCapacity - indexInChunk, count);
+            const size_t bytesCount = chunkCount * componentInfo.size;
+
+            std::memcpy(column.chunks[chunkIndex] + indexInChunk * componentInfo.size, src, bytesCount);
+            if (column.trackedColumnIndex != ComponentsData::InvalidColumnIndex)
+                std::memcpy(componentsData.columns[column.trackedColumnIndex].chunks[chunkIndex] + indexInChunk * componentInfo.size, src, bytesCount);
+
+            src += bytesCount;
+            count -= chunkCount;
+        }
+    }
+
+    void Archetype::FillComponents(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex begin, size_t count, const std::byte* src)
+    {
+        ASSERT(componentIndex);
+
+        const auto& componentInfo = GetComponentInfo(componentIndex);
+        ASSERT(componentInfo.isTriviallyCopyable || componentInfo.copy);
+        if (!componentInfo.size)
+            return;
+
+        const auto fill = [&componentInfo, src](std::byte* data, size_t count) {
+            const size_t size = componentInfo.size;
+            if (!componentInfo.isTriviallyCopyable)
+            {
+                for (size_t index = 0; index < count; index++)
+                    componentInfo.copy(data + index * size, const_cast<std::byte*>(src));
+                return;
+            }
+
+            // Filled part is copied over the rest, so the range takes log(count) copies.
+            std::memcpy(data, src, size);
+            for (size_t filled = 1; filled < count;)
+            {
+                const size_t copied = eastl::min(filled, count - filled);
+                std::memcpy(data + filled * size, data, copied * size);
+                filled += copied;
+            }
+        };
+
+        for (size_t chunkIndex = begin.GetChunkIndex(), indexInChunk = begin.GetIndexInChunk(); count > 0; chunkIndex++, indexInChunk = 0)
+        {
+            const size_t chunkCount = eastl::min(componentsData.chunkCapacity - indexInChunk, count);
+            const ComponentData componentData = componentsData.GetComponentData(componentIndex, ArchetypeEntityIndex(uint32_t(indexInChunk), uint32_t(chunkIndex)));
+
+            fill(componentData.data, chunkCount);
+            if (componentData.trackedData)
+                fill(componentData.trackedData, chunkCount);
+
+            count -= chunkCount;
+        }
+    }
+
+    void Archetype::WriteComponent(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex index, const std::byte* src)
+    {
+        const auto& componentInfo = GetComponentInfo(componentIndex);
+        ASSERT(componentInfo.isTriviallyCopyable);
+        if (!componentInfo.size)
+            return;
+
+        std::memcpy(componentsData.GetComponentData(componentIndex, index).data, src, componentInfo.size);
+        GetChangeVersions(componentIndex)[index.GetChunkIndex()] = componentsData.changeVersion;
+        if (componentInfo.isTrackable)
+            GetDirtyFlags(componentIndex)[index.GetChunkIndex()] = 1;
+    }
+
+    const ArchetypeEdge& Archetype::CreateEdge(EdgeType type, Meta::ComponentId componentId, Archetype& to)
+    {
+        ASSERT(&to != this);
+        ASSERT(!FindEdge(type, componentId));
+
+        auto edge = eastl::make_unique<ArchetypeEdge>();
+        edge->to = &to;
+        for (const auto* componentInfo : to.componentsData.componentsInfo)
+            edge->fromComponents.push_back(GetComponentIndex(componentInfo->id));
+
+        if (eastl::find(to.incomingEdges.begin(), to.incomingEdges.end(), this) == to.incomingEdges.end())
+            to.incomingEdges.push_back(this);
+
+        auto& edges = type == EdgeType::Add ? addEdges : removeEdges;
+        return *edges.emplace(componentId, eastl::move(edge)).first->second;
+    }
+
+    void Archetype::RemoveEdges()
+    {
+        for (Archetype* from : incomingEdges)
+        {
+            const auto pointsTo = [this](const auto& edge) { return edge.second->to == this; };
+            absl::erase_if(from->addEdges, pointsTo);
+            absl::erase_if(from->removeEdges, pointsTo);
+        }
+        incomingEdges.clear();
+
+        const auto unlink = [this](const EdgesMap& edges) {
+            for (const auto& [componentId, edge] : edges)
+            {
+                auto& incoming = edge->to->incomingEdges;
+                incoming.erase(eastl::remove(incoming.begin(), incoming.end(), this), incoming.end());
+            }
+        };
+        unlink(addEdges);
+        unlink(removeEdges);
+        addEdges.clear();
+        removeEdges.clear();
     }
 
     void Archetype::UpdateTrackedCache(SystemId systemId, Meta::SortedComponentsView components)
@@ -115,7 +273,6 @@ namespace RR::Ecs
         static thread_local eastl::vector<uint64_t> changedComponentsMasks;
         changedComponentsMasks.reserve(chunkCapacity);
 
-        // TODO it's could be optimized by adding dirty mask for chunks/columns.
         for (uint32_t chunkIndex = 0, entityOffset = 0; chunkIndex < chunksCount; chunkIndex++, entityOffset += uint32_t(chunkCapacity))
         {
             uint64_t changedChunkComponentsMask = 0;
@@ -124,6 +281,14 @@ namespace RR::Ecs
             if(entitiesInChunk == 0)
                 break;
 
+            // Only chunks accessed for write since last processing could have changes.
+            bool chunkDirty = false;
+            for (auto& trackedComponent : componentsData.trackedComponents)
+                chunkDirty |= componentsData.columns[trackedComponent.columnIndex].dirty[chunkIndex] != 0;
+
+            if (!chunkDirty)
+                continue;
+
             eastl::fill_n(changedComponentsMasks.data(), entitiesInChunk, 0);
 
             for (auto& trackedComponent : componentsData.trackedComponents)
@@ -132,6 +297,12 @@ namespace RR::Ecs
                 auto& column = componentsData.columns[trackedComponent.columnIndex];
                 auto& trackedColumn = componentsData.columns[trackedComponent.trackedColumnIndex];
 
+                if (!column.dirty[chunkIndex])
+                    continue;
+
+                // Cleared before dispatch, so writes made by tracking systems are detected on the next processing.
+                column.dirty[chunkIndex] = 0;
+
                 for (size_t indexInChunk = 0; indexInChunk < entitiesInChunk; indexInChunk++)
                 {
                     const size_t offset = indexInChunk * column.size;
@@ -140,6 +311,7 @@ namespace RR::Ecs
                         uint64_t mask = 1ULL << static_cast<uint64_t>(trackedComponent.trackedColumnIndex - componentsCount);
                         *(changedComponentsMasks.data() + indexInChunk) |= mask;
                         changedChunkComponentsMask |= mask;
+                        world.deltaJournal.Change(GetEntityIdData(ArchetypeEntityIndex(uint32_t(indexInChunk), chunkIndex)), componentInfo.id);
                     }
                 }
             }
@@ -160,9 +332,11 @@ namespace RR::Ecs
                     uint64_t changedComponentsMask = *(changedComponentsMasks.data() + indexInChunk);
                     if ((mask & changedComponentsMask) == 0)
                     {
-                        span.begin = span.end;
+                        if (span.begin != span.end)
+                            world.dispatchEventImmediately(span, systemId, event);
+
                         span.end = inc(span.end);
-                        world.dispatchEventImmediately(span, systemId, event);
+                        span.begin = span.end;
                         continue;
                     }
 
@@ -2,6 +2,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "ecs/ArchetypeEntityIndex.hpp"
+#include "ecs/ChunkPool.hpp"
 #include "ecs/meta/ComponentTraits.hpp"
 #include "ecs/meta/ElementsIterator.hpp"
 #include "ecs/ForwardDeclarations.hpp"
@@ -83,6 +84,14 @@ namespace RR::Ecs
         return ArchetypeId::FromValue(fnv1a(components));
     }
 
+    // Cached transition to the archetype with a single component added or removed.
+    struct ArchetypeEdge
+    {
+        Archetype* to;
+        // Index of the source column for every component of the target archetype, invalid for added ones.
+        eastl::fixed_vector<ArchetypeComponentIndex, 32> fromComponents;
+    };
+
     struct Archetype final
     {
     public:
@@ -92,15 +101,26 @@ namespace RR::Ecs
             std::byte* trackedData;
         };
 
+        enum class EdgeType : uint8_t
+        {
+            Add,
+            Remove
+        };
+
+        // Every column of non singleton archetype starts at cache line boundary,
+        // so chunk wide component arrays could be processed with aligned vector loads.
+        static constexpr size_t ColumnAlignment = ChunkPool::ChunkAlignment;
+        static_assert(ColumnAlignment >= 32, "Columns should be aligned at least for 256 bit vector loads.");
+
         class ComponentsData
         {
-            static constexpr size_t BaseChunkSize = 16 * 1024; // 16 kb
-            static constexpr size_t BaseChunkEntityCount = 100;
         public:
             template <typename Iterator>
-            ComponentsData(Iterator compInfoBegin, Iterator compInfoEnd)
+            ComponentsData(ChunkPool& chunkPool, const uint32_t& changeVersion, Iterator compInfoBegin, Iterator compInfoEnd)
+                : chunkPool(chunkPool), changeVersion(changeVersion)
             {
-                ASSERT(IsPowerOfTwo(BaseChunkSize));
+                const size_t baseChunkSize = chunkPool.GetDescription().baseChunkSize;
+                const size_t minEntitiesPerChunk = chunkPool.GetDescription().minEntitiesPerChunk;
 
                 size_t entitySizeBytes = 0;
                 size_t trackedComponentsCount = 0;
@@ -116,8 +136,8 @@ namespace RR::Ecs
                 }
                 ASSERT(componentsInfo[0]->id == Meta::GetComponentId<EntityId>);
 
-                size_t chunkSizeBytes = entitySizeBytes * BaseChunkEntityCount;
-                chunkSizeBytes = ((chunkSizeBytes / BaseChunkSize) + 1) * BaseChunkSize;
+                size_t chunkSizeBytes = entitySizeBytes * minEntitiesPerChunk;
+                chunkSizeBytes = ((chunkSizeBytes / baseChunkSize) + 1) * baseChunkSize;
                 chunkCapacity = !isSingleton ? chunkSizeBytes / entitySizeBytes : 1;
 
                 size_t realChunkSize = 0;
@@ -137,7 +157,8 @@ namespace RR::Ecs
                     {
                         const auto& componentInfo = *componentInfoPtr;
                         auto initColumn = [this, &offset, &componentInfo, &realChunkSize](size_t componentIndex) {
-                            offset = AlignTo(offset, componentInfo.alignment);
+                            // Singleton chunk holds single entity, so it's packed tightly.
+                            offset = AlignTo(offset, isSingleton ? componentInfo.alignment : eastl::max<size_t>(componentInfo.alignment, ColumnAlignment));
 
                             auto& column = columns[componentIndex];
                             ASSERT(offset < eastl::numeric_limits<decltype(column.offset)>::max());
@@ -183,6 +204,12 @@ namespace RR::Ecs
             }
 
             ~ComponentsData()
+            {
+                Clear();
+            }
+
+            // Destroys all components and returns chunks to the pool.
+            void Clear()
             {
                 auto destroyComponent = [this](const Meta::ComponentInfo& componentInfo, eastl::span<std::byte*> chunks) {
                     if (!componentInfo.destructor)
@@ -203,7 +230,19 @@ namespace RR::Ecs
                         destroyComponent(componentInfo, columns[columns[componentIndex].trackedColumnIndex].chunks);
                 }
 
+                for (auto* chunk : chunks)
+                    chunkPool.Free(chunk, chunkSize);
                 chunks.clear();
+
+                for (auto& column : columns)
+                {
+                    column.chunks.clear();
+                    column.dirty.clear();
+                    column.versions.clear();
+                }
+
+                totalCapacity = 0;
+                entitiesCount = 0;
             }
 
             ArchetypeComponentIndex GetComponentIndex(Meta::ComponentId componentId) const
@@ -228,6 +267,34 @@ namespace RR::Ecs
                 return columns[componentIndex.GetRaw()].chunks.data();
             }
 
+            uint8_t* GetDirtyFlags(ArchetypeComponentIndex componentIndex) const
+            {
+                ASSERT(componentIndex);
+                return columns[componentIndex.GetRaw()].dirty.data();
+            }
+
+            uint32_t* GetChangeVersions(ArchetypeComponentIndex componentIndex) const
+            {
+                ASSERT(componentIndex);
+                return columns[componentIndex.GetRaw()].versions.data();
+            }
+
+            template <typename Callback>
+            void ForEachChangeVersion(Callback&& callback) const
+            {
+                for (const auto& column : columns)
+                    for (auto& version : column.versions)
+                        callback(version);
+            }
+
+            // Entities of the chunk are replaced or added, so all its columns are changed.
+            void MarkChunkChanged(size_t chunkIndex)
+            {
+                ASSERT(chunkIndex < chunks.size());
+                for (auto& column : columns)
+                    column.versions[chunkIndex] = changeVersion;
+            }
+
             ComponentData GetComponentData(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex index) const
             {
                 ASSERT(componentIndex);
@@ -256,16 +323,61 @@ namespace RR::Ecs
                 ASSERT(!isSingleton || entitiesCount == 0);
 
                 if (entitiesCount == totalCapacity)
-                {
-                    totalCapacity += chunkCapacity;
-                    std::byte* chunk = chunks.emplace_back(new std::byte[chunkSize]).get();
+                    allocateChunk();
+
+                entitiesCount++;
+                const auto index = GetLastIndex();
+                MarkChunkChanged(index.GetChunkIndex());
+                return index;
+            }
 
-                    for (auto& column : columns)
-                        column.chunks.emplace_back(chunk + column.offset);
+            // Reserves whole chunks at once, returns index of the first inserted entity.
+            ArchetypeEntityIndex Insert(size_t count)
+            {
+                ASSERT(count > 0);
+                ASSERT(!isSingleton || (count == 1 && entitiesCount == 0));
+
+                const auto first = End();
+                while (entitiesCount + count > totalCapacity)
+                    allocateChunk();
+
+                entitiesCount += count;
+                for (size_t chunkIndex = first.GetChunkIndex(); chunkIndex <= GetLastIndex().GetChunkIndex(); chunkIndex++)
+                    MarkChunkChanged(chunkIndex);
+                return first;
+            }
+
+            // Returns chunk to the pool once the last entity leaves it.
+            void ReleaseEmptyChunk()
+            {
+                if (totalCapacity - entitiesCount < chunkCapacity)
+                    return;
+
+                totalCapacity -= chunkCapacity;
+                chunkPool.Free(chunks.back(), chunkSize);
+                chunks.pop_back();
+
+                for (auto& column : columns)
+                {
+                    column.chunks.pop_back();
+                    column.dirty.pop_back();
+                    column.versions.pop_back();
                 }
+            }
 
-                entitiesCount++;
-                return GetLastIndex();
+            // Releases all empty tail chunks and trims chunk lists grown by the peak entities count.
+            void Shrink()
+            {
+                while (totalCapacity - entitiesCount >= chunkCapacity && !chunks.empty())
+                    ReleaseEmptyChunk();
+
+                chunks.shrink_to_fit();
+                for (auto& column : columns)
+                {
+                    column.chunks.set_capacity(column.chunks.size());
+                    column.dirty.set_capacity(column.dirty.size());
+                    column.versions.set_capacity(column.versions.size());
+                }
             }
 
             ArchetypeEntityIndex GetLastIndex() const
@@ -280,9 +392,26 @@ namespace RR::Ecs
                 return ArchetypeEntityIndex(uint32_t(entitiesCount % chunkCapacity), uint32_t(entitiesCount / chunkCapacity));
             }
 
+        private:
+            void allocateChunk()
+            {
+                totalCapacity += chunkCapacity;
+                std::byte* chunk = chunks.emplace_back(chunkPool.Allocate(chunkSize));
+
+                for (auto& column : columns)
+                {
+                    column.chunks.emplace_back(chunk + column.offset);
+                    column.dirty.push_back(0);
+                    column.versions.push_back(changeVersion);
+                }
+            }
+
         private:
             friend struct Archetype;
 
+            ChunkPool& chunkPool;
+            // Current version of the world, stamped to chunks on structural changes.
+            const uint32_t& changeVersion;
             bool isSingleton = false;
 
             size_t chunkSize; // In bytes
@@ -299,6 +428,11 @@ namespace RR::Ecs
                 size_t size;
                 uint32_t offset;
                 eastl::fixed_vector<std::byte*, 16> chunks;
+                // Set for a chunk on non-const access to trackable component, cleared by ProcessTrackedChanges.
+                // One byte per chunk, so concurrent writers of different chunks or columns never share a flag.
+                mutable eastl::fixed_vector<uint8_t, 16> dirty;
+                // World version of the last write to the chunk by non-const access or structural change, see View::Changed.
+                mutable eastl::fixed_vector<uint32_t, 16> versions;
             };
 
             struct TrackedComponent
@@ -313,7 +447,7 @@ namespace RR::Ecs
             eastl::fixed_vector<TrackedComponent, 32> trackedComponents;
             eastl::fixed_vector<Column, 32> columns;
             eastl::fixed_vector<Meta::ElementInfo, 32> elementsInfo;
-            eastl::vector<eastl::unique_ptr<std::byte[]>> chunks;
+            eastl::vector<std::byte*> chunks;
         };
 
     private:
@@ -324,8 +458,8 @@ namespace RR::Ecs
     public:
         // Components info should be sorted
         template <typename Interator>
-        Archetype(Interator compInfoBegin, Interator compInfoEnd)
-            : componentsData(compInfoBegin, compInfoEnd)
+        Archetype(ChunkPool& chunkPool, const uint32_t& changeVersion, Interator compInfoBegin, Interator compInfoEnd)
+            : componentsData(chunkPool, changeVersion, compInfoBegin, compInfoEnd)
         {
         }
 
@@ -350,6 +484,25 @@ namespace RR::Ecs
             return componentsData.GetComponentsData(componentIndex);
         }
 
+        uint8_t* GetDirtyFlags(ArchetypeComponentIndex componentIndex) const
+        {
+            ASSERT(componentIndex);
+            return componentsData.GetDirtyFlags(componentIndex);
+        }
+
+        uint32_t* GetChangeVersions(ArchetypeComponentIndex componentIndex) const
+        {
+            ASSERT(componentIndex);
+            return componentsData.GetChangeVersions(componentIndex);
+        }
+
+        // Invokes callback with reference to the version of every chunk of every column, see World::checkChangeVersions.
+        template <typename Callback>
+        void ForEachChangeVersion(Callback&& callback) const { componentsData.ForEachChangeVersion(eastl::forward<Callback>(callback)); }
+
+        // Versions wrap around, so compared by distance. Zero version is never stamped, views with it have never run and see all chunks.
+        static bool IsSameOrNewerVersion(uint32_t version, uint32_t sinceVersion) { return sinceVersion == 0 || int32_t(version - sinceVersion) >= 0; }
+
         template <typename Component>
         ArchetypeComponentIndex GetComponentIndex() const
         {
@@ -396,8 +549,13 @@ namespace RR::Ecs
         }
 
         ArchetypeEntityIndex Insert(EntityId entityId);
-        ArchetypeEntityIndex Mutate(EntityStorage& entityStorage, Archetype& from, ArchetypeEntityIndex fromIndex);
+        // Inserts count entities at the end, entity ids and components should be filled by the caller.
+        ArchetypeEntityIndex InsertEntities(size_t count) { return componentsData.Insert(count); }
+        ArchetypeEntityIndex Mutate(EntityStorage& entityStorage, Archetype& from, ArchetypeEntityIndex fromIndex, const ArchetypeEdge* edge = nullptr);
         void Delete(EntityStorage& entityStorage, ArchetypeEntityIndex index, bool updateEntityRecord = true);
+        // Destroys all entities components, entity records should be updated by the caller.
+        void Clear() { componentsData.Clear(); }
+        void Shrink() { componentsData.Shrink(); }
 
         Meta::SortedComponentsView GetComponentsView() const { return Meta::SortedComponentsView(components()); }
         size_t GetEntitiesCount() const { return componentsData.entitiesCount; }
@@ -405,33 +563,87 @@ namespace RR::Ecs
         size_t GetChunkCapacity() const { return componentsData.chunkCapacity; }
         size_t GetChunkSize() const { return componentsData.chunkSize; }
         size_t GetEntitySize() const { return componentsData.entitySize; }
+        // Depth of entities in the hierarchy, 0 for roots and entities without parent.
+        uint32_t GetHierarchyDepth() const { return hierarchyDepth; }
+        // Number of query and system caches matched the archetype, such archetype is never dropped by compaction.
+        uint32_t GetCacheReferencesCount() const { return cacheReferencesCount; }
 
         template <typename Component, typename... Args>
         void ConstructComponent(ArchetypeEntityIndex index, ArchetypeComponentIndex componentIndex, Args&&... args)
         {
             if constexpr (Meta::IsTag<Component>)
-                return;
+                UNUSED(index, componentIndex, args...);
+            else
+            {
+                ComponentData componentData = componentsData.GetComponentData(componentIndex, index);
 
-            ComponentData componentData = componentsData.GetComponentData(componentIndex, index);
+                if constexpr (std::is_aggregate_v<Component>)
+                {
+                    new (componentData.data) Component {std::forward<Args>(args)...};
+                }
+                else
+                    new (componentData.data) Component(std::forward<Args>(args)...);
 
-            if constexpr (std::is_aggregate_v<Component>)
-            {
-                new (componentData.data) Component {std::forward<Args>(args)...};
+                if constexpr (Meta::IsTrackable<Component>)
+                {
+                    if constexpr (std::is_aggregate_v<Component>)
+                    {
+                        new (componentData.trackedData) Component {std::forward<Args>(args)...};
+                    }
+                    else
+                        new (componentData.trackedData) Component(std::forward<Args>(args)...);
+                }
             }
-            else
-                new (componentData.data) Component(std::forward<Args>(args)...);
+        }
 
-            if constexpr (Meta::IsTrackable<Component>)
+        // Default constructs component for the range of entities, column by column.
+        template <typename Component>
+        void ConstructComponents(ArchetypeEntityIndex begin, size_t count)
+        {
+            if constexpr (Meta::IsTag<Component>)
+                UNUSED(begin, count);
+            else
             {
-                if constexpr (std::is_aggregate_v<Component>)
+                auto construct = [](std::byte* data, size_t count) {
+                    for (Component *component = reinterpret_cast<Component*>(data), *end = component + count; component != end; ++component)
+                    {
+                        if constexpr (std::is_aggregate_v<Component>)
+                        {
+                            new (component) Component {};
+                        }
+                        else
+                            new (component) Component();
+                    }
+                };
+
+                const auto componentIndex = GetComponentIndex<Component>();
+                for (size_t chunkIndex = begin.GetChunkIndex(), indexInChunk = begin.GetIndexInChunk(); count > 0; chunkIndex++, indexInChunk = 0)
                 {
-                    new (componentData.trackedData) Component {std::forward<Args>(args)...};
+                    const size_t chunkCount = eastl::min(componentsData.chunkCapacity - indexInChunk, count);
+                    const ComponentData componentData = componentsData.GetComponentData(componentIndex, ArchetypeEntityIndex(uint32_t(indexInChunk), uint32_t(chunkIndex)));
+
+                    construct(componentData.data, chunkCount);
+                    if constexpr (Meta::IsTrackable<Component>)
+                        construct(componentData.trackedData, chunkCount);
+
+                    count -= chunkCount;
                 }
-                else
-                    new (componentData.trackedData) Component(std::forward<Args>(args)...);
             }
         }
 
+        // Copies trivially copyable components of the range from contiguous array chunk by chunk, tracked copies are filled as well.
+        void CopyComponentsFrom(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex begin, size_t count, const std::byte* src);
+
+        // Copies single value to the range of entities chunk by chunk, tracked copies are filled as well.
+        // Trivially copyable values are replicated with doubling memcpy, other ones are copy constructed.
+        void FillComponents(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex begin, size_t count, const std::byte* src);
+
+        // Overwrites trivially copyable component of entity. Tracked copy is kept, so the change is reported on the next processing.
+        void WriteComponent(ArchetypeComponentIndex componentIndex, ArchetypeEntityIndex index, const std::byte* src);
+
+        // Assigns tracked copies of components from actual values, so the range doesn't report changes.
+        void ResetTrackedChanges(ArchetypeEntityIndex begin, size_t count);
+
         void MoveComponentFrom(ArchetypeEntityIndex index, ArchetypeComponentIndex componentIndex, void* src)
         {
             const auto& componentInfo = GetComponentInfo(componentIndex);
@@ -452,9 +664,31 @@ namespace RR::Ecs
         void UpdateTrackedCache(SystemId systemId, Meta::SortedComponentsView components);
         void ProcessTrackedChanges(World& world);
 
+        [[nodiscard]] const ArchetypeEdge* FindEdge(EdgeType type, Meta::ComponentId componentId) const
+        {
+            const auto& edges = type == EdgeType::Add ? addEdges : removeEdges;
+            const auto it = edges.find(componentId);
+            return it != edges.end() ? it->second.get() : nullptr;
+        }
+        const ArchetypeEdge& CreateEdge(EdgeType type, Meta::ComponentId componentId, Archetype& to);
+        // Drops cached transitions from and to the archetype, which is about to be destroyed.
+        // Only archetypes linked with this one are visited.
+        void RemoveEdges();
+
     private:
+        using EdgesMap = absl::flat_hash_map<Meta::ComponentId, eastl::unique_ptr<ArchetypeEdge>, Ecs::DummyHasher<Meta::ComponentId>>;
+
         ComponentsData componentsData;
+        // Set by the world, as depth is defined by the tag component of the archetype.
+        uint32_t hierarchyDepth = 0;
+        // Caches hold archetypes by const pointer, so counter is updated through it as well.
+        mutable uint32_t cacheReferencesCount = 0;
         absl::flat_hash_map<EventId, eastl::fixed_vector<SystemId, 8>, Ecs::DummyHasher<EventId>> cache;
+        // Edges are referenced by deferred commands, so stored by pointer to survive rehash.
+        EdgesMap addEdges;
+        EdgesMap removeEdges;
+        // Archetypes with edges to this one.
+        eastl::vector<Archetype*> incomingEdges;
 
         struct TrackedSystem
         {
@@ -0,0 +1,99 @@
+#include "ArchetypeIndex.hpp"
+
+#include "ecs/Archetype.hpp"
+
+#include <EASTL/algorithm.h>
+
+namespace RR::Ecs
+{
+    void ArchetypeIndex::Add(Archetype& archetype)
+    {
+        const size_t index = archetypes.size();
+        archetypes.push_back(&archetype);
+        setBit(archetype, index, true);
+    }
+
+    void ArchetypeIndex::Remove(const Archetype& archetype)
+    {
+        const auto it = eastl::find(archetypes.begin(), archetypes.end(), &archetype);
+        ASSERT(it != archetypes.end());
+
+        const size_t index = size_t(eastl::distance(archetypes.begin(), it));
+        const size_t lastIndex = archetypes.size() - 1;
+        setBit(archetype, index, false);
+
+        if (index != lastIndex)
+        {
+            Archetype& last = *archetypes[lastIndex];
+            setBit(last, lastIndex, false);
+            setBit(last, index, true);
+            archetypes[index] = &last;
+        }
+
+        archetypes.pop_back();
+    }
+
+    void ArchetypeIndex::setBit(const Archetype& archetype, size_t index, bool value)
+    {
+        const size_t word = index / BitsPerWord;
+        const uint64_t bit = uint64_t(1) << (index % BitsPerWord);
+
+        for (const auto componentId : archetype.GetComponentsView())
+        {
+            Bitset& bitset = componentArchetypes[componentId];
+            if (bitset.size() <= word)
+                bitset.resize(word + 1, 0);
+
+            bitset[word] = value ? bitset[word] | bit : bitset[word] & ~bit;
+        }
+    }
+
+    bool ArchetypeIndex::Match(Meta::SortedComponentsView with, Meta::SortedComponentsView without, Bitset& matched) const
+    {
+        matched.clear();
+
+        if (with.begin() == with.end())
+        {
+            // Nothing is required, so every archetype is matched.
+            matched.resize((archetypes.size() + BitsPerWord - 1) / BitsPerWord, ~uint64_t(0));
+            if (archetypes.size() % BitsPerWord != 0)
+                matched.back() = (uint64_t(1) << (archetypes.size() % BitsPerWord)) - 1;
+        }
+        else
+        {
+            bool first = true;
+            for (const auto componentId : with)
+            {
+                const auto it = componentArchetypes.find(componentId);
+                if (it == componentArchetypes.end())
+                    return false;
+
+                const Bitset& bitset = it->second;
+                if (first)
+                {
+                    matched = bitset;
+                    first = false;
+                    continue;
+                }
+
+                matched.resize(eastl::min(matched.size(), bitset.size()));
+                for (size_t word = 0; word < matched.size(); word++)
+                    matched[word] &= bitset[word];
+            }
+        }
+
+        for (const auto componentId : without)
+        {
+            const auto it = componentArchetypes.find(componentId);
+            if (it == componentArchetypes.end())
+                continue;
+
+            const Bitset& bitset = it->second;
+            const size_t wordsCount = eastl::min(matched.size(), bitset.size());
+            for (size_t word = 0; word < wordsCount; word++)
+                matched[word] &= ~bitset[word];
+        }
+
+        return eastl::any_of(matched.begin(), matched.end(), [](uint64_t word) { return word != 0; });
+    }
+}
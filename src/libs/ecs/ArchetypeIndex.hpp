@@ -0,0 +1,66 @@
+#pragma once
+
+#include "absl/container/flat_hash_map.h"
+#include "ecs/ForwardDeclarations.hpp"
+#include "ecs/Hash.hpp"
+#include "ecs/meta/ComponentTraits.hpp"
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/vector.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace RR::Ecs
+{
+    // Inverted index from component to archetypes containing it. Archetypes are numbered in the order of addition
+    // and sets of archetypes are bitsets, so matching a view against all archetypes is a few bitset intersections.
+    class ArchetypeIndex final
+    {
+    public:
+        using Bitset = eastl::fixed_vector<uint64_t, 16>;
+        static constexpr size_t BitsPerWord = 64;
+
+        void Add(Archetype& archetype);
+        // Last archetype takes the place of removed one, so archetypes added afterwards are not in the order of addition.
+        void Remove(const Archetype& archetype);
+
+        // Archetypes with all components of with and none of without. Returns false if nothing is matched.
+        bool Match(Meta::SortedComponentsView with, Meta::SortedComponentsView without, Bitset& matched) const;
+
+        // Callback is invoked for every matched archetype in the order of addition.
+        template <typename Callback>
+        void ForEachMatched(Meta::SortedComponentsView with, Meta::SortedComponentsView without, Callback&& callback) const
+        {
+            Bitset matched;
+            if (!Match(with, without, matched))
+                return;
+
+            for (size_t word = 0; word < matched.size(); word++)
+                for (uint64_t bits = matched[word]; bits != 0; bits &= bits - 1)
+                    callback(*archetypes[word * BitsPerWord + countTrailingZeros(bits)]);
+        }
+
+        [[nodiscard]] const eastl::vector<Archetype*>& GetArchetypes() const { return archetypes; }
+
+    private:
+        void setBit(const Archetype& archetype, size_t index, bool value);
+
+        static uint32_t countTrailingZeros(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return index;
+#else
+            return __builtin_ctzll(value);
+#endif
+        }
+
+    private:
+        eastl::vector<Archetype*> archetypes;
+        // Words of a bitset past the last set bit are not stored.
+        absl::flat_hash_map<Meta::ComponentId, Bitset, DummyHasher<Meta::ComponentId>> componentArchetypes;
+    };
+}
@@ -0,0 +1,230 @@
+#include "ChunkPool.hpp"
+
+#ifdef OS_WINDOWS
+#include <windows.h>
+#elif defined(OS_APPLE) || defined(OS_LINUX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+#include <new>
+
+namespace
+{
+    size_t getPageSize()
+    {
+#ifdef OS_WINDOWS
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        return systemInfo.dwPageSize;
+#elif defined(OS_APPLE) || defined(OS_LINUX)
+        return size_t(sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+
+    // Returns page aligned memory, hugePages is reset if system refused to provide them.
+    std::byte* allocatePages(size_t size, bool& hugePages)
+    {
+#ifdef OS_WINDOWS
+        if (hugePages)
+        {
+            const size_t largePageSize = GetLargePageMinimum();
+            if (largePageSize != 0 && size % largePageSize == 0)
+            {
+                // Requires SeLockMemoryPrivilege, fails silently without it.
+                if (void* data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+                    return static_cast<std::byte*>(data);
+            }
+            hugePages = false;
+        }
+
+        return static_cast<std::byte*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#elif defined(OS_APPLE) || defined(OS_LINUX)
+    #if defined(OS_LINUX) && defined(MAP_HUGETLB)
+        if (hugePages)
+        {
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (data != MAP_FAILED)
+                return static_cast<std::byte*>(data);
+        }
+    #endif
+
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+            return nullptr;
+
+    #if defined(OS_LINUX) && defined(MADV_HUGEPAGE)
+        // Transparent huge pages are a hint only, so slab is accounted as regular pages.
+        if (hugePages)
+            madvise(data, size, MADV_HUGEPAGE);
+    #endif
+        hugePages = false;
+        return static_cast<std::byte*>(data);
+#else
+        hugePages = false;
+        return static_cast<std::byte*>(::operator new(size, std::align_val_t(getPageSize())));
+#endif
+    }
+
+    void freePages(std::byte* data, size_t size)
+    {
+#ifdef OS_WINDOWS
+        UNUSED(size);
+        VirtualFree(data, 0, MEM_RELEASE);
+#elif defined(OS_APPLE) || defined(OS_LINUX)
+        munmap(data, size);
+#else
+        ::operator delete(data, size, std::align_val_t(getPageSize()));
+#endif
+    }
+}
+
+namespace RR::Ecs
+{
+    ChunkPool::ChunkPool(const ChunkPoolDescription& description)
+        : description(description), pageSize(getPageSize())
+    {
+        ASSERT(IsPowerOfTwo(description.baseChunkSize));
+        ASSERT(description.minEntitiesPerChunk > 0);
+        ASSERT(description.slabSize > 0);
+    }
+
+    ChunkPool::~ChunkPool()
+    {
+#ifdef ENABLE_ASSERTS
+        for (const auto& sizeClass : sizeClasses)
+            ASSERT_MSG(sizeClass.usedChunks == 0, "Chunks should be returned to the pool before destruction.");
+#endif
+
+        for (const auto& slab : slabs)
+            freePages(slab.data, slab.size);
+    }
+
+    std::byte* ChunkPool::Allocate(size_t chunkSize)
+    {
+        ASSERT(chunkSize > 0);
+
+        SizeClass& sizeClass = getSizeClass(chunkSize);
+        if (sizeClass.freeChunks.empty())
+            allocateSlab(sizeClass);
+
+        std::byte* chunk = sizeClass.freeChunks.back();
+        sizeClass.freeChunks.pop_back();
+        sizeClass.usedChunks++;
+
+        ASSERT(IsAlignedTo(chunk, ChunkAlignment));
+        return chunk;
+    }
+
+    void ChunkPool::Free(std::byte* chunk, size_t chunkSize)
+    {
+        ASSERT(chunk);
+
+        SizeClass& sizeClass = getSizeClass(chunkSize);
+        ASSERT(sizeClass.usedChunks > 0);
+
+        sizeClass.usedChunks--;
+        sizeClass.freeChunks.push_back(chunk);
+    }
+
+    size_t ChunkPool::Trim()
+    {
+        size_t releasedBytes = 0;
+
+        for (auto& sizeClass : sizeClasses)
+        {
+            if (sizeClass.freeChunks.empty())
+                continue;
+
+            // Sorted, so free chunks of a slab form a contiguous range.
+            auto& freeChunks = sizeClass.freeChunks;
+            eastl::sort(freeChunks.begin(), freeChunks.end());
+
+            for (auto slab = slabs.begin(); slab != slabs.end();)
+            {
+                if (slab->chunkSize != sizeClass.chunkSize)
+                {
+                    ++slab;
+                    continue;
+                }
+
+                const auto first = eastl::lower_bound(freeChunks.begin(), freeChunks.end(), slab->data);
+                const auto last = eastl::lower_bound(first, freeChunks.end(), slab->data + slab->size);
+                if (size_t(eastl::distance(first, last)) != slab->size / slab->chunkSize)
+                {
+                    ++slab;
+                    continue;
+                }
+
+                freeChunks.erase(first, last);
+                freePages(slab->data, slab->size);
+                releasedBytes += slab->size;
+                slab = slabs.erase(slab);
+            }
+
+            // Reversed, so chunks are handed out in address order.
+            eastl::reverse(freeChunks.begin(), freeChunks.end());
+            freeChunks.shrink_to_fit();
+        }
+
+        return releasedBytes;
+    }
+
+    ChunkPoolStats ChunkPool::GetStats() const
+    {
+        ChunkPoolStats stats;
+        stats.slabsCount = slabs.size();
+
+        for (const auto& slab : slabs)
+        {
+            stats.reservedBytes += slab.size;
+            stats.hugePageSlabsCount += slab.hugePages ? 1 : 0;
+        }
+
+        for (const auto& sizeClass : sizeClasses)
+        {
+            stats.usedChunks += sizeClass.usedChunks;
+            stats.freeChunks += sizeClass.freeChunks.size();
+        }
+
+        stats.pooledChunks = stats.usedChunks + stats.freeChunks;
+        return stats;
+    }
+
+    ChunkPool::SizeClass& ChunkPool::getSizeClass(size_t chunkSize)
+    {
+        chunkSize = AlignTo(chunkSize, ChunkAlignment);
+
+        // Only a handful of distinct chunk sizes is expected, so linear search is fine.
+        auto it = eastl::find_if(sizeClasses.begin(), sizeClasses.end(), [chunkSize](const SizeClass& sizeClass) { return sizeClass.chunkSize == chunkSize; });
+        if (it != sizeClasses.end())
+            return *it;
+
+        SizeClass& sizeClass = sizeClasses.emplace_back();
+        sizeClass.chunkSize = chunkSize;
+        return sizeClass;
+    }
+
+    void ChunkPool::allocateSlab(SizeClass& sizeClass)
+    {
+        const size_t slabSize = AlignTo(eastl::max(description.slabSize, sizeClass.chunkSize), pageSize);
+
+        bool hugePages = description.useHugePages;
+        std::byte* data = allocatePages(slabSize, hugePages);
+        if UNLIKELY (!data)
+            throw std::bad_alloc();
+
+        slabs.push_back({data, slabSize, sizeClass.chunkSize, hugePages});
+
+        const size_t chunksCount = slabSize / sizeClass.chunkSize;
+        sizeClass.freeChunks.reserve(sizeClass.freeChunks.size() + chunksCount);
+
+        // Reversed, so chunks are handed out in address order.
+        for (size_t index = chunksCount; index > 0; index--)
+            sizeClass.freeChunks.push_back(data + (index - 1) * sizeClass.chunkSize);
+    }
+}
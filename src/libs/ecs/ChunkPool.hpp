@@ -0,0 +1,79 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/vector.h>
+#include <cstddef>
+
+namespace RR::Ecs
+{
+    struct ChunkPoolDescription
+    {
+        // Archetype chunk size is a multiple of base chunk size, which fits at least minEntitiesPerChunk entities.
+        size_t baseChunkSize = 16 * 1024; // 16 kb
+        size_t minEntitiesPerChunk = 100;
+        // Chunks are carved from page aligned slabs, chunks bigger than slab get own slab.
+        size_t slabSize = 2 * 1024 * 1024; // 2 mb
+        // Falls back to regular pages if system doesn't provide huge pages.
+        bool useHugePages = false;
+    };
+
+    struct ChunkPoolStats
+    {
+        size_t slabsCount = 0;
+        size_t hugePageSlabsCount = 0;
+        size_t reservedBytes = 0;
+        // Pooled chunks are all chunks carved from slabs, it's used plus free.
+        size_t pooledChunks = 0;
+        size_t usedChunks = 0;
+        size_t freeChunks = 0;
+    };
+
+    // World wide storage of archetype chunks. Chunks of the same size are recycled through a free list,
+    // memory goes back to the system by Trim or on pool destruction.
+    // Not thread safe, chunks are allocated and freed only by structural changes on the world thread.
+    class ChunkPool final : public Common::NonCopyable
+    {
+    public:
+        explicit ChunkPool(const ChunkPoolDescription& description);
+        ~ChunkPool();
+
+        // Throws std::bad_alloc, if a new slab can't be allocated.
+        [[nodiscard]] std::byte* Allocate(size_t chunkSize);
+        void Free(std::byte* chunk, size_t chunkSize);
+        // Returns slabs with all chunks free to the system, returns number of released bytes.
+        size_t Trim();
+
+        [[nodiscard]] const ChunkPoolDescription& GetDescription() const { return description; }
+        [[nodiscard]] ChunkPoolStats GetStats() const;
+
+        // Chunks are aligned at least to cache line.
+        static constexpr size_t ChunkAlignment = 64;
+
+    private:
+        struct Slab
+        {
+            std::byte* data;
+            size_t size;
+            size_t chunkSize;
+            bool hugePages;
+        };
+
+        struct SizeClass
+        {
+            size_t chunkSize;
+            size_t usedChunks = 0;
+            eastl::vector<std::byte*> freeChunks;
+        };
+
+        SizeClass& getSizeClass(size_t chunkSize);
+        void allocateSlab(SizeClass& sizeClass);
+
+    private:
+        ChunkPoolDescription description;
+        size_t pageSize;
+        eastl::vector<Slab> slabs;
+        eastl::fixed_vector<SizeClass, 16> sizeClasses;
+    };
+}
@@ -3,6 +3,8 @@
 #include "ecs/World.hpp"
 #include "ecs/meta/ComponentTraits.hpp"
 
+#include <EASTL/algorithm.h>
+
 namespace RR::Ecs
 {
     struct DestroyEntityCommand final : public Command
@@ -21,10 +23,28 @@ namespace RR::Ecs
         Archetype* archetype;
     };
 
-    MutateEntityCommand& CommandBuffer::makeMutateCommand(EntityId entity, Archetype* from, Archetype& to, Meta::UnsortedComponentsView addedComponents)
+    struct InitCacheForSystemCommand final : public Command
+    {
+        InitCacheForSystemCommand(SystemId systemId)
+            : Command(CommandType::InitCacheForSystem),
+              systemId(systemId) { };
+        SystemId systemId;
+    };
+
+    struct SetParentCommand final : public Command
+    {
+        SetParentCommand(EntityId entityId, EntityId parent)
+            : Command(CommandType::SetParent),
+              entityId(entityId),
+              parent(parent) { };
+        EntityId entityId;
+        EntityId parent;
+    };
+
+    MutateEntityCommand& CommandBuffer::makeMutateCommand(EntityId entity, Archetype* from, Archetype& to, const ArchetypeEdge* edge, Meta::UnsortedComponentsView addedComponents)
     {
         MutateEntityCommand& command = *allocator.create<MutateEntityCommand>(
-            entity, from, to);
+            entity, from, to, edge);
 
         auto componentsIndices = allocate<ArchetypeComponentIndex>(addedComponents.size());
         {
@@ -37,12 +57,30 @@ namespace RR::Ecs
         return command;
     }
 
+    void CommandBuffer::RemoveSparse(EntityId entity, Meta::ComponentId componentId)
+    {
+        ASSERT(entity);
+        ASSERT(!inProcess);
+
+        auto& command = *allocator.create<MutateSparseCommand>(entity, componentId, nullptr, true);
+        push(command);
+    }
+
+    void CommandBuffer::SetParent(EntityId entity, EntityId parent)
+    {
+        ASSERT(entity);
+        ASSERT(!inProcess);
+
+        auto& command = *allocator.create<SetParentCommand>(entity, parent);
+        push(command);
+    }
+
     void CommandBuffer::Destroy(EntityId entity)
     {
         ASSERT(!inProcess);
 
         auto& command = *allocator.create<DestroyEntityCommand>(entity);
-        commands.push_back(&command);
+        push(command);
     }
 
     void CommandBuffer::InitCache(Archetype& archetype)
@@ -50,7 +88,43 @@ namespace RR::Ecs
         ASSERT(!inProcess);
 
         auto& command = *allocator.create<InitCacheForArchetypeCommand>(archetype);
-        commands.push_back(&command);
+        push(command);
+    }
+
+    void CommandBuffer::InitCache(SystemId systemId)
+    {
+        ASSERT(!inProcess);
+
+        auto& command = *allocator.create<InitCacheForSystemCommand>(systemId);
+        push(command);
+    }
+
+    void CommandBuffer::Merge(CommandBuffer& other)
+    {
+        ASSERT(!inProcess);
+        ASSERT(&other != this);
+        ASSERT(other.mergedBuffers.empty());
+
+        if (other.commands.empty())
+            return;
+
+        commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+        recordedOnThread += other.commands.size();
+        other.commands.clear();
+
+        // Other buffer could be filled and merged again before commands are processed, its memory stays valid until reset.
+        if (eastl::find(mergedBuffers.begin(), mergedBuffers.end(), &other) == mergedBuffers.end())
+            mergedBuffers.push_back(&other);
+    }
+
+    void CommandBuffer::reset()
+    {
+        allocator.reset();
+        commands.clear();
+
+        for (auto* mergedBuffer : mergedBuffers)
+            mergedBuffer->reset();
+        mergedBuffers.clear();
     }
 
     struct CommmandProcessors
@@ -63,7 +137,7 @@ namespace RR::Ecs
             ASSERT(resolved);
             UNUSED(resolved);
             ASSERT(record.GetArchetype(false) == command.from);
-            world.mutateEntity(command.entityId, record.GetArchetype(false), record.GetIndex(false), *command.to, [&](Archetype& archetype, ArchetypeEntityIndex entityIndex) {
+            world.mutateEntity(command.entityId, record.GetArchetype(false), record.GetIndex(false), *command.to, command.edge, [&](Archetype& archetype, ArchetypeEntityIndex entityIndex) {
                 ASSERT(command.componentsIndices.size() == command.componentsData.size());
 
                 auto componentIndex = command.componentsIndices.begin();
@@ -82,6 +156,36 @@ namespace RR::Ecs
         {
             world.initCache(*command.archetype);
         }
+
+        static void process(InitCacheForSystemCommand& command, World& world)
+        {
+            world.initCache(command.systemId);
+        }
+
+        static void process(MutateSparseCommand& command, World& world)
+        {
+            if (command.remove)
+            {
+                if (world.IsAlive(command.entityId))
+                    world.removeSparseComponent(command.entityId, command.componentId);
+                return;
+            }
+
+            if (world.IsAlive(command.entityId))
+            {
+                world.addSparseComponent(command.entityId, command.componentId, command.data);
+                return;
+            }
+
+            const auto& componentInfo = world.metaStorage[command.componentId];
+            if (command.data && componentInfo.destructor)
+                componentInfo.destructor(command.data);
+        }
+
+        static void process(SetParentCommand& command, World& world)
+        {
+            world.setParentImpl(command.entityId, command.parent);
+        }
     };
 
     void CommandBuffer::ProcessCommands(World& world)
@@ -121,6 +225,9 @@ namespace RR::Ecs
                 PROCESS_COMMAND(MutateEntity)
                 PROCESS_COMMAND(DestroyEntity)
                 PROCESS_COMMAND(InitCacheForArchetype)
+                PROCESS_COMMAND(InitCacheForSystem)
+                PROCESS_COMMAND(MutateSparse)
+                PROCESS_COMMAND(SetParent)
             default:
                 ASSERT_MSG(false, "Unknown command type");
             }
@@ -129,8 +236,7 @@ namespace RR::Ecs
         #undef PROCESS_COMMAND
 
         inProcess = false;
-        allocator.reset();
-        commands.clear();
+        reset();
     }
 }
 
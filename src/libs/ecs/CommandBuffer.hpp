@@ -6,6 +6,7 @@
 
 #include "common/ChunkAllocator.hpp"
 
+#include "EASTL/fixed_vector.h"
 #include "EASTL/span.h"
 
 namespace RR::Ecs
@@ -22,18 +23,22 @@ namespace RR::Ecs
     {
         MutateEntity,
         DestroyEntity,
-        InitCacheForArchetype
+        InitCacheForArchetype,
+        InitCacheForSystem,
+        MutateSparse,
+        SetParent
     };
 
     struct MutateEntityCommand final : public Command
     {
-        MutateEntityCommand(EntityId entityId, Archetype* from, Archetype& to)
+        MutateEntityCommand(EntityId entityId, Archetype* from, Archetype& to, const ArchetypeEdge* edge)
             : Command(CommandType::MutateEntity),
               entityId(entityId),
 #ifdef ENABLE_ASSERTS
               from(from),
 #endif
-              to(&to) {
+              to(&to),
+              edge(edge) {
                   UNUSED(from);
               };
         EntityId entityId;
@@ -41,17 +46,39 @@ namespace RR::Ecs
         Archetype* from;
 #endif
         Archetype* to;
+        const ArchetypeEdge* edge;
         eastl::span<ArchetypeComponentIndex> componentsIndices;
         eastl::span<void*> componentsData;
     };
 
+    struct MutateSparseCommand final : public Command
+    {
+        MutateSparseCommand(EntityId entityId, Meta::ComponentId componentId, void* data, bool remove)
+            : Command(CommandType::MutateSparse),
+              entityId(entityId),
+              componentId(componentId),
+              data(data),
+              remove(remove) { };
+        EntityId entityId;
+        Meta::ComponentId componentId;
+        // Constructed component to add, nullptr for tags and removal.
+        void* data;
+        bool remove;
+    };
+
     struct CommandBuffer final
     {
         private:
             static constexpr size_t InitialCommandQueueSize = 1024*1024;
 
         private:
-            MutateEntityCommand& makeMutateCommand(EntityId entity, Archetype* from, Archetype& to, Meta::UnsortedComponentsView addedComponents);
+            void push(Command& command)
+            {
+                commands.push_back(&command);
+                recordedOnThread++;
+            }
+
+            MutateEntityCommand& makeMutateCommand(EntityId entity, Archetype* from, Archetype& to, const ArchetypeEdge* edge, Meta::UnsortedComponentsView addedComponents);
 
             template <typename T>
             T* allocate(size_t count)
@@ -78,18 +105,21 @@ namespace RR::Ecs
             }
 
         public:
-            CommandBuffer() : allocator(InitialCommandQueueSize) { }
+            explicit CommandBuffer(size_t initialSize = InitialCommandQueueSize) : allocator(initialSize) { }
 
             void ProcessCommands(World& world);
+            // Moves commands of other buffer to the end of this one.
+            // Other buffer memory is kept until commands are processed, then it's reset as well.
+            void Merge(CommandBuffer& other);
 
             template <typename Components, typename ArgsTuple, size_t... Index>
-            void Mutate(EntityId entity, Archetype* from, Archetype& to, ArgsTuple&& args, eastl::index_sequence<Index...>)
+            void Mutate(EntityId entity, Archetype* from, Archetype& to, const ArchetypeEdge* edge, ArgsTuple&& args, eastl::index_sequence<Index...>)
             {
                 ASSERT(entity);
                 ASSERT(!inProcess);
 
                 const eastl::array<Meta::ComponentId, Components::Count> componentIds = {Meta::GetComponentId<typename Components::template Get<Index>>...};
-                auto& command = makeMutateCommand(entity, from, to, Meta::UnsortedComponentsView(componentIds));
+                auto& command = makeMutateCommand(entity, from, to, edge, Meta::UnsortedComponentsView(componentIds));
 
                 void** componentsPtrs = allocate<void*>(Components::Count);
                 (void( *(componentsPtrs + Index) = constructComponent<typename Components::template Get<Index>>(
@@ -97,15 +127,39 @@ namespace RR::Ecs
                 ), ...);
 
                 command.componentsData = {componentsPtrs, Components::Count};
-                commands.push_back(&command);
+                push(command);
             }
 
+            template <typename Component, typename ArgsTuple>
+            void AddSparse(EntityId entity, ArgsTuple&& args)
+            {
+                ASSERT(entity);
+                ASSERT(!inProcess);
+
+                void* data = constructComponent<Component>(eastl::forward<ArgsTuple>(args));
+                auto& command = *allocator.create<MutateSparseCommand>(entity, Meta::GetComponentId<Component>, data, false);
+                push(command);
+            }
+
+            void RemoveSparse(EntityId entity, Meta::ComponentId componentId);
+            void SetParent(EntityId entity, EntityId parent);
             void Destroy(EntityId entity);
             void InitCache(Archetype& archetype);
+            void InitCache(SystemId systemId);
+
+            [[nodiscard]] size_t GetCommandsCount() const { return commands.size(); }
+            // Commands recorded by the calling thread to any buffer, so commands could be attributed to the code running on it.
+            // Merged commands are counted again by the merging thread, as parallel tasks record them on behalf of the dispatching one.
+            [[nodiscard]] static uint64_t GetRecordedOnThread() { return recordedOnThread; }
+
+        private:
+            void reset();
 
         private:
             bool inProcess = false;
             Common::ChunkAllocator allocator;
             eastl::vector<Command*> commands;
+            eastl::fixed_vector<CommandBuffer*, 16> mergedBuffers;
+            static inline thread_local uint64_t recordedOnThread = 0;
     };
 }
@@ -0,0 +1,53 @@
+#include "World.hpp"
+
+namespace RR::Ecs
+{
+    bool World::Compact(std::chrono::nanoseconds budget)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT(!IsLocked());
+
+        const auto start = ProfileClock::now();
+
+        if (compactionQueue.empty())
+        {
+            compactionCursor = 0;
+            compactionQueue.reserve(archetypesMap.size());
+            for (const auto& [archetypeId, archetype] : archetypesMap)
+                compactionQueue.push_back(archetypeId);
+        }
+
+        // At least one archetype is processed per call, so the pass always makes progress.
+        while (compactionCursor < compactionQueue.size())
+        {
+            const ArchetypeId archetypeId = compactionQueue[compactionCursor++];
+            const auto it = archetypesMap.find(archetypeId);
+            if (it != archetypesMap.end())
+                compactArchetype(archetypeId, *it->second);
+
+            if (ProfileClock::now() - start >= budget)
+                return false;
+        }
+
+        chunkPool.Trim();
+        compactionQueue.clear();
+        compactionCursor = 0;
+        return true;
+    }
+
+    void World::compactArchetype(ArchetypeId archetypeId, Archetype& archetype)
+    {
+        archetype.Shrink();
+
+        // Archetypes matched by caches are kept, as caches are never rebuilt.
+        if (archetype.GetEntitiesCount() > 0 || archetype.GetCacheReferencesCount() > 0)
+            return;
+
+        // Prefabs are not indexed.
+        if (!archetype.GetComponentIndex<Prefab>())
+            archetypeIndex.Remove(archetype);
+
+        archetype.RemoveEdges();
+        archetypesMap.erase(archetypeId);
+    }
+}
@@ -0,0 +1,379 @@
+#include "World.hpp"
+#include "ecs/Serialization.hpp"
+
+#include <EASTL/sort.h>
+
+namespace
+{
+    using namespace RR::Ecs;
+    using namespace RR::Ecs::details;
+
+    // Layout: header, components table, destroyed entities, replicated entities, changed components.
+    // Replicated entity is written with all its components, except entity id, including sparse ones.
+    constexpr uint32_t DeltaMagic = 0x44434552; // RECD
+    constexpr uint32_t DeltaVersion = 1;
+
+    struct DeltaHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t componentsCount;
+        uint32_t destroyedCount;
+        uint32_t replicatedCount;
+        uint32_t changedCount;
+    };
+
+    struct DeltaEntity
+    {
+        EntityId entityId;
+        uint32_t componentsCount;
+    };
+
+    struct DeltaChange
+    {
+        EntityId entityId;
+        uint32_t componentIndex;
+    };
+
+    template <typename T, typename Less>
+    void sortUnique(eastl::vector<T>& values, Less&& less)
+    {
+        eastl::sort(values.begin(), values.end(), less);
+        values.erase(eastl::unique(values.begin(), values.end(), [&less](const T& a, const T& b) { return !less(a, b) && !less(b, a); }), values.end());
+    }
+
+    bool lessEntity(EntityId a, EntityId b) { return a.GetRaw() < b.GetRaw(); }
+}
+
+namespace RR::Ecs
+{
+    void World::EnableDeltaCapture(bool enable)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        deltaJournal.enabled = enable;
+        deltaJournal.Clear();
+    }
+
+    bool World::CaptureDelta(eastl::vector<std::byte>& buffer)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ECS_VERIFY(!IsLocked(), "Delta can't be captured while world is locked.");
+        ECS_VERIFY(deltaJournal.enabled, "Delta capture should be enabled first.");
+
+        // Changes made by OnChange subscribers are recorded as well.
+        ProcessTrackedChanges();
+
+        sortUnique(deltaJournal.touched, lessEntity);
+        sortUnique(deltaJournal.destroyed, lessEntity);
+        sortUnique(deltaJournal.changed, [](const auto& a, const auto& b) {
+            return a.first.GetRaw() < b.first.GetRaw() || (a.first == b.first && a.second < b.second);
+        });
+
+        struct Replicated
+        {
+            EntityId entityId;
+            const Archetype* archetype;
+            ArchetypeEntityIndex index;
+            eastl::fixed_vector<const SparseSet*, 8> sparseSets;
+        };
+
+        // Stale ids belong to destroyed entities.
+        eastl::vector<Replicated> replicated;
+        Meta::ComponentsSet components;
+        for (const auto entityId : deltaJournal.touched)
+        {
+            EntityRecord record;
+            if (!entityStorage.Get(entityId, record) || !record.GetArchetype(false) || IsRuntimeArchetype(*record.GetArchetype(false)))
+                continue;
+
+            Replicated& entity = replicated.emplace_back();
+            entity.entityId = entityId;
+            entity.archetype = record.GetArchetype(false);
+            entity.index = record.GetIndex(false);
+
+            for (const auto& [componentId, sparseSet] : sparseSets)
+                if (sparseSet->Has(entityId))
+                    entity.sparseSets.push_back(sparseSet.get());
+
+            for (uint8_t index = 1; index < entity.archetype->GetComponentsView().size(); index++)
+                components.insert(entity.archetype->GetComponentInfo(ArchetypeComponentIndex(index)).id);
+            for (const auto* sparseSet : entity.sparseSets)
+                components.insert(sparseSet->GetComponentInfo().id);
+        }
+
+        // Replicated entities already carry all components.
+        eastl::vector<eastl::pair<EntityId, Meta::ComponentId>> changed;
+        for (const auto& change : deltaJournal.changed)
+        {
+            const auto it = eastl::lower_bound(replicated.begin(), replicated.end(), change.first, [](const Replicated& entity, EntityId entityId) {
+                return lessEntity(entity.entityId, entityId);
+            });
+            if (it != replicated.end() && it->entityId == change.first)
+                continue;
+
+            EntityRecord record;
+            if (!entityStorage.Get(change.first, record) || !record.GetArchetype(false) || !record.GetArchetype(false)->GetComponentIndex(change.second))
+                continue;
+
+            changed.push_back(change);
+            components.insert(change.second);
+        }
+
+        // Values are written as raw bytes, so the capture fails in any build and the journal is kept for the next one.
+        bool triviallyCopyable = true;
+        for (const auto componentId : components)
+        {
+            const auto& componentInfo = *metaStorage.find(componentId)->second;
+            if (!componentInfo.isTriviallyCopyable)
+            {
+                Log::Format::Error("Component {} is not trivially copyable and can't be captured to delta.", componentInfo.name);
+                triviallyCopyable = false;
+            }
+        }
+
+        if (!triviallyCopyable)
+            return false;
+
+        const auto getComponentIndex = [&components](Meta::ComponentId componentId) {
+            return uint32_t(eastl::distance(components.begin(), components.find(componentId)));
+        };
+
+        BinaryWriter writer(buffer);
+        writer.Write(DeltaHeader {DeltaMagic, DeltaVersion, uint32_t(components.size()), uint32_t(deltaJournal.destroyed.size()),
+                                  uint32_t(replicated.size()), uint32_t(changed.size())});
+        writer.WriteComponents(metaStorage, components);
+        writer.Write(deltaJournal.destroyed.data(), deltaJournal.destroyed.size() * sizeof(EntityId));
+
+        for (const auto& entity : replicated)
+        {
+            // Archetype and sparse components are merged, so the list is sorted.
+            eastl::fixed_vector<eastl::pair<Meta::ComponentId, const std::byte*>, 32> entityComponents;
+            for (uint8_t index = 1; index < entity.archetype->GetComponentsView().size(); index++)
+            {
+                const ArchetypeComponentIndex componentIndex(index);
+                const auto& componentInfo = entity.archetype->GetComponentInfo(componentIndex);
+                entityComponents.emplace_back(componentInfo.id, componentInfo.size ? entity.archetype->GetComponentsData(componentIndex)[entity.index.GetChunkIndex()] + entity.index.GetIndexInChunk() * componentInfo.size : nullptr);
+            }
+            for (const auto* sparseSet : entity.sparseSets)
+                entityComponents.emplace_back(sparseSet->GetComponentInfo().id, static_cast<const std::byte*>(sparseSet->Get(entity.entityId)));
+            eastl::sort(entityComponents.begin(), entityComponents.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            writer.Write(DeltaEntity {entity.entityId, uint32_t(entityComponents.size())});
+            for (const auto& [componentId, data] : entityComponents)
+                writer.Write(getComponentIndex(componentId));
+            for (const auto& [componentId, data] : entityComponents)
+                writer.Write(data, metaStorage.find(componentId)->second->size);
+        }
+
+        for (const auto& [entityId, componentId] : changed)
+        {
+            EntityRecord record;
+            entityStorage.Get(entityId, record);
+            const Archetype& archetype = *record.GetArchetype(false);
+            const ArchetypeEntityIndex index = record.GetIndex(false);
+            const ArchetypeComponentIndex componentIndex = archetype.GetComponentIndex(componentId);
+            const size_t componentSize = archetype.GetComponentInfo(componentIndex).size;
+
+            writer.Write(DeltaChange {entityId, getComponentIndex(componentId)});
+            writer.Write(archetype.GetComponentsData(componentIndex)[index.GetChunkIndex()] + index.GetIndexInChunk() * componentSize, componentSize);
+        }
+
+        deltaJournal.Clear();
+        return true;
+    }
+
+    bool World::ApplyDelta(eastl::span<const std::byte> data)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ECS_VERIFY(!IsLocked(), "Delta can't be applied while world is locked.");
+
+        struct ReplicatedData
+        {
+            EntityId entityId;
+            eastl::fixed_vector<const Meta::ComponentInfo*, 32> components;
+            const std::byte* values;
+        };
+
+        struct ChangeData
+        {
+            EntityId entityId;
+            const Meta::ComponentInfo* componentInfo;
+            const std::byte* value;
+        };
+
+        // Whole delta is validated before the world is touched.
+        BinaryReader reader(data);
+        DeltaHeader header;
+        if (!reader.Read(header) || header.magic != DeltaMagic || header.version != DeltaVersion)
+            return false;
+
+        eastl::vector<const Meta::ComponentInfo*> components(header.componentsCount);
+        if (!reader.ReadComponents(metaStorage, components))
+            return false;
+
+        const auto isValidEntity = [](EntityId entityId) {
+            return entityId && entityId.GetIndex() < EntityId::MaxEntities && entityId.GetGeneration() < EntityId::MaxGenerations;
+        };
+
+        const std::byte* destroyed = reader.SkipArray<EntityId>(header.destroyedCount);
+        if (!destroyed)
+            return false;
+
+        for (uint32_t index = 0; index < header.destroyedCount; index++)
+            if (!isValidEntity(ReadValue<EntityId>(destroyed, index)))
+                return false;
+
+        eastl::vector<ReplicatedData> replicated(header.replicatedCount);
+        for (auto& entity : replicated)
+        {
+            DeltaEntity deltaEntity;
+            if (!reader.Read(deltaEntity) || !isValidEntity(deltaEntity.entityId))
+                return false;
+
+            const std::byte* componentIndices = reader.SkipArray<uint32_t>(deltaEntity.componentsCount);
+            if (!componentIndices)
+                return false;
+
+            size_t valuesSize = 0;
+            entity.entityId = deltaEntity.entityId;
+            for (uint32_t index = 0; index < deltaEntity.componentsCount; index++)
+            {
+                const uint32_t componentIndex = ReadValue<uint32_t>(componentIndices, index);
+                if (componentIndex >= components.size() || components[componentIndex]->id == Meta::GetComponentId<EntityId>)
+                    return false;
+
+                if (!entity.components.empty() && !(entity.components.back()->id < components[componentIndex]->id))
+                    return false;
+
+                entity.components.push_back(components[componentIndex]);
+                valuesSize += components[componentIndex]->size;
+            }
+
+            entity.values = reader.Skip(valuesSize);
+            if (!entity.values)
+                return false;
+        }
+
+        eastl::vector<ChangeData> changed(header.changedCount);
+        for (auto& change : changed)
+        {
+            DeltaChange deltaChange;
+            if (!reader.Read(deltaChange) || !isValidEntity(deltaChange.entityId) || deltaChange.componentIndex >= components.size())
+                return false;
+
+            change.entityId = deltaChange.entityId;
+            change.componentInfo = components[deltaChange.componentIndex];
+            change.value = reader.Skip(change.componentInfo->size);
+            if (!change.value || !change.componentInfo->isTrackable)
+                return false;
+        }
+
+        if (!reader.IsEnd())
+            return false;
+
+        for (uint32_t index = 0; index < header.destroyedCount; index++)
+            Destroy(ReadValue<EntityId>(destroyed, index));
+
+        for (const auto& entity : replicated)
+            replicateEntity(entity.entityId, {entity.components.data(), entity.components.size()}, entity.values);
+
+        for (const auto& change : changed)
+        {
+            EntityRecord record;
+            if (!entityStorage.Get(change.entityId, record) || !record.GetArchetype(false))
+                continue;
+
+            Archetype& archetype = *record.GetArchetype(false);
+            const ArchetypeComponentIndex componentIndex = archetype.GetComponentIndex(change.componentInfo->id);
+            if (componentIndex)
+                archetype.WriteComponent(componentIndex, record.GetIndex(false), change.value);
+        }
+
+        if (eastl::any_of(components.begin(), components.end(), [](const Meta::ComponentInfo* componentInfo) { return componentInfo->id == Meta::GetComponentId<ChildOf>; }))
+            rebuildHierarchy();
+
+        return true;
+    }
+
+    void World::replicateEntity(EntityId entityId, eastl::span<const Meta::ComponentInfo* const> components, const std::byte* values)
+    {
+        Meta::ComponentsSet archetypeComponents;
+        archetypeComponents.push_back_unsorted(Meta::GetComponentId<EntityId>);
+        for (const auto* componentInfo : components)
+            if (!componentInfo->isSparse)
+                archetypeComponents.push_back_unsorted(componentInfo->id);
+
+        const Meta::SortedComponentsView componentsView(archetypeComponents);
+        Archetype& to = getOrCreateArchetype(GetArchetypeIdForComponents(componentsView), componentsView);
+
+        const auto copyComponents = [components, values](Archetype& archetype, ArchetypeEntityIndex index, bool newEntity) {
+            const std::byte* value = values;
+            for (const auto* componentInfo : components)
+            {
+                if (!componentInfo->isSparse)
+                {
+                    const ArchetypeComponentIndex componentIndex = archetype.GetComponentIndex(componentInfo->id);
+                    if (newEntity)
+                        archetype.CopyComponentsFrom(componentIndex, index, 1, value);
+                    else
+                        archetype.WriteComponent(componentIndex, index, value);
+                }
+                value += componentInfo->size;
+            }
+        };
+
+        EntityRecord record;
+        if (entityStorage.Get(entityId, record) && record.GetArchetype(false) == &to)
+            copyComponents(to, record.GetIndex(false), false);
+        else
+        {
+            if (!entityStorage.Get(entityId, record))
+            {
+                // Entity with other generation is out of sync with the captured world, so it's replaced.
+                if (entityId.GetIndex() < entityStorage.GetRecordsCount() && entityStorage.GetGeneration(entityId.GetIndex()) != EntityId::MaxGenerations)
+                {
+                    const EntityId staleId(entityId.GetIndex(), entityStorage.GetGeneration(entityId.GetIndex()));
+                    ECS_VERIFY(!entityStorage.Get(staleId, record) || !record.GetArchetype(false) || !details::IsRuntimeArchetype(*record.GetArchetype(false)),
+                               "Replicated entity takes place of query or system.");
+                    destroyImpl(staleId);
+                }
+
+                entityStorage.CreateAt(entityId);
+                record = {};
+            }
+
+            mutateEntity(entityId, record.GetArchetype(false), record.GetIndex(false), to, nullptr, [&copyComponents](Archetype& archetype, ArchetypeEntityIndex index) {
+                copyComponents(archetype, index, true);
+            });
+        }
+
+        for (const auto componentId : archetypeComponents)
+            if (metaStorage[componentId].isSingleton)
+                singletonsSet.insert(componentId);
+
+        // Sparse components are matched by the list.
+        for (auto& [componentId, sparseSet] : sparseSets)
+        {
+            const bool present = eastl::any_of(components.begin(), components.end(), [componentId = componentId](const Meta::ComponentInfo* componentInfo) {
+                return componentInfo->id == componentId;
+            });
+            if (!present)
+                sparseSet->Remove(entityId);
+        }
+
+        const std::byte* value = values;
+        for (const auto* componentInfo : components)
+        {
+            if (componentInfo->isSparse)
+            {
+                SparseSet& sparseSet = getOrCreateSparseSet(componentInfo->id);
+                void* component = sparseSet.Has(entityId) ? sparseSet.Get(entityId) : sparseSet.Emplace(entityId);
+                if (componentInfo->size)
+                    std::memcpy(component, value, componentInfo->size);
+            }
+            value += componentInfo->size;
+        }
+
+        deltaJournal.Touch(entityId);
+    }
+}
@@ -3,9 +3,25 @@ set( ECS_SRC
     ${CMAKE_CURRENT_LIST_DIR}/Index.hpp
     ${CMAKE_CURRENT_LIST_DIR}/World.hpp
     ${CMAKE_CURRENT_LIST_DIR}/World.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Serialization.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/Snapshot.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Delta.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Hierarchy.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/Hierarchy.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Prefab.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/Prefab.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Profile.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/Profile.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/Compaction.cpp
     ${CMAKE_CURRENT_LIST_DIR}/Archetype.hpp
     ${CMAKE_CURRENT_LIST_DIR}/Archetype.cpp
     ${CMAKE_CURRENT_LIST_DIR}/ArchetypeEntityIndex.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ArchetypeIndex.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ArchetypeIndex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/SparseSet.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/SparseSet.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkPool.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ChunkPool.cpp
     ${CMAKE_CURRENT_LIST_DIR}/CommandBuffer.hpp
     ${CMAKE_CURRENT_LIST_DIR}/CommandBuffer.cpp
     ${CMAKE_CURRENT_LIST_DIR}/EntityStorage.hpp
@@ -15,6 +31,8 @@ set( ECS_SRC
     ${CMAKE_CURRENT_LIST_DIR}/EntityBuilder.hpp
     ${CMAKE_CURRENT_LIST_DIR}/Event.hpp
     ${CMAKE_CURRENT_LIST_DIR}/EventStorage.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ExecutionPlan.hpp
+    ${CMAKE_CURRENT_LIST_DIR}/ExecutionPlan.cpp
     ${CMAKE_CURRENT_LIST_DIR}/System.hpp
     ${CMAKE_CURRENT_LIST_DIR}/SystemBuilder.hpp
     ${CMAKE_CURRENT_LIST_DIR}/View.hpp
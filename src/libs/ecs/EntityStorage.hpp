@@ -4,6 +4,10 @@
 #include "ecs/EntityId.hpp"
 #include "ecs/ForwardDeclarations.hpp"
 
+#include <EASTL/algorithm.h>
+#include <atomic>
+#include <cstdlib>
+
 namespace RR::Ecs
 {
     struct EntityRecord
@@ -37,11 +41,43 @@ namespace RR::Ecs
     private:
         eastl::vector<EntityRecord> entityRecords;
         eastl::vector<EntityId> freeId;
+        // Free ids taken by Reserve from the back of the free list, could run past its size.
+        std::atomic<uint32_t> reservedFreeCount = 0;
+        // Ids handed out by Reserve after the free list is exhausted, they follow the last record.
+        std::atomic<uint32_t> reservedCount = 0;
+
+        // Ids are not checked in release, so running out of indices would silently corrupt generations.
+        static void ensureIndex(size_t index)
+        {
+            if UNLIKELY (index >= EntityId::MaxEntities)
+            {
+                LOG_FATAL("Entity index space is exhausted, {} entities at most.", EntityId::MaxEntities);
+                std::abort();
+            }
+        }
+
+        [[nodiscard]] size_t getReservedFreeCount() const
+        {
+            return eastl::min<size_t>(reservedFreeCount.load(std::memory_order_relaxed), freeId.size());
+        }
+
+        // Stale free ids are the ones, which records were taken by entities replicated with CreateAt.
+        [[nodiscard]] bool isStaleFreeId(EntityId entityId) const
+        {
+            return entityRecords[entityId.GetIndex()].generation != EntityId::MaxGenerations;
+        }
 
         EntityRecord& getFreeRecord(EntityId& entityId)
         {
+            ASSERT_MSG(reservedCount.load(std::memory_order_relaxed) == 0 && reservedFreeCount.load(std::memory_order_relaxed) == 0,
+                       "Reserved ids should be committed before creating new records.");
+
+            while (!freeId.empty() && isStaleFreeId(freeId.back()))
+                freeId.pop_back();
+
             if (freeId.empty())
             {
+                ensureIndex(entityRecords.size());
                 entityId = EntityId(EntityId::IndexType(entityRecords.size()), 0);
                 return entityRecords.emplace_back(0);
             }
@@ -64,6 +100,39 @@ namespace RR::Ecs
             return entityId;
         }
 
+        // Creates records for count entities stored in a row in the archetype, starting from the begin index.
+        void Create(Archetype& archetype, ArchetypeEntityIndex begin, size_t count)
+        {
+            entityRecords.reserve(entityRecords.size() + (count > freeId.size() ? count - freeId.size() : 0));
+
+            for (ArchetypeEntityIndex index = begin; count > 0; count--, index = archetype.inc(index))
+            {
+                EntityId entityId;
+                EntityRecord& record = getFreeRecord(entityId);
+                record.archetype = &archetype;
+                record.pendingArchetype = &archetype;
+                record.index = index;
+                archetype.GetEntityIdData(index) = entityId;
+            }
+        }
+
+        // Creates record with the given id, replicated from other world. Record should not be alive,
+        // entity should be placed by Mutate afterwards.
+        void CreateAt(EntityId entityId)
+        {
+            ASSERT(reservedCount.load(std::memory_order_relaxed) == 0 && reservedFreeCount.load(std::memory_order_relaxed) == 0);
+
+            EntityRecord record(EntityId::MaxGenerations);
+            record.archetype = nullptr;
+            record.pendingArchetype = nullptr;
+            if (entityId.GetIndex() >= entityRecords.size())
+                entityRecords.resize(entityId.GetIndex() + 1, record);
+
+            ASSERT(entityRecords[entityId.GetIndex()].generation == EntityId::MaxGenerations);
+            record.generation = entityId.GetGeneration();
+            entityRecords[entityId.GetIndex()] = record;
+        }
+
         EntityId CreateAsync(Archetype& pendingArchetype)
         {
             EntityId entityId;
@@ -73,6 +142,66 @@ namespace RR::Ecs
             return entityId;
         }
 
+        // Thread safe as long as no records are created or destroyed concurrently. Free ids are taken first,
+        // the same as by Create. Reserved id is not accessible until CommitReserved creates its record.
+        EntityId Reserve()
+        {
+            for (;;)
+            {
+                const uint32_t taken = reservedFreeCount.fetch_add(1, std::memory_order_relaxed);
+                if (taken >= freeId.size())
+                    break;
+
+                const EntityId entityId = freeId[freeId.size() - 1 - taken];
+                if (!isStaleFreeId(entityId))
+                    return entityId;
+            }
+
+            const size_t index = entityRecords.size() + reservedCount.fetch_add(1, std::memory_order_relaxed);
+            ensureIndex(index);
+            return EntityId(EntityId::IndexType(index), 0);
+        }
+
+        // Reserved id has no record until CommitReserved.
+        [[nodiscard]] bool IsReserved(EntityId entityId) const
+        {
+            const uint32_t index = entityId.GetIndex();
+            if (index >= entityRecords.size())
+                return index < entityRecords.size() + reservedCount.load(std::memory_order_relaxed);
+
+            // Records of reused ids stay destroyed until commit.
+            if LIKELY (entityRecords[index].generation != EntityId::MaxGenerations)
+                return false;
+
+            const auto reservedFree = freeId.end() - getReservedFreeCount();
+            return eastl::find(reservedFree, freeId.end(), entityId) != freeId.end();
+        }
+
+        void CommitReserved()
+        {
+            const size_t reservedFree = getReservedFreeCount();
+            reservedFreeCount.store(0, std::memory_order_relaxed);
+
+            EntityRecord record(0);
+            record.archetype = nullptr;
+            record.pendingArchetype = nullptr;
+
+            for (size_t taken = 0; taken < reservedFree; taken++)
+            {
+                const EntityId entityId = freeId.back();
+                freeId.pop_back();
+                if (isStaleFreeId(entityId))
+                    continue;
+
+                record.generation = entityId.GetGeneration();
+                entityRecords[entityId.GetIndex()] = record;
+            }
+
+            const uint32_t count = reservedCount.exchange(0, std::memory_order_relaxed);
+            record.generation = 0;
+            entityRecords.resize(entityRecords.size() + count, record);
+        }
+
         [[nodiscard]] bool CanAcesss(EntityId entityId) const
         {
             return entityId.GetIndex() < entityRecords.size() &&
@@ -132,6 +261,31 @@ namespace RR::Ecs
             return true;
         }
 
+        [[nodiscard]] size_t GetRecordsCount() const { return entityRecords.size(); }
+        // Destroyed records have MaxGenerations generation.
+        [[nodiscard]] uint32_t GetGeneration(uint32_t index) const { return entityRecords[index].generation; }
+        [[nodiscard]] eastl::span<const EntityId> GetFreeIds() const { return {freeId.data(), freeId.size()}; }
+
+        // Replaces all records by records of the given generations. Records have no archetypes,
+        // so alive entities should be placed by Mutate afterwards.
+        void Reset(eastl::span<const uint32_t> generations, eastl::span<const EntityId> freeIds)
+        {
+            ASSERT(reservedCount.load(std::memory_order_relaxed) == 0 && reservedFreeCount.load(std::memory_order_relaxed) == 0);
+
+            EntityRecord record(0);
+            record.archetype = nullptr;
+            record.pendingArchetype = nullptr;
+            entityRecords.resize(generations.size(), record);
+
+            for (size_t index = 0; index < generations.size(); index++)
+            {
+                entityRecords[index] = record;
+                entityRecords[index].generation = generations[index];
+            }
+
+            freeId.assign(freeIds.begin(), freeIds.end());
+        }
+
         bool Get(EntityId entityId, EntityRecord& record) const
         {
             if (!CanAcesss(entityId))
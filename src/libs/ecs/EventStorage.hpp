@@ -5,42 +5,120 @@
 #include "ecs/Event.hpp"
 #include "common/ChunkAllocator.hpp"
 
+#include <EASTL/span.h>
+#include <EASTL/unique_ptr.h>
+#include <cstring>
+
 namespace RR::Ecs
 {
     class EventStorage final
     {
     public:
+        struct EventRecord
+        {
+            // Null entity means broadcast event.
+            EntityId entityId;
+            Event* event;
+            // Event is delivered on each of this number of processings.
+            uint32_t frames;
+            // Multi frame events are relocated to the next frame storage with the alignment of their type.
+            uint32_t alignment;
+        };
+
+        // Events emitted by a single writer. Memory of events is kept until the storage, to which stream is merged, is reset.
+        struct Stream
+        {
+            explicit Stream(size_t initialSize) : allocator(initialSize) { }
+
+            template <typename EventType>
+            void Push(EntityId entityId, EventType&& event, uint32_t frames)
+            {
+                static_assert(std::is_base_of<Ecs::Event, eastl::decay_t<EventType>>::value, "EventType must derive from Event");
+                ASSERT(frames > 0);
+
+                Event* ptr = allocator.create<eastl::decay_t<EventType>>(eastl::forward<EventType>(event));
+                events.push_back({entityId, ptr, frames, uint32_t(alignof(eastl::decay_t<EventType>))});
+            }
+
+            void Reset()
+            {
+                allocator.reset();
+                events.clear();
+            }
+
+            Common::ChunkAllocator allocator;
+            eastl::vector<EventRecord> events;
+        };
+
         EventStorage() = default;
 
         template <typename EventType>
-        void Push(EntityId entityId, EventType&& event)
+        void Push(EntityId entityId, EventType&& event, uint32_t frames = 1)
         {
-            static_assert(std::is_base_of<Ecs::Event, EventType>::value, "EventType must derive from Event");
+            current->main.Push(entityId, eastl::forward<EventType>(event), frames);
+        }
+
+        // Should be called before the parallel dispatch, as streams are not created concurrently.
+        void ReserveTaskStreams(size_t count)
+        {
+            static constexpr size_t TaskStreamSize = 64 * 1024;
+            while (current->taskStreams.size() < count)
+                current->taskStreams.emplace_back(eastl::make_unique<Stream>(TaskStreamSize));
+        }
 
-            Event* ptr = current->allocator.create<EventType>(eastl::forward<EventType>(event));
-            current->events.push_back({entityId, ptr});
+        // Stream of parallel task, so tasks emit events without synchronization.
+        Stream& GetTaskStream(size_t taskIndex)
+        {
+            ASSERT(taskIndex < current->taskStreams.size());
+            return *current->taskStreams[taskIndex];
         }
 
+        // Appends events of the first count task streams in the task order, so merged order doesn't depend on scheduling.
+        void MergeTaskStreams(size_t count)
+        {
+            ASSERT(count <= current->taskStreams.size());
+
+            for (size_t taskIndex = 0; taskIndex < count; taskIndex++)
+            {
+                auto& taskEvents = current->taskStreams[taskIndex]->events;
+                current->main.events.insert(current->main.events.end(), taskEvents.begin(), taskEvents.end());
+                taskEvents.clear();
+            }
+        }
+
+        // Callback receives all events emitted since the last processing at once, in emission order.
+        // Multi frame events emitted earlier go first.
         template<typename CallBack>
         void ProcessEvents(const CallBack &cb)
         {
-            if(current->events.empty())
+            if(current->main.events.empty())
                 return;
 
             // We swap storages to avoid race conditions
             // Events emmited during processing will be processed in next frame
             Reset();
 
+            // Events which should be delivered on next processings are moved before emitted during this one.
+            for (const auto& record : next->main.events)
+            {
+                if (record.frames <= 1)
+                    continue;
+
+                void* memory = current->main.allocator.allocate(record.event->size, record.alignment);
+                std::memcpy(memory, record.event, record.event->size);
+                current->main.events.push_back({record.entityId, static_cast<Event*>(memory), record.frames - 1, record.alignment});
+            }
+
             // After swap current is empty, so we actually process events from next storage
-            for (const auto eventRecord : next->events)
-                cb(eventRecord.first, *eventRecord.second);
+            cb(eastl::span<const EventRecord>(next->main.events.data(), next->main.events.size()));
         }
 
         void Reset()
         {
             eastl::swap(current, next);
-            current->allocator.reset();
-            current->events.clear();
+            current->main.Reset();
+            for (auto& taskStream : current->taskStreams)
+                taskStream->Reset();
         }
 
     private:
@@ -48,12 +126,12 @@ namespace RR::Ecs
         {
             static constexpr size_t InitialEventQueueSize = 1024*1024;
 
-            Common::ChunkAllocator allocator{InitialEventQueueSize};
-            eastl::vector<eastl::pair<EntityId, Event*>> events;
+            Stream main {InitialEventQueueSize};
+            eastl::vector<eastl::unique_ptr<Stream>> taskStreams;
         };
 
         eastl::array<Storage, 2> storages;
         Storage* current = &storages[0];
         Storage* next = &storages[1];
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,144 @@
+#include "ExecutionPlan.hpp"
+
+#include "ecs/World.hpp"
+
+#include <EASTL/algorithm.h>
+
+namespace
+{
+    using namespace RR::Ecs;
+
+    bool hasConflictingAccess(const SystemDescription& a, const SystemDescription& b)
+    {
+        if (a.exclusive || b.exclusive)
+            return true;
+
+        const Meta::SortedComponentsView aWrites(a.writes);
+        const Meta::SortedComponentsView bWrites(b.writes);
+
+        return aWrites.IsIntersects(bWrites) ||
+               aWrites.IsIntersects(Meta::SortedComponentsView(b.reads)) ||
+               bWrites.IsIntersects(Meta::SortedComponentsView(a.reads));
+    }
+
+    double toMilliseconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+namespace RR::Ecs
+{
+    void ExecutionPlan::Build(const eastl::vector<SystemInfo>& systems)
+    {
+        Clear();
+        nodes.reserve(systems.size());
+
+        for (uint32_t index = 0; index < systems.size(); index++)
+        {
+            const SystemInfo& system = systems[index];
+
+            Node& node = nodes.emplace_back();
+            node.id = system.id;
+            node.name = system.name;
+            node.exclusive = system.desc->exclusive;
+            node.chunkParallel = system.chunkParallel;
+
+            // Systems are in execution order, so only previous ones could be dependencies.
+            for (uint32_t prevIndex = 0; prevIndex < index; prevIndex++)
+            {
+                const bool isProducer = eastl::find(system.producers.begin(), system.producers.end(), prevIndex) != system.producers.end();
+                if (!isProducer && !hasConflictingAccess(*system.desc, *systems[prevIndex].desc))
+                    continue;
+
+                node.dependencies.push_back(prevIndex);
+                node.wave = eastl::max(node.wave, nodes[prevIndex].wave + 1);
+            }
+
+            if (node.wave >= waves.size())
+                waves.resize(node.wave + 1);
+
+            waves[node.wave].push_back(index);
+        }
+    }
+
+    void ExecutionPlan::Clear()
+    {
+        nodes.clear();
+        waves.clear();
+    }
+
+    eastl::vector<uint32_t> ExecutionPlan::GetCriticalPath(std::chrono::nanoseconds& length) const
+    {
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        eastl::vector<std::chrono::nanoseconds> pathLength(nodes.size());
+        eastl::vector<uint32_t> prevNode(nodes.size(), InvalidIndex);
+
+        // Dependencies always precede node, so single pass is enough.
+        uint32_t lastNode = InvalidIndex;
+        for (uint32_t index = 0; index < nodes.size(); index++)
+        {
+            pathLength[index] = nodes[index].lastDuration;
+            for (const auto dependency : nodes[index].dependencies)
+            {
+                if (pathLength[dependency] + nodes[index].lastDuration <= pathLength[index])
+                    continue;
+
+                pathLength[index] = pathLength[dependency] + nodes[index].lastDuration;
+                prevNode[index] = dependency;
+            }
+
+            if (lastNode == InvalidIndex || pathLength[index] > pathLength[lastNode])
+                lastNode = index;
+        }
+
+        eastl::vector<uint32_t> path;
+        length = lastNode != InvalidIndex ? pathLength[lastNode] : std::chrono::nanoseconds(0);
+
+        for (uint32_t index = lastNode; index != InvalidIndex; index = prevNode[index])
+            path.push_back(index);
+
+        eastl::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    std::string ExecutionPlan::Dump() const
+    {
+        std::chrono::nanoseconds criticalPathLength;
+        const auto criticalPath = GetCriticalPath(criticalPathLength);
+
+        const auto isOnCriticalPath = [&criticalPath](uint32_t from, uint32_t to) {
+            const auto it = eastl::find(criticalPath.begin(), criticalPath.end(), from);
+            return it != criticalPath.end() && eastl::next(it) != criticalPath.end() && *eastl::next(it) == to;
+        };
+
+        std::string result = "digraph Systems {\n    rankdir=LR;\n    node [shape=box];\n";
+        result += fmt::format("    label=\"Critical path: {:.3f} ms\";\n", toMilliseconds(criticalPathLength));
+
+        for (uint32_t waveIndex = 0; waveIndex < waves.size(); waveIndex++)
+        {
+            result += fmt::format("    subgraph cluster_wave{0} {{\n        label=\"Wave {0}\";\n", waveIndex);
+
+            for (const auto index : waves[waveIndex])
+            {
+                const Node& node = nodes[index];
+                const bool critical = eastl::find(criticalPath.begin(), criticalPath.end(), index) != criticalPath.end();
+                const std::string name = node.name.string.empty() ? fmt::format("System {}", node.id.GetRaw()) : std::string(node.name.string.c_str());
+
+                result += fmt::format("        n{} [label=\"{}{}\\n{:.3f} ms\"{}];\n",
+                                      index, name, node.exclusive ? " (exclusive)" : "",
+                                      toMilliseconds(node.lastDuration), critical ? ", color=red" : "");
+            }
+
+            result += "    }\n";
+        }
+
+        for (uint32_t index = 0; index < nodes.size(); index++)
+            for (const auto dependency : nodes[index].dependencies)
+                result += fmt::format("    n{} -> n{}{};\n", dependency, index, isOnCriticalPath(dependency, index) ? " [color=red]" : "");
+
+        result += "}\n";
+        return result;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ecs/ForwardDeclarations.hpp"
+#include "ecs/Hash.hpp"
+#include "ecs/Index.hpp"
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/vector.h>
+#include <chrono>
+#include <string>
+
+namespace RR::Ecs
+{
+    // Execution plan of systems, which are not subscribed to events and not tracking components.
+    // Systems are grouped into waves. Systems in the same wave have no order dependencies between each other
+    // and no conflicting component access, so they could be executed concurrently.
+    struct ExecutionPlan
+    {
+        struct SystemInfo
+        {
+            SystemId id;
+            HashName name;
+            const SystemDescription* desc;
+            bool chunkParallel;
+            // Indices of systems in the input list, which produce tokens required by this system.
+            eastl::fixed_vector<uint32_t, 8> producers;
+        };
+
+        struct Node
+        {
+            SystemId id;
+            HashName name;
+            uint32_t wave = 0;
+            // Executed on the calling thread, could use the world freely.
+            bool exclusive = false;
+            // Splits own chunks across the job system, so executed on the calling thread.
+            bool chunkParallel = false;
+            // Indices of nodes, which should be completed before this one.
+            eastl::fixed_vector<uint32_t, 8> dependencies;
+            std::chrono::nanoseconds lastDuration {0};
+        };
+
+        using Wave = eastl::fixed_vector<uint32_t, 16>;
+
+        // Systems should be passed in the execution order.
+        void Build(const eastl::vector<SystemInfo>& systems);
+        void Clear();
+
+        // Longest chain of dependent nodes weighted by the last measured durations.
+        eastl::vector<uint32_t> GetCriticalPath(std::chrono::nanoseconds& length) const;
+
+        // Graph in graphviz dot format, waves are clustered and critical path is highlighted.
+        std::string Dump() const;
+
+        const eastl::vector<Node>& GetNodes() const { return nodes; }
+        const eastl::vector<Wave>& GetWaves() const { return waves; }
+
+    private:
+        friend struct World;
+
+        eastl::vector<Node> nodes;
+        eastl::vector<Wave> waves;
+    };
+}
@@ -8,6 +8,7 @@
 
 #define ECS_TRACKABLE static constexpr bool Trackable = true
 #define ECS_SINGLETON static constexpr bool Singleton = true
+#define ECS_SPARSE static constexpr bool Sparse = true
 
 #ifdef ECS_USE_EXCEPTIONS
 #include <stdexcept>
@@ -39,6 +40,9 @@ namespace RR::Ecs
     struct QueryBuilder;
     struct ArchetypeEntityIndex;
     struct Archetype;
+    struct ArchetypeEdge;
+    struct SparseFilter;
+    struct ArchetypeEventBatch;
 
     template <typename Tag, typename IndexType = uint32_t>
     struct Index;
@@ -0,0 +1,207 @@
+#include "World.hpp"
+
+#include <EASTL/algorithm.h>
+
+namespace RR::Ecs
+{
+    void World::SetParent(EntityId entityId, EntityId parent)
+    {
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        ASSERT(entityId);
+        const auto guard = parallelGuard();
+
+        if (!IsAlive(entityId))
+            return;
+
+        if (parent && !IsAlive(parent))
+        {
+            ECS_VERIFY(false, "Can't attach entity to deleted or non existing parent.");
+            return;
+        }
+
+        if (IsLocked())
+            getCommandBuffer().SetParent(entityId, parent);
+        else
+            setParentImpl(entityId, parent);
+    }
+
+    EntityId World::GetParent(EntityId entityId) const
+    {
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        const auto guard = parallelGuard();
+
+        EntityRecord record;
+        if (!ResolveEntityRecord(entityId, record) || !record.GetArchetype(false))
+            return {};
+
+        const Archetype& archetype = *record.GetArchetype(false);
+        const ArchetypeComponentIndex componentIndex = archetype.GetComponentIndex<ChildOf>();
+        if (!componentIndex)
+            return {};
+
+        const ArchetypeEntityIndex index = record.GetIndex(false);
+        return reinterpret_cast<const ChildOf*>(archetype.GetComponentsData(componentIndex)[index.GetChunkIndex()])[index.GetIndexInChunk()].parent;
+    }
+
+    eastl::span<const EntityId> World::GetChildren(EntityId entityId) const
+    {
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        const auto guard = parallelGuard();
+
+        const auto it = hierarchyChildren.find(entityId);
+        if (it == hierarchyChildren.end())
+            return {};
+
+        return {it->second.data(), it->second.size()};
+    }
+
+    void World::setParentImpl(EntityId entityId, EntityId parent)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT(!IsLocked());
+
+        // Deferred command could outlive both of entities.
+        if (!IsAlive(entityId) || (parent && !IsAlive(parent)))
+            return;
+
+        for (EntityId ancestor = parent; ancestor; ancestor = GetParent(ancestor))
+        {
+            if (ancestor == entityId)
+            {
+                ECS_VERIFY(false, "Entity can't be attached to itself or its descendant.");
+                return;
+            }
+        }
+
+        const EntityId previousParent = GetParent(entityId);
+        if (previousParent == parent)
+            return;
+
+        uint32_t depth = 0;
+        if (parent)
+        {
+            EntityRecord record;
+            ResolveEntityRecord(parent, record);
+            depth = record.GetArchetype(false)->GetHierarchyDepth() + 1;
+        }
+
+        if (depth + getHierarchyHeight(entityId) > MaxHierarchyDepth)
+        {
+            ECS_VERIFY(false, "Hierarchy can't be deeper than {} levels.", MaxHierarchyDepth);
+            return;
+        }
+
+        if (previousParent)
+        {
+            const auto it = hierarchyChildren.find(previousParent);
+            ASSERT(it != hierarchyChildren.end());
+            it->second.erase(eastl::remove(it->second.begin(), it->second.end(), entityId), it->second.end());
+            if (it->second.empty())
+                hierarchyChildren.erase(it);
+        }
+
+        if (parent)
+            hierarchyChildren[parent].push_back(entityId);
+
+        placeInHierarchy(entityId, parent, depth);
+    }
+
+    void World::placeInHierarchy(EntityId entityId, EntityId parent, uint32_t depth) // NOLINT(misc-no-recursion)
+    {
+        EntityRecord record;
+        if (!ResolveEntityRecord(entityId, record) || !record.GetArchetype(false))
+        {
+            ASSERT(false);
+            return;
+        }
+
+        Archetype& from = *record.GetArchetype(false);
+        const uint32_t previousDepth = from.GetHierarchyDepth();
+
+        Meta::ComponentsSet components;
+        for (const auto componentId : from.GetComponentsView())
+            if (componentId != Meta::GetComponentId<ChildOf> && (previousDepth == 0 || componentId != details::GetHierarchyDepthId(previousDepth)))
+                components.push_back_unsorted(componentId); // Components already sorted
+
+        if (parent)
+            components.insert(Meta::GetComponentId<ChildOf>);
+        if (depth > 0)
+            components.insert(details::GetHierarchyDepthId(depth));
+
+        const Meta::SortedComponentsView componentsView(components);
+        Archetype& to = getOrCreateArchetype(GetArchetypeIdForComponents(componentsView), componentsView);
+
+        const auto writeParent = [parent](Archetype& archetype, ArchetypeEntityIndex index) {
+            if (parent)
+                archetype.ConstructComponent<ChildOf>(index, archetype.GetComponentIndex<ChildOf>(), parent);
+        };
+
+        // Reparenting at the same depth keeps entity in place.
+        if (&from == &to)
+        {
+            writeParent(to, record.GetIndex(false));
+            deltaJournal.Touch(entityId);
+        }
+        else
+            mutateEntity(entityId, &from, record.GetIndex(false), to, nullptr, writeParent);
+
+        if (depth == previousDepth)
+            return;
+
+        const auto it = hierarchyChildren.find(entityId);
+        if (it == hierarchyChildren.end())
+            return;
+
+        // Copied, as appear handlers could change the hierarchy.
+        const auto children = it->second;
+        for (const auto child : children)
+            placeInHierarchy(child, entityId, depth + 1);
+    }
+
+    uint32_t World::getHierarchyHeight(EntityId entityId) const // NOLINT(misc-no-recursion)
+    {
+        const auto it = hierarchyChildren.find(entityId);
+        if (it == hierarchyChildren.end())
+            return 0;
+
+        uint32_t height = 0;
+        for (const auto child : it->second)
+            height = eastl::max(height, getHierarchyHeight(child) + 1);
+
+        return height;
+    }
+
+    void World::unlinkFromHierarchy(EntityId entityId)
+    {
+        if (const EntityId parent = GetParent(entityId))
+        {
+            const auto it = hierarchyChildren.find(parent);
+            if (it != hierarchyChildren.end())
+            {
+                it->second.erase(eastl::remove(it->second.begin(), it->second.end(), entityId), it->second.end());
+                if (it->second.empty())
+                    hierarchyChildren.erase(it);
+            }
+        }
+
+        const auto it = hierarchyChildren.find(entityId);
+        if (it == hierarchyChildren.end())
+            return;
+
+        const auto children = eastl::move(it->second);
+        hierarchyChildren.erase(it);
+
+        for (const auto child : children)
+            Destroy(child);
+    }
+
+    void World::rebuildHierarchy()
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        hierarchyChildren.clear();
+        query(View().With<ChildOf>(), [this](EntityId entityId, const ChildOf& childOf) {
+            hierarchyChildren[childOf.parent].push_back(entityId);
+        });
+    }
+}
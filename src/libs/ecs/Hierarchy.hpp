@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ecs/EntityId.hpp"
+#include "ecs/meta/ComponentTraits.hpp"
+
+#include <EASTL/array.h>
+#include <EASTL/utility.h>
+
+namespace RR::Ecs
+{
+    // Parent of the entity, set by World::SetParent only.
+    struct ChildOf
+    {
+        EntityId parent;
+    };
+
+    // Roots have depth 0 and are not tagged.
+    constexpr uint32_t MaxHierarchyDepth = 32;
+
+    // Entities of different depth are placed to different archetypes, so depth ordered views visit
+    // all parents chunk by chunk before any of their children.
+    template <uint32_t Depth>
+    struct HierarchyDepth
+    {
+        static_assert(Depth > 0 && Depth <= MaxHierarchyDepth);
+    };
+
+    namespace details
+    {
+        template <size_t... Depth>
+        constexpr eastl::array<Meta::ComponentId, sizeof...(Depth)> MakeHierarchyDepthIds(eastl::index_sequence<Depth...>)
+        {
+            return {Meta::GetComponentId<HierarchyDepth<uint32_t(Depth + 1)>>...};
+        }
+
+        // Depth tag of depth N is at N - 1.
+        constexpr auto HierarchyDepthIds = MakeHierarchyDepthIds(eastl::make_index_sequence<MaxHierarchyDepth>());
+
+        inline Meta::ComponentId GetHierarchyDepthId(uint32_t depth)
+        {
+            ASSERT(depth > 0 && depth <= MaxHierarchyDepth);
+            return HierarchyDepthIds[depth - 1];
+        }
+
+        template <typename Storage, size_t... Depth>
+        void RegisterHierarchyComponents(Storage& metaStorage, eastl::index_sequence<Depth...>)
+        {
+            metaStorage.template Register<ChildOf>();
+            (metaStorage.template Register<HierarchyDepth<uint32_t(Depth + 1)>>(), ...);
+        }
+    }
+}
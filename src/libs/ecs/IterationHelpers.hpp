@@ -2,7 +2,9 @@
 
 #include "EASTL/algorithm.h"
 #include "ecs/Archetype.hpp"
+#include "ecs/SparseSet.hpp"
 #include <ecs/meta/FunctionTraits.hpp>
+#include <EASTL/span.h>
 #if defined(__i386__) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -18,20 +20,129 @@ namespace RR::Ecs
         ArchetypeEntityIndex end;
     };
 
+    // Filters chunks of the archetype by the world version of the last write to components, see View::Changed.
+    struct ChunkChangeFilter
+    {
+        ChunkChangeFilter(const Archetype& archetype, Meta::SortedComponentsView components, uint32_t sinceVersion) : sinceVersion(sinceVersion)
+        {
+            for (const auto componentId : components)
+                versions.push_back(archetype.GetChangeVersions(archetype.GetComponentIndex(componentId)));
+        }
+
+        // Chunk is changed, if any of components was written at the version or later.
+        [[nodiscard]] bool IsChanged(size_t chunkIndex) const
+        {
+            for (const uint32_t* componentVersions : versions)
+                if (Archetype::IsSameOrNewerVersion(componentVersions[chunkIndex], sinceVersion))
+                    return true;
+
+            return false;
+        }
+
+    private:
+        eastl::fixed_vector<const uint32_t*, 4> versions;
+        uint32_t sinceVersion;
+    };
+
+    // Splits archetype entities into spans aligned to chunk boundaries, each span covers up to chunksPerSpan chunks.
+    // Chunks rejected by change filter are skipped, so spans cover only runs of changed chunks.
+    template <typename Container>
+    void SplitByChunks(const Archetype& archetype, uint32_t chunksPerSpan, Container& spans, const ChunkChangeFilter* changeFilter = nullptr)
+    {
+        ASSERT(chunksPerSpan > 0);
+
+        if (archetype.GetEntitiesCount() == 0)
+            return;
+
+        const ArchetypeEntityIndex end = archetype.end();
+        // Last chunk is full, so end points to the beginning of non existing chunk.
+        const uint32_t chunksCount = end.GetChunkIndex() + (end.GetIndexInChunk() != 0 ? 1 : 0);
+        const auto isChanged = [changeFilter](uint32_t chunkIndex) { return !changeFilter || changeFilter->IsChanged(chunkIndex); };
+
+        for (uint32_t chunkIndex = 0; chunkIndex < chunksCount;)
+        {
+            if (!isChanged(chunkIndex))
+            {
+                chunkIndex++;
+                continue;
+            }
+
+            const uint32_t firstChunkIndex = chunkIndex;
+            while (chunkIndex < chunksCount && chunkIndex - firstChunkIndex < chunksPerSpan && isChanged(chunkIndex))
+                chunkIndex++;
+
+            const ArchetypeEntityIndex spanEnd = chunkIndex <= end.GetChunkIndex() ? ArchetypeEntityIndex(0, chunkIndex) : end;
+            spans.emplace_back(archetype, ArchetypeEntityIndex(0, firstChunkIndex), spanEnd);
+        }
+    }
+
+    // Deferred event targeted to the entity of batch archetype.
+    struct ArchetypeEventRecord
+    {
+        ArchetypeEntityIndex index;
+        const Event* event;
+    };
+
+    // Deferred events of the same type targeted to entities of the same archetype.
+    struct ArchetypeEventBatch
+    {
+        const Archetype* archetype;
+        eastl::span<const ArchetypeEventRecord> records;
+    };
+
+    // Execution policy of systems and queries opted into parallel execution.
+    struct ParallelExecution
+    {
+        // Amount of chunks processed by a single task.
+        uint32_t chunksPerTask = 1;
+    };
+
+    // Filters entities of matched archetypes by presence of sparse components.
+    struct SparseFilter
+    {
+        eastl::fixed_vector<const SparseSet*, 4> with;
+        eastl::fixed_vector<const SparseSet*, 4> without;
+
+        [[nodiscard]] bool IsEmpty() const { return with.empty() && without.empty(); }
+
+        [[nodiscard]] bool Matches(EntityId entityId) const
+        {
+            for (const auto* sparseSet : with)
+                if (!sparseSet->Has(entityId))
+                    return false;
+
+            for (const auto* sparseSet : without)
+                if (sparseSet->Has(entityId))
+                    return false;
+
+            return true;
+        }
+    };
+
     struct IterationContext
     {
-        IterationContext(World& world, const Event* event) : world(world), event(event) { };
+        IterationContext(World& world, const Event* event, const SparseFilter* sparseFilter = nullptr)
+            : world(world), event(event), sparseFilter(sparseFilter) { };
         World& world;
         const Event* event;
+        const SparseFilter* sparseFilter;
     };
 
+    // Returns nullptr if no entity ever had the component.
+    SparseSet* FindSparseSet(World& world, Meta::ComponentId componentId);
+    // Version stamped to chunks written by non-const access.
+    uint32_t GetCurrentChangeVersion(const World& world);
+
     template <typename Arg, typename Enable = void>
     struct ComponentAccessor
     {
         using Argument = Arg;
         using Component = Meta::GetComponentType<Arg>;
+        static constexpr bool IsWriteAccess = (eastl::is_pointer_v<Arg> || eastl::is_reference_v<Arg>) &&
+                                              !eastl::is_const_v<eastl::remove_pointer_t<eastl::remove_reference_t<Arg>>>;
+        static constexpr bool MarksDirty = IsWriteAccess && Meta::IsTrackable<Component>;
 
-        ComponentAccessor(const Archetype& archetype, const IterationContext&)
+        ComponentAccessor(const Archetype& archetype, [[maybe_unused]] const IterationContext& context)
         {
             const auto componentIndex = archetype.GetComponentIndex<Component>();
             if constexpr (std::is_pointer_v<Arg>)
@@ -41,6 +152,15 @@ namespace RR::Ecs
                 componentDataArray = archetype.GetComponentsData(componentIndex);
                 ASSERT(componentDataArray);
             }
+
+            if constexpr (MarksDirty)
+                dirtyFlags = componentIndex ? archetype.GetDirtyFlags(componentIndex) : nullptr;
+
+            if constexpr (IsWriteAccess)
+            {
+                changeVersions = componentIndex ? archetype.GetChangeVersions(componentIndex) : nullptr;
+                changeVersion = GetCurrentChangeVersion(context.world);
+            }
         }
 
         void SetChunkIndex([[maybe_unused]] const Archetype& archetype, size_t chunkIndex)
@@ -56,6 +176,17 @@ namespace RR::Ecs
                 ASSERT(data);
             }
 
+            if constexpr (MarksDirty)
+            {
+                if (dirtyFlags)
+                    dirtyFlags[chunkIndex] = 1;
+            }
+
+            if constexpr (IsWriteAccess)
+            {
+                if (changeVersions)
+                    changeVersions[chunkIndex] = changeVersion;
+            }
         }
 
         void Prefetch(size_t chunkIndex)
@@ -90,6 +221,44 @@ namespace RR::Ecs
     private:
         std::byte* data;
         std::byte* const * componentDataArray;
+        uint8_t* dirtyFlags = nullptr;
+        uint32_t* changeVersions = nullptr;
+        uint32_t changeVersion = 0;
+    };
+
+    template <typename Arg>
+    struct ComponentAccessor<Arg, eastl::enable_if_t<Meta::details::is_sparse_v<Meta::GetComponentType<Arg>>>>
+    {
+        using Argument = Arg;
+        using Component = Meta::GetComponentType<Arg>;
+
+        ComponentAccessor(const Archetype& archetype, const IterationContext& context)
+            : sparseSet(FindSparseSet(context.world, Meta::GetComponentId<Component>)),
+              entityIdsArray(archetype.GetComponentsData(ArchetypeComponentIndex(0))) { }
+
+        void SetChunkIndex([[maybe_unused]] const Archetype& archetype, size_t chunkIndex)
+        {
+            ASSERT(chunkIndex < archetype.GetChunksCount());
+            entityIds = reinterpret_cast<const EntityId*>(*(entityIdsArray + chunkIndex));
+        }
+
+        Component* Get(size_t entityIndex)
+        {
+            Component* result = nullptr;
+            if constexpr (Meta::IsTag<Component>)
+                result = sparseSet && sparseSet->Has(entityIds[entityIndex]) ? &tag : nullptr;
+            else
+                result = sparseSet ? static_cast<Component*>(sparseSet->Get(entityIds[entityIndex])) : nullptr;
+
+            ASSERT_MSG(eastl::is_pointer_v<Arg> || result, "Entity doesn't have sparse component, access it as pointer or add it to the View.");
+            return result;
+        }
+
+    private:
+        SparseSet* sparseSet;
+        std::byte* const* entityIdsArray;
+        const EntityId* entityIds = nullptr;
+        Component tag {};
     };
 
     template <typename Arg>
@@ -112,6 +281,7 @@ namespace RR::Ecs
         using Argument = Arg;
         using Component = Meta::GetComponentType<Arg>;
 
+        // Event is read through the context, as it changes from entity to entity in event batches.
         ComponentAccessor(const Archetype&, const IterationContext& context) : event(context.event) {
             static_assert(eastl::is_pointer_v<Argument> || eastl::is_reference_v<Argument>, "Event component should be accessed as pointer or reference");
         };
@@ -125,7 +295,91 @@ namespace RR::Ecs
             return &event->As<Component>();
         }
     private:
-        const Ecs::Event* event;
+        const Ecs::Event* const& event;
+    };
+
+    template <typename T>
+    struct IsSpan : eastl::false_type { };
+
+    template <typename T, size_t Extent>
+    struct IsSpan<eastl::span<T, Extent>> : eastl::true_type { };
+
+    // Chunk level access. Components are accessed as contiguous arrays eastl::span<T> or eastl::span<const T>,
+    // other arguments are the same for the whole chunk and forwarded to ComponentAccessor.
+    template <typename Arg, typename Enable = void>
+    struct ChunkAccessor
+    {
+        using Argument = Arg;
+        using Component = Meta::GetComponentType<Arg>;
+        static_assert(eastl::is_same_v<Ecs::World, Component> || eastl::is_base_of_v<Ecs::Event, Component>,
+                      "Components should be accessed as eastl::span in chunk iteration");
+
+        ChunkAccessor(const Archetype& archetype, const IterationContext& context) : accessor(archetype, context) { };
+        void SetChunkIndex(const Archetype& archetype, size_t chunkIndex) { accessor.SetChunkIndex(archetype, chunkIndex); }
+
+        Arg Get(uint32_t, uint32_t)
+        {
+            if constexpr (eastl::is_pointer_v<Arg>)
+                return accessor.Get(0);
+            else
+                return *accessor.Get(0);
+        }
+
+    private:
+        ComponentAccessor<Arg> accessor;
+    };
+
+    template <typename Arg>
+    struct ChunkAccessor<Arg, eastl::enable_if_t<IsSpan<eastl::decay_t<Arg>>::value>>
+    {
+        using Argument = Arg;
+        using Span = eastl::decay_t<Arg>;
+        using Element = typename Span::element_type;
+        using Component = eastl::remove_const_t<Element>;
+        static constexpr bool IsWriteAccess = !eastl::is_const_v<Element>;
+        static constexpr bool MarksDirty = IsWriteAccess && Meta::IsTrackable<Component>;
+        static_assert(Meta::IsComponent<Component>, "Span element should be a component");
+        static_assert(!Meta::IsSparse<Component>, "Sparse components are not stored in chunks");
+
+        ChunkAccessor(const Archetype& archetype, [[maybe_unused]] const IterationContext& context)
+        {
+            const auto componentIndex = archetype.GetComponentIndex<Component>();
+            componentDataArray = archetype.GetComponentsData(componentIndex);
+            ASSERT(componentDataArray);
+
+            if constexpr (MarksDirty)
+                dirtyFlags = archetype.GetDirtyFlags(componentIndex);
+
+            if constexpr (IsWriteAccess)
+            {
+                changeVersions = archetype.GetChangeVersions(componentIndex);
+                changeVersion = GetCurrentChangeVersion(context.world);
+            }
+        }
+
+        void SetChunkIndex([[maybe_unused]] const Archetype& archetype, size_t chunkIndex)
+        {
+            ASSERT(chunkIndex < archetype.GetChunksCount());
+            data = *(componentDataArray + chunkIndex);
+
+            if constexpr (MarksDirty)
+                dirtyFlags[chunkIndex] = 1;
+
+            if constexpr (IsWriteAccess)
+                changeVersions[chunkIndex] = changeVersion;
+        }
+
+        Span Get(uint32_t beginEntityIndex, uint32_t endEntityIndex)
+        {
+            return Span(reinterpret_cast<Element*>(data) + beginEntityIndex, endEntityIndex - beginEntityIndex);
+        }
+
+    private:
+        std::byte* data;
+        std::byte* const * componentDataArray;
+        uint8_t* dirtyFlags = nullptr;
+        uint32_t* changeVersions = nullptr;
+        uint32_t changeVersion = 0;
     };
 
     struct ArchetypeIterator
@@ -163,6 +417,14 @@ namespace RR::Ecs
                 invoke<typename ComponentAccessors::Argument...>(eastl::forward<Func>(func), components.Get(i)...);
         }
 
+        template <typename Func, typename... ComponentAccessors>
+        static void processChunkFiltered(Func&& func, const SparseFilter& filter, const EntityId* entityIds, uint32_t beginEntityIndex, uint32_t endEntityIndex, ComponentAccessors... components)
+        {
+            for (uint32_t i = beginEntityIndex; i < endEntityIndex; i++)
+                if (filter.Matches(entityIds[i]))
+                    invoke<typename ComponentAccessors::Argument...>(eastl::forward<Func>(func), components.Get(i)...);
+        }
+
         template <typename Func, typename... ComponentAccessors>
         static void invokeForEntity(uint32_t indexInChunk, Func&& func, ComponentAccessors&... components)
         {
@@ -206,7 +468,75 @@ namespace RR::Ecs
                     break;
 
                 (eastl::get<Index>(componentAccessors).SetChunkIndex(archetype, chunkIndex), ...);
-                processChunk<4>(eastl::forward<Func>(func), beginEntityIndex, endEntityIndex, eastl::get<Index>(componentAccessors)...);
+                if (context.sparseFilter)
+                {
+                    const auto* entityIds = reinterpret_cast<const EntityId*>(*(archetype.GetComponentsData(ArchetypeComponentIndex(0)) + chunkIndex));
+                    processChunkFiltered(eastl::forward<Func>(func), *context.sparseFilter, entityIds, beginEntityIndex, endEntityIndex, eastl::get<Index>(componentAccessors)...);
+                }
+                else
+                    processChunk<4>(eastl::forward<Func>(func), beginEntityIndex, endEntityIndex, eastl::get<Index>(componentAccessors)...);
+
+                if (chunkIndex == beginChunkIndex)
+                    beginEntityIndex = 0;
+            }
+        }
+
+        template <typename ArgumentList, typename Func, size_t... Index>
+        static void processEvents(const ArchetypeEventBatch& batch, IterationContext& context, Func&& func, const eastl::index_sequence<Index...>&)
+        {
+            const Archetype& archetype = *batch.archetype;
+            if (batch.records.empty())
+                return;
+
+            auto componentAccessors = eastl::make_tuple(ComponentAccessor<typename ArgumentList::template Get<Index>>(archetype, context)...);
+
+            size_t chunkIndex = batch.records.front().index.GetChunkIndex();
+            (eastl::get<Index>(componentAccessors).SetChunkIndex(archetype, chunkIndex), ...);
+            const EntityId* entityIds = reinterpret_cast<const EntityId*>(*(archetype.GetComponentsData(ArchetypeComponentIndex(0)) + chunkIndex));
+
+            for (const auto& record : batch.records)
+            {
+                if (record.index.GetChunkIndex() != chunkIndex)
+                {
+                    chunkIndex = record.index.GetChunkIndex();
+                    (eastl::get<Index>(componentAccessors).SetChunkIndex(archetype, chunkIndex), ...);
+                    entityIds = reinterpret_cast<const EntityId*>(*(archetype.GetComponentsData(ArchetypeComponentIndex(0)) + chunkIndex));
+                }
+
+                if (context.sparseFilter && !context.sparseFilter->Matches(entityIds[record.index.GetIndexInChunk()]))
+                    continue;
+
+                context.event = record.event;
+                invokeForEntity(record.index.GetIndexInChunk(), eastl::forward<Func>(func), eastl::get<Index>(componentAccessors)...);
+            }
+        }
+
+        template <typename ArgumentList, typename Func, size_t... Index>
+        static void processChunks(const ArchetypeEntitySpan& span, const IterationContext& context, Func&& func, const eastl::index_sequence<Index...>&)
+        {
+            const Archetype& archetype = *span.archetype;
+            if (archetype.GetEntitiesCount() == 0)
+                return;
+
+            ASSERT_MSG(!context.sparseFilter, "Chunks can't be filtered by sparse components.");
+            auto chunkAccessors = eastl::make_tuple(ChunkAccessor<typename ArgumentList::template Get<Index>>(archetype, context)...);
+
+            uint32_t beginChunkIndex = static_cast<uint32_t>(span.begin.GetChunkIndex());
+            uint32_t endChunkIndex = static_cast<uint32_t>(span.end.GetChunkIndex());
+
+            uint32_t beginEntityIndex = span.begin.GetIndexInChunk();
+            uint32_t endEntityIndex = static_cast<uint32_t>(archetype.GetChunkCapacity());
+
+            for (uint32_t chunkIndex = beginChunkIndex; chunkIndex <= endChunkIndex; ++chunkIndex)
+            {
+                if (chunkIndex == endChunkIndex)
+                    endEntityIndex = span.end.GetIndexInChunk();
+
+                if (beginEntityIndex == endEntityIndex)
+                    break;
+
+                (eastl::get<Index>(chunkAccessors).SetChunkIndex(archetype, chunkIndex), ...);
+                func(eastl::get<Index>(chunkAccessors).Get(beginEntityIndex, endEntityIndex)...);
 
                 if (chunkIndex == beginChunkIndex)
                     beginEntityIndex = 0;
@@ -221,6 +551,22 @@ namespace RR::Ecs
             processEntities<ArgList>(span, context, eastl::forward<Callable>(callable), eastl::make_index_sequence<ArgList::Count>());
         }
 
+        // Callable is invoked once per chunk with contiguous component arrays of entities in the chunk.
+        template <typename Callable>
+        static void ForEachChunk(ArchetypeEntitySpan span, const IterationContext& context, Callable&& callable)
+        {
+            using ArgList = Meta::GetArgumentList<Callable>;
+            processChunks<ArgList>(span, context, eastl::forward<Callable>(callable), eastl::make_index_sequence<ArgList::Count>());
+        }
+
+        // Callable is invoked for every event of the batch, event argument is the one targeted to the entity.
+        template <typename Callable>
+        static void ForEachEvent(const ArchetypeEventBatch& batch, IterationContext& context, Callable&& callable)
+        {
+            using ArgList = Meta::GetArgumentList<Callable>;
+            processEvents<ArgList>(batch, context, eastl::forward<Callable>(callable), eastl::make_index_sequence<ArgList::Count>());
+        }
+
         template <typename Callable>
         static void ForEntity(const Archetype& archetype, ArchetypeEntityIndex entityId, const IterationContext& context, Callable&& callable)
         {
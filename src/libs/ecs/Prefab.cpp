@@ -0,0 +1,100 @@
+#include "World.hpp"
+
+#include <cstring>
+
+namespace RR::Ecs
+{
+    Archetype* World::instantiate(EntityId prefab, uint32_t count, ArchetypeEntityIndex& begin)
+    {
+        ASSERT(count > 0);
+
+        EntityRecord record;
+        if (!ResolveEntityRecord(prefab, record) || !record.GetArchetype(false))
+        {
+            ECS_VERIFY(false, "Deleted or non existing prefab.");
+            return nullptr;
+        }
+
+        const Archetype& from = *record.GetArchetype(false);
+        if (!from.GetComponentIndex<Prefab>())
+        {
+            ECS_VERIFY(false, "Entity is not a prefab.");
+            return nullptr;
+        }
+
+        // Instances are roots, as children lists are not copied.
+        const uint32_t depth = from.GetHierarchyDepth();
+        Meta::ComponentsSet components;
+        for (const auto componentId : from.GetComponentsView())
+        {
+            if (componentId == Meta::GetComponentId<Prefab> || componentId == Meta::GetComponentId<ChildOf> ||
+                (depth > 0 && componentId == details::GetHierarchyDepthId(depth)))
+                continue;
+
+            const auto& componentInfo = metaStorage[componentId];
+            if (componentInfo.isSingleton || (componentInfo.size && !componentInfo.isTriviallyCopyable && !componentInfo.copy))
+            {
+                ECS_VERIFY(false, "Component {} of prefab can't be copied.", componentInfo.name);
+                return nullptr;
+            }
+
+            components.push_back_unsorted(componentId); // Components already sorted
+        }
+
+        eastl::fixed_vector<SparseSet*, 8> prefabSparseSets;
+        for (const auto& [componentId, sparseSet] : sparseSets)
+        {
+            if (!sparseSet->Has(prefab))
+                continue;
+
+            const auto& componentInfo = sparseSet->GetComponentInfo();
+            if (componentInfo.size && !componentInfo.isTriviallyCopyable && !componentInfo.copy)
+            {
+                ECS_VERIFY(false, "Component {} of prefab can't be copied.", componentInfo.name);
+                return nullptr;
+            }
+
+            prefabSparseSets.push_back(sparseSet.get());
+        }
+
+        const Meta::SortedComponentsView componentsView(components);
+        Archetype& to = getOrCreateArchetype(GetArchetypeIdForComponents(componentsView), componentsView);
+
+        begin = to.InsertEntities(count);
+        entityStorage.Create(to, begin, count);
+
+        const ArchetypeEntityIndex prefabIndex = record.GetIndex(false);
+        for (uint8_t index = 1; index < to.GetComponentsView().size(); index++)
+        {
+            const ArchetypeComponentIndex componentIndex(index);
+            const size_t componentSize = to.GetComponentInfo(componentIndex).size;
+            if (!componentSize)
+                continue;
+
+            const ArchetypeComponentIndex prefabComponentIndex = from.GetComponentIndex(to.GetComponentInfo(componentIndex).id);
+            const std::byte* value = from.GetComponentsData(prefabComponentIndex)[prefabIndex.GetChunkIndex()] + prefabIndex.GetIndexInChunk() * componentSize;
+            to.FillComponents(componentIndex, begin, count, value);
+        }
+
+        for (auto* sparseSet : prefabSparseSets)
+        {
+            const auto& componentInfo = sparseSet->GetComponentInfo();
+
+            for (auto index = begin; index != to.end(); index = to.inc(index))
+            {
+                void* component = sparseSet->Emplace(to.GetEntityIdData(index));
+                if (!componentInfo.size)
+                    continue;
+
+                // Resolved after emplace, as storage could be reallocated.
+                void* value = sparseSet->Get(prefab);
+                if (componentInfo.isTriviallyCopyable)
+                    std::memcpy(component, value, componentInfo.size);
+                else
+                    componentInfo.copy(component, value);
+            }
+        }
+
+        return &to;
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace RR::Ecs
+{
+    // Entity with this tag is a prefab, a template of component values for World::Instantiate.
+    // Prefabs are never matched by views, queries and systems, but could be accessed by id as usual.
+    struct Prefab
+    {
+    };
+}
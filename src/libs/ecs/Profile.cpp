@@ -0,0 +1,75 @@
+#include "World.hpp"
+
+#include <EASTL/sort.h>
+
+namespace RR::Ecs
+{
+    void World::EnableProfiling(bool enable)
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        if (enable && !profilingEnabled)
+            ResetProfile();
+
+        profilingEnabled = enable;
+    }
+
+    void World::ResetProfile()
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        // Entries are kept, as compiled systems point to them.
+        for (auto& systemProfile : profile.systems)
+        {
+            SystemProfile reset;
+            reset.id = systemProfile.id;
+            reset.name = systemProfile.name;
+            systemProfile = reset;
+        }
+
+        profile.trackedChangesTime = {};
+        profile.commandsTime = {};
+        profile.processedCommands = 0;
+    }
+
+    void World::GetArchetypesProfile(eastl::vector<ArchetypeProfile>& archetypes) const
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        archetypes.clear();
+        archetypes.reserve(archetypesMap.size());
+
+        for (const auto& [archetypeId, archetype] : archetypesMap)
+        {
+            ArchetypeProfile& archetypeProfile = archetypes.emplace_back();
+            archetypeProfile.id = archetypeId;
+            archetypeProfile.componentsCount = static_cast<uint32_t>(archetype->GetComponentsView().size());
+            archetypeProfile.hierarchyDepth = archetype->GetHierarchyDepth();
+            archetypeProfile.entitiesCount = archetype->GetEntitiesCount();
+            archetypeProfile.chunksCount = archetype->GetChunksCount();
+            archetypeProfile.chunkSize = archetype->GetChunkSize();
+            archetypeProfile.chunkCapacity = archetype->GetChunkCapacity();
+
+            const size_t capacity = archetypeProfile.chunksCount * archetypeProfile.chunkCapacity;
+            archetypeProfile.fillRatio = capacity ? float(archetypeProfile.entitiesCount) / float(capacity) : 0.0f;
+            // Singleton archetypes have the single entity sized as the whole chunk.
+            const size_t usedBytes = eastl::min(archetypeProfile.entitiesCount * archetype->GetEntitySize(), archetypeProfile.chunksCount * archetypeProfile.chunkSize);
+            archetypeProfile.wastedBytes = archetypeProfile.chunksCount * archetypeProfile.chunkSize - usedBytes;
+        }
+
+        // Map order is not deterministic.
+        eastl::sort(archetypes.begin(), archetypes.end(), [](const ArchetypeProfile& lhs, const ArchetypeProfile& rhs) { return lhs.id < rhs.id; });
+    }
+
+    void World::profileRun(SystemProfile& systemProfile, const MatchedArchetypeCache& archetypes, uint64_t commands)
+    {
+        systemProfile.runs++;
+        systemProfile.commands += commands;
+
+        for (const auto* archetype : archetypes)
+        {
+            systemProfile.entities += archetype->GetEntitiesCount();
+            systemProfile.chunks += archetype->GetChunksCount();
+        }
+    }
+}
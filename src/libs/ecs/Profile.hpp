@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ecs/ForwardDeclarations.hpp"
+#include "ecs/Hash.hpp"
+#include "ecs/Index.hpp"
+
+#include <EASTL/vector.h>
+#include <chrono>
+
+namespace RR::Ecs
+{
+    // Counters of the system accumulated since the last reset.
+    struct SystemProfile
+    {
+        SystemId id;
+        HashName name;
+        // Runs by RunSystem and RunSystems.
+        uint32_t runs = 0;
+        std::chrono::nanoseconds runTime {0};
+        // Entities and chunks of matched archetypes visited by runs, sparse filtering is not taken into account.
+        uint64_t entities = 0;
+        uint64_t chunks = 0;
+        // Structural changes deferred to command buffers by runs.
+        uint64_t commands = 0;
+        // Callback invocations by immediate, deferred and tracked changes events.
+        uint32_t eventDispatches = 0;
+        std::chrono::nanoseconds eventTime {0};
+    };
+
+    struct WorldProfile
+    {
+        // Ordered systems in execution order.
+        eastl::vector<SystemProfile> systems;
+        std::chrono::nanoseconds trackedChangesTime {0};
+        // Applying of deferred commands, nested into the system times when applied on unlock of the system run.
+        std::chrono::nanoseconds commandsTime {0};
+        uint64_t processedCommands = 0;
+    };
+
+    struct ArchetypeProfile
+    {
+        ArchetypeId id;
+        uint32_t componentsCount = 0;
+        uint32_t hierarchyDepth = 0;
+        size_t entitiesCount = 0;
+        size_t chunksCount = 0;
+        // In bytes.
+        size_t chunkSize = 0;
+        // In entities.
+        size_t chunkCapacity = 0;
+        // Entities to the capacity of allocated chunks.
+        float fillRatio = 0.0f;
+        // Allocated bytes not occupied by entities, it's free slots of the tail chunk and padding of every chunk.
+        size_t wastedBytes = 0;
+    };
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ecs/Index.hpp"
+#include "ecs/IterationHelpers.hpp"
 #include "ecs/View.hpp"
 
+#include <EASTL/optional.h>
+
 namespace RR::Ecs
 {
     struct World;
@@ -14,6 +17,14 @@ namespace RR::Ecs
 
         template <typename Callable>
         void ForEach(Callable&& callable) const;
+        // Callable is invoked once per chunk with contiguous component arrays:
+        // [](eastl::span<Position> positions, eastl::span<const Velocity> velocities) { ... }
+        // Arrays start at Archetype::ColumnAlignment aligned address, except for singleton archetypes.
+        template <typename Callable>
+        void ForEachChunk(Callable&& callable) const;
+
+        // Query is stored as an entity with the same id, destroying the entity destroys the query.
+        [[nodiscard]] QueryId GetId() const { return id; }
 
     private:
         friend World;
@@ -45,6 +56,30 @@ namespace RR::Ecs
             return *this;
         }
 
+        // Only chunks changed since the previous run of the query are visited, see View::Changed.
+        template <typename... Components>
+        QueryBuilder Changed() &&
+        {
+            view.Changed<Components...>();
+            return *this;
+        }
+
+        // Parents are processed before their children, see View::InDepthOrder.
+        QueryBuilder InDepthOrder() &&
+        {
+            view.InDepthOrder();
+            return *this;
+        }
+
+        // Matched chunks are split into tasks and processed on the world job system, when world have one.
+        // Callable must be safe to invoke concurrently. Structural changes are deferred as usual.
+        QueryBuilder Parallel(uint32_t chunksPerTask = 1) &&
+        {
+            ASSERT(chunksPerTask > 0);
+            parallel = ParallelExecution {chunksPerTask};
+            return *this;
+        }
+
         Query Build() &&;
 
     private:
@@ -54,5 +89,6 @@ namespace RR::Ecs
 
     private:
         View view;
+        eastl::optional<ParallelExecution> parallel;
     };
 }
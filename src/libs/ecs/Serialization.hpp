@@ -0,0 +1,148 @@
+#pragma once
+
+#include "ecs/Archetype.hpp"
+#include "ecs/View.hpp"
+#include "ecs/meta/Storage.hpp"
+
+#include <EASTL/span.h>
+#include <EASTL/vector.h>
+#include <cstring>
+
+// Helpers shared by world snapshots and deltas. Data is written in native byte order and read back with bounds checks,
+// as it could come from disk or network.
+namespace RR::Ecs::details
+{
+    struct SerializedComponent
+    {
+        Meta::ComponentId::ValueType id;
+        uint32_t size;
+        uint32_t alignment;
+        uint32_t flags;
+    };
+
+    constexpr uint32_t TrackableComponentFlag = 1 << 0;
+    constexpr uint32_t SingletonComponentFlag = 1 << 1;
+    constexpr uint32_t SparseComponentFlag = 1 << 2;
+
+    inline uint32_t GetComponentFlags(const Meta::ComponentInfo& componentInfo)
+    {
+        return (componentInfo.isTrackable ? TrackableComponentFlag : 0) |
+               (componentInfo.isSingleton ? SingletonComponentFlag : 0) |
+               (componentInfo.isSparse ? SparseComponentFlag : 0);
+    }
+
+    // Queries and systems are created by code, so they are never serialized.
+    inline bool IsRuntimeArchetype(const Archetype& archetype)
+    {
+        return bool(archetype.GetComponentIndex<View>());
+    }
+
+    struct BinaryWriter
+    {
+        explicit BinaryWriter(eastl::vector<std::byte>& buffer) : buffer(buffer) { }
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(&value, sizeof(T));
+        }
+
+        void Write(const void* data, size_t size)
+        {
+            if (!size)
+                return;
+
+            const size_t offset = buffer.size();
+            buffer.resize(offset + size);
+            std::memcpy(buffer.data() + offset, data, size);
+        }
+
+        // Components are referenced by index in the table.
+        void WriteComponents(const Meta::Storage& metaStorage, const Meta::ComponentsSet& components)
+        {
+            for (const auto componentId : components)
+            {
+                const auto& componentInfo = *metaStorage.find(componentId)->second;
+                Write(SerializedComponent {componentId.GetRaw(), uint32_t(componentInfo.size), uint32_t(componentInfo.alignment), GetComponentFlags(componentInfo)});
+            }
+        }
+
+    private:
+        eastl::vector<std::byte>& buffer;
+    };
+
+    struct BinaryReader
+    {
+        explicit BinaryReader(eastl::span<const std::byte> data) : data(data) { }
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const std::byte* src = Skip(sizeof(T));
+            if (!src)
+                return false;
+
+            std::memcpy(&value, src, sizeof(T));
+            return true;
+        }
+
+        // Returns nullptr if there is not enough data.
+        const std::byte* Skip(size_t size)
+        {
+            if (size > data.size() - offset)
+                return nullptr;
+
+            const std::byte* result = data.data() + offset;
+            offset += size;
+            return result;
+        }
+
+        template <typename T>
+        const std::byte* SkipArray(size_t count)
+        {
+            if (count > (data.size() - offset) / sizeof(T))
+                return nullptr;
+
+            return Skip(count * sizeof(T));
+        }
+
+        // Components should be registered in the world and have the same layout.
+        bool ReadComponents(const Meta::Storage& metaStorage, eastl::vector<const Meta::ComponentInfo*>& components)
+        {
+            for (auto& componentInfo : components)
+            {
+                SerializedComponent component;
+                if (!Read(component))
+                    return false;
+
+                const auto it = metaStorage.find(Meta::ComponentId(component.id));
+                if (it == metaStorage.end())
+                    return false;
+
+                componentInfo = it->second;
+                if (!componentInfo->isTriviallyCopyable || componentInfo->size != component.size ||
+                    componentInfo->alignment != component.alignment || GetComponentFlags(*componentInfo) != component.flags)
+                    return false;
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] bool IsEnd() const { return offset == data.size(); }
+
+    private:
+        eastl::span<const std::byte> data;
+        size_t offset = 0;
+    };
+
+    // Serialized data has no alignment guarantees.
+    template <typename T>
+    T ReadValue(const std::byte* data, size_t index)
+    {
+        T value;
+        std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+        return value;
+    }
+}
@@ -0,0 +1,393 @@
+#include "World.hpp"
+#include "ecs/Serialization.hpp"
+
+#include <EASTL/bitvector.h>
+#include <EASTL/sort.h>
+#include <cstring>
+
+namespace
+{
+    using namespace RR::Ecs;
+    using namespace RR::Ecs::details;
+
+    // Layout: header, components table, entity records generations, free ids, runtime entities, archetypes, sparse sets.
+    // Components are referenced by index in the table. Archetype columns are contiguous arrays of all its entities,
+    // so snapshot doesn't depend on chunks size of the saving world.
+    constexpr uint32_t SnapshotMagic = 0x53434552; // RECS
+    constexpr uint32_t SnapshotVersion = 1;
+
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t componentsCount;
+        uint32_t recordsCount;
+        uint32_t freeIdsCount;
+        uint32_t runtimeEntitiesCount;
+        uint32_t archetypesCount;
+        uint32_t sparseSetsCount;
+    };
+
+    struct SnapshotArchetype
+    {
+        uint32_t componentsCount;
+        uint32_t entitiesCount;
+    };
+
+    struct SnapshotSparseSet
+    {
+        uint32_t componentIndex;
+        uint32_t entitiesCount;
+    };
+}
+
+namespace RR::Ecs
+{
+    bool World::SaveSnapshot(eastl::vector<std::byte>& buffer) const
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ECS_VERIFY(!IsLocked(), "Snapshot can't be saved while world is locked.");
+
+        // Sorted, so equal worlds produce equal snapshots.
+        eastl::vector<const Archetype*> archetypes;
+        eastl::vector<const Archetype*> runtimeArchetypes;
+        for (const auto& [archetypeId, archetype] : archetypesMap)
+        {
+            if (IsRuntimeArchetype(*archetype))
+                runtimeArchetypes.push_back(archetype.get());
+            else if (archetype->GetEntitiesCount() > 0)
+                archetypes.push_back(archetype.get());
+        }
+        eastl::sort(archetypes.begin(), archetypes.end(), [](const Archetype* a, const Archetype* b) {
+            return eastl::lexicographical_compare(a->GetComponentsView().begin(), a->GetComponentsView().end(),
+                                                  b->GetComponentsView().begin(), b->GetComponentsView().end());
+        });
+
+        eastl::vector<const SparseSet*> sparseSetsList;
+        for (const auto& [componentId, sparseSet] : sparseSets)
+            if (sparseSet->GetSize() > 0)
+                sparseSetsList.push_back(sparseSet.get());
+        eastl::sort(sparseSetsList.begin(), sparseSetsList.end(), [](const SparseSet* a, const SparseSet* b) {
+            return a->GetComponentInfo().id < b->GetComponentInfo().id;
+        });
+
+        // Columns are written as raw bytes, so components, which can't be copied this way, fail the save in any build.
+        Meta::ComponentsSet components;
+        bool triviallyCopyable = true;
+        const auto addComponent = [&components, &triviallyCopyable](const Meta::ComponentInfo& componentInfo) {
+            if (components.insert(componentInfo.id).second && !componentInfo.isTriviallyCopyable)
+            {
+                Log::Format::Error("Component {} is not trivially copyable and can't be saved to snapshot.", componentInfo.name);
+                triviallyCopyable = false;
+            }
+        };
+        for (const auto* archetype : archetypes)
+            for (uint8_t index = 0; index < archetype->GetComponentsView().size(); index++)
+                addComponent(archetype->GetComponentInfo(ArchetypeComponentIndex(index)));
+        for (const auto* sparseSet : sparseSetsList)
+            addComponent(sparseSet->GetComponentInfo());
+
+        if (!triviallyCopyable)
+            return false;
+
+        const auto getComponentIndex = [&components](Meta::ComponentId componentId) {
+            return uint32_t(eastl::distance(components.begin(), components.find(componentId)));
+        };
+
+        eastl::vector<EntityId> runtimeEntities;
+        for (const auto* archetype : runtimeArchetypes)
+            for (auto index = archetype->begin(); index != archetype->end(); index = archetype->inc(index))
+                runtimeEntities.push_back(archetype->GetEntityIdData(index));
+        eastl::sort(runtimeEntities.begin(), runtimeEntities.end(), [](EntityId a, EntityId b) { return a.GetRaw() < b.GetRaw(); });
+
+        const auto freeIds = entityStorage.GetFreeIds();
+        const uint32_t recordsCount = uint32_t(entityStorage.GetRecordsCount());
+
+        // Reserved upfront, so columns are appended without reallocations.
+        size_t snapshotSize = sizeof(SnapshotHeader) + components.size() * sizeof(SerializedComponent) +
+                              recordsCount * sizeof(uint32_t) + (freeIds.size() + runtimeEntities.size()) * sizeof(EntityId);
+        for (const auto* archetype : archetypes)
+            snapshotSize += sizeof(SnapshotArchetype) + archetype->GetComponentsView().size() * sizeof(uint32_t) +
+                            archetype->GetEntitiesCount() * archetype->GetEntitySize();
+        for (const auto* sparseSet : sparseSetsList)
+            snapshotSize += sizeof(SnapshotSparseSet) + sparseSet->GetSize() * (sizeof(EntityId) + sparseSet->GetComponentInfo().size);
+        buffer.reserve(buffer.size() + snapshotSize);
+
+        BinaryWriter writer(buffer);
+        writer.Write(SnapshotHeader {SnapshotMagic, SnapshotVersion, uint32_t(components.size()), recordsCount,
+                                     uint32_t(freeIds.size()), uint32_t(runtimeEntities.size()), uint32_t(archetypes.size()), uint32_t(sparseSetsList.size())});
+
+        writer.WriteComponents(metaStorage, components);
+
+        for (uint32_t index = 0; index < recordsCount; index++)
+            writer.Write(entityStorage.GetGeneration(index));
+        writer.Write(freeIds.data(), freeIds.size() * sizeof(EntityId));
+
+        writer.Write(runtimeEntities.data(), runtimeEntities.size() * sizeof(EntityId));
+
+        for (const auto* archetype : archetypes)
+        {
+            const auto archetypeComponents = archetype->GetComponentsView();
+            writer.Write(SnapshotArchetype {uint32_t(archetypeComponents.size()), uint32_t(archetype->GetEntitiesCount())});
+
+            for (const auto componentId : archetypeComponents)
+                writer.Write(getComponentIndex(componentId));
+
+            for (uint8_t componentIndex = 0; componentIndex < archetypeComponents.size(); componentIndex++)
+            {
+                const size_t componentSize = archetype->GetComponentInfo(ArchetypeComponentIndex(componentIndex)).size;
+                if (!componentSize)
+                    continue;
+
+                std::byte* const* chunks = archetype->GetComponentsData(ArchetypeComponentIndex(componentIndex));
+                for (size_t chunkIndex = 0, remaining = archetype->GetEntitiesCount(); remaining > 0; chunkIndex++)
+                {
+                    const size_t chunkCount = eastl::min(archetype->GetChunkCapacity(), remaining);
+                    writer.Write(chunks[chunkIndex], chunkCount * componentSize);
+                    remaining -= chunkCount;
+                }
+            }
+        }
+
+        for (const auto* sparseSet : sparseSetsList)
+        {
+            const auto entities = sparseSet->GetEntities();
+            writer.Write(SnapshotSparseSet {getComponentIndex(sparseSet->GetComponentInfo().id), uint32_t(entities.size())});
+            writer.Write(entities.data(), entities.size() * sizeof(EntityId));
+            writer.Write(sparseSet->GetData(), entities.size() * sparseSet->GetComponentInfo().size);
+        }
+
+        return true;
+    }
+
+    bool World::LoadSnapshot(eastl::span<const std::byte> data)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ECS_VERIFY(!IsLocked(), "Snapshot can't be loaded while world is locked.");
+
+        struct ArchetypeData
+        {
+            Meta::ComponentsSet components;
+            uint32_t entitiesCount;
+            const std::byte* componentIndices;
+            const std::byte* entityIds;
+            // Pointer to column data for every component, null for tags.
+            eastl::fixed_vector<const std::byte*, 32> columns;
+        };
+
+        struct SparseSetData
+        {
+            const Meta::ComponentInfo* componentInfo;
+            uint32_t entitiesCount;
+            const std::byte* entityIds;
+            const std::byte* components;
+        };
+
+        // Whole snapshot is validated before the world is touched.
+        BinaryReader reader(data);
+        SnapshotHeader header;
+        if (!reader.Read(header) || header.magic != SnapshotMagic || header.version != SnapshotVersion || header.recordsCount > EntityId::MaxEntities)
+            return false;
+
+        eastl::vector<const Meta::ComponentInfo*> components(header.componentsCount);
+        if (!reader.ReadComponents(metaStorage, components))
+            return false;
+
+        const std::byte* generations = reader.SkipArray<uint32_t>(header.recordsCount);
+        const std::byte* freeIds = reader.SkipArray<EntityId>(header.freeIdsCount);
+        const std::byte* runtimeEntities = reader.SkipArray<EntityId>(header.runtimeEntitiesCount);
+        if (!generations || !freeIds || !runtimeEntities)
+            return false;
+
+        const auto getGeneration = [generations](uint32_t index) { return ReadValue<uint32_t>(generations, index); };
+        const auto isValidEntity = [&header, &getGeneration](EntityId entityId) {
+            return entityId && entityId.GetIndex() < header.recordsCount && getGeneration(entityId.GetIndex()) == entityId.GetGeneration();
+        };
+
+        // Every record could be placed only once.
+        eastl::bitvector placed(header.recordsCount, false);
+        const auto place = [&placed, &isValidEntity](EntityId entityId) {
+            if (!isValidEntity(entityId) || placed[entityId.GetIndex()])
+                return false;
+
+            placed.set(entityId.GetIndex(), true);
+            return true;
+        };
+
+        for (uint32_t index = 0; index < header.freeIdsCount; index++)
+        {
+            const auto entityId = ReadValue<EntityId>(freeIds, index);
+            if (!entityId || entityId.GetIndex() >= header.recordsCount || getGeneration(entityId.GetIndex()) != EntityId::MaxGenerations)
+                return false;
+        }
+
+        // Queries and systems of the world should be the same as in the saved one.
+        size_t runtimeEntitiesCount = 0;
+        for (const auto& [archetypeId, archetype] : archetypesMap)
+            if (IsRuntimeArchetype(*archetype))
+                runtimeEntitiesCount += archetype->GetEntitiesCount();
+
+        if (runtimeEntitiesCount != header.runtimeEntitiesCount)
+            return false;
+
+        for (uint32_t index = 0; index < header.runtimeEntitiesCount; index++)
+        {
+            const auto entityId = ReadValue<EntityId>(runtimeEntities, index);
+            EntityRecord record;
+            if (!place(entityId) || !entityStorage.Get(entityId, record) || !record.GetArchetype(false) || !IsRuntimeArchetype(*record.GetArchetype(false)))
+                return false;
+        }
+
+        eastl::vector<ArchetypeData> archetypes(header.archetypesCount);
+        for (auto& archetypeData : archetypes)
+        {
+            SnapshotArchetype archetype;
+            if (!reader.Read(archetype) || archetype.componentsCount == 0 || archetype.entitiesCount == 0)
+                return false;
+
+            archetypeData.entitiesCount = archetype.entitiesCount;
+            archetypeData.componentIndices = reader.SkipArray<uint32_t>(archetype.componentsCount);
+            if (!archetypeData.componentIndices)
+                return false;
+
+            bool singleton = false;
+            for (uint32_t index = 0; index < archetype.componentsCount; index++)
+            {
+                const uint32_t componentIndex = ReadValue<uint32_t>(archetypeData.componentIndices, index);
+                if (componentIndex >= components.size() || components[componentIndex]->isSparse)
+                    return false;
+
+                const auto& componentInfo = *components[componentIndex];
+                // Components are sorted, the first one is always entity id.
+                if (!archetypeData.components.empty() && !(archetypeData.components.back() < componentInfo.id))
+                    return false;
+
+                singleton = singleton || componentInfo.isSingleton;
+                archetypeData.components.push_back_unsorted(componentInfo.id);
+
+                const std::byte* column = componentInfo.size ? reader.Skip(size_t(archetype.entitiesCount) * componentInfo.size) : nullptr;
+                if (componentInfo.size && !column)
+                    return false;
+
+                archetypeData.columns.push_back(column);
+            }
+
+            if (archetypeData.components.front() != Meta::GetComponentId<EntityId>)
+                return false;
+
+            if (singleton && archetype.entitiesCount != 1)
+                return false;
+
+            archetypeData.entityIds = archetypeData.columns.front();
+            for (uint32_t index = 0; index < archetype.entitiesCount; index++)
+                if (!place(ReadValue<EntityId>(archetypeData.entityIds, index)))
+                    return false;
+        }
+
+        eastl::vector<SparseSetData> sparseSetsData(header.sparseSetsCount);
+        for (auto& sparseSetData : sparseSetsData)
+        {
+            SnapshotSparseSet sparseSet;
+            if (!reader.Read(sparseSet) || sparseSet.componentIndex >= components.size() || !components[sparseSet.componentIndex]->isSparse)
+                return false;
+
+            sparseSetData.componentInfo = components[sparseSet.componentIndex];
+            sparseSetData.entitiesCount = sparseSet.entitiesCount;
+            sparseSetData.entityIds = reader.SkipArray<EntityId>(sparseSet.entitiesCount);
+            sparseSetData.components = reader.Skip(size_t(sparseSet.entitiesCount) * sparseSetData.componentInfo->size);
+            if (!sparseSetData.entityIds || !sparseSetData.components)
+                return false;
+
+            for (uint32_t index = 0; index < sparseSet.entitiesCount; index++)
+            {
+                const auto entityId = ReadValue<EntityId>(sparseSetData.entityIds, index);
+                if (!isValidEntity(entityId) || !placed[entityId.GetIndex()])
+                    return false;
+            }
+        }
+
+        if (!reader.IsEnd())
+            return false;
+
+        // Changes recorded before load are no longer relevant.
+        deltaJournal.Clear();
+
+        // Runtime entities keep their places.
+        eastl::vector<eastl::pair<EntityId, EntityRecord>> runtimeRecords(header.runtimeEntitiesCount);
+        for (uint32_t index = 0; index < header.runtimeEntitiesCount; index++)
+        {
+            runtimeRecords[index].first = ReadValue<EntityId>(runtimeEntities, index);
+            entityStorage.Get(runtimeRecords[index].first, runtimeRecords[index].second);
+        }
+
+        // Singletons are registered again for the loaded entities and the kept runtime ones.
+        singletonsSet.clear();
+        for (auto& [archetypeId, archetype] : archetypesMap)
+        {
+            if (!IsRuntimeArchetype(*archetype))
+            {
+                archetype->Clear();
+                continue;
+            }
+
+            if (archetype->GetEntitiesCount() == 0)
+                continue;
+
+            for (uint8_t index = 1; index < archetype->GetComponentsView().size(); index++)
+            {
+                const auto& componentInfo = archetype->GetComponentInfo(ArchetypeComponentIndex(index));
+                if (componentInfo.isSingleton)
+                    singletonsSet.insert(componentInfo.id);
+            }
+        }
+
+        for (auto& [componentId, sparseSet] : sparseSets)
+            sparseSet->Clear();
+
+        eastl::vector<uint32_t> recordsGenerations(header.recordsCount);
+        std::memcpy(recordsGenerations.data(), generations, header.recordsCount * sizeof(uint32_t));
+        eastl::vector<EntityId> freeIdsList(header.freeIdsCount);
+        std::memcpy(freeIdsList.data(), freeIds, header.freeIdsCount * sizeof(EntityId));
+        entityStorage.Reset(recordsGenerations, freeIdsList);
+
+        for (const auto& [entityId, record] : runtimeRecords)
+            entityStorage.Mutate(entityId, *record.GetArchetype(false), record.GetIndex(false));
+
+        for (const auto& archetypeData : archetypes)
+        {
+            const Meta::SortedComponentsView componentsView(archetypeData.components);
+            Archetype& archetype = getOrCreateArchetype(GetArchetypeIdForComponents(componentsView), componentsView);
+
+            const auto begin = archetype.InsertEntities(archetypeData.entitiesCount);
+            for (uint8_t componentIndex = 0; componentIndex < archetypeData.columns.size(); componentIndex++)
+            {
+                if (archetypeData.columns[componentIndex])
+                    archetype.CopyComponentsFrom(ArchetypeComponentIndex(componentIndex), begin, archetypeData.entitiesCount, archetypeData.columns[componentIndex]);
+
+                const auto& componentInfo = archetype.GetComponentInfo(ArchetypeComponentIndex(componentIndex));
+                if (componentInfo.isSingleton)
+                    singletonsSet.insert(componentInfo.id);
+            }
+
+            uint32_t entityIndex = 0;
+            for (auto index = begin; entityIndex < archetypeData.entitiesCount; index = archetype.inc(index), entityIndex++)
+                entityStorage.Mutate(ReadValue<EntityId>(archetypeData.entityIds, entityIndex), archetype, index);
+        }
+
+        for (const auto& sparseSetData : sparseSetsData)
+        {
+            SparseSet& sparseSet = getOrCreateSparseSet(sparseSetData.componentInfo->id);
+            const size_t componentSize = sparseSetData.componentInfo->size;
+
+            for (uint32_t index = 0; index < sparseSetData.entitiesCount; index++)
+            {
+                void* component = sparseSet.Emplace(ReadValue<EntityId>(sparseSetData.entityIds, index));
+                if (componentSize)
+                    std::memcpy(component, sparseSetData.components + index * componentSize, componentSize);
+            }
+        }
+
+        rebuildHierarchy();
+        return true;
+    }
+}
@@ -0,0 +1,112 @@
+#include "SparseSet.hpp"
+
+#include <EASTL/algorithm.h>
+#include <new>
+
+namespace RR::Ecs
+{
+    SparseSet::~SparseSet()
+    {
+        Clear();
+
+        if (data)
+            ::operator delete(data, std::align_val_t(componentInfo.alignment));
+    }
+
+    void* SparseSet::Emplace(EntityId entityId)
+    {
+        ASSERT(entityId);
+        ASSERT(!Has(entityId));
+
+        const uint32_t denseIndex = static_cast<uint32_t>(entities.size());
+        if (componentInfo.size && denseIndex == capacity)
+            reallocate(eastl::max<size_t>(capacity * 2, 64));
+
+        getSparse(entityId) = denseIndex;
+        entities.push_back(entityId);
+        return getData(denseIndex);
+    }
+
+    bool SparseSet::Remove(EntityId entityId)
+    {
+        const uint32_t denseIndex = find(entityId);
+        if (denseIndex == InvalidIndex)
+            return false;
+
+        const uint32_t lastIndex = static_cast<uint32_t>(entities.size() - 1);
+        if (componentInfo.size)
+        {
+            std::byte* removed = getData(denseIndex);
+            if (componentInfo.destructor)
+                componentInfo.destructor(removed);
+
+            if (denseIndex != lastIndex)
+            {
+                std::byte* last = getData(lastIndex);
+                componentInfo.move(removed, last);
+                if (componentInfo.destructor)
+                    componentInfo.destructor(last);
+            }
+        }
+
+        if (denseIndex != lastIndex)
+        {
+            entities[denseIndex] = entities[lastIndex];
+            getSparse(entities[denseIndex]) = denseIndex;
+        }
+
+        getSparse(entityId) = InvalidIndex;
+        entities.pop_back();
+        return true;
+    }
+
+    void SparseSet::Clear()
+    {
+        for (uint32_t denseIndex = 0; denseIndex < entities.size(); denseIndex++)
+        {
+            if (componentInfo.size && componentInfo.destructor)
+                componentInfo.destructor(getData(denseIndex));
+
+            getSparse(entities[denseIndex]) = InvalidIndex;
+        }
+
+        entities.clear();
+    }
+
+    uint32_t& SparseSet::getSparse(EntityId entityId)
+    {
+        const uint32_t page = entityId.GetIndex() / PageSize;
+        if (page >= pages.size())
+            pages.resize(page + 1);
+
+        if (!pages[page])
+        {
+            pages[page] = eastl::make_unique<uint32_t[]>(PageSize);
+            eastl::fill_n(pages[page].get(), PageSize, InvalidIndex);
+        }
+
+        return pages[page][entityId.GetIndex() % PageSize];
+    }
+
+    void SparseSet::reallocate(size_t newCapacity)
+    {
+        ASSERT(componentInfo.size);
+        ASSERT(newCapacity >= entities.size());
+
+        auto* newData = static_cast<std::byte*>(::operator new(newCapacity * componentInfo.size, std::align_val_t(componentInfo.alignment)));
+
+        for (uint32_t denseIndex = 0; denseIndex < entities.size(); denseIndex++)
+        {
+            std::byte* source = getData(denseIndex);
+            componentInfo.move(newData + denseIndex * componentInfo.size, source);
+            if (componentInfo.destructor)
+                componentInfo.destructor(source);
+        }
+
+        if (data)
+            ::operator delete(data, std::align_val_t(componentInfo.alignment));
+
+        data = newData;
+        capacity = newCapacity;
+    }
+}
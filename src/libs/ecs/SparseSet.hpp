@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common/NonCopyableMovable.hpp"
+#include "ecs/EntityId.hpp"
+#include "ecs/meta/ComponentTraits.hpp"
+
+#include <EASTL/span.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+namespace RR::Ecs
+{
+    // Storage of a sparse component out of archetypes. Components are densely packed, entity index is mapped
+    // to the dense index through paged sparse array, so adding and removing component is O(1) and entity stays in place.
+    class SparseSet final : public Common::NonCopyable
+    {
+    public:
+        explicit SparseSet(const Meta::ComponentInfo& componentInfo) : componentInfo(componentInfo) { }
+        ~SparseSet();
+
+        [[nodiscard]] bool Has(EntityId entityId) const { return find(entityId) != InvalidIndex; }
+
+        // Returns nullptr if entity has no component, tags have no data as well.
+        [[nodiscard]] void* Get(EntityId entityId) const
+        {
+            const uint32_t denseIndex = find(entityId);
+            return denseIndex != InvalidIndex ? getData(denseIndex) : nullptr;
+        }
+
+        // Returns uninitialized memory for the component of entity, which doesn't have it yet.
+        [[nodiscard]] void* Emplace(EntityId entityId);
+        // Swaps the last component into the removed one place. Returns false if entity has no component.
+        bool Remove(EntityId entityId);
+        void Clear();
+
+        [[nodiscard]] size_t GetSize() const { return entities.size(); }
+        [[nodiscard]] eastl::span<const EntityId> GetEntities() const { return {entities.data(), entities.size()}; }
+        // Components are densely packed in order of entities.
+        [[nodiscard]] const std::byte* GetData() const { return data; }
+        [[nodiscard]] const Meta::ComponentInfo& GetComponentInfo() const { return componentInfo; }
+
+    private:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+        static constexpr uint32_t PageSize = 4096;
+
+        uint32_t find(EntityId entityId) const
+        {
+            const uint32_t page = entityId.GetIndex() / PageSize;
+            if (page >= pages.size() || !pages[page])
+                return InvalidIndex;
+
+            const uint32_t denseIndex = pages[page][entityId.GetIndex() % PageSize];
+            // Generation is checked against dense entity, so stale ids are never matched.
+            return denseIndex != InvalidIndex && entities[denseIndex] == entityId ? denseIndex : InvalidIndex;
+        }
+
+        uint32_t& getSparse(EntityId entityId);
+        std::byte* getData(uint32_t denseIndex) const { return componentInfo.size ? data + denseIndex * componentInfo.size : nullptr; }
+        void reallocate(size_t newCapacity);
+
+    private:
+        const Meta::ComponentInfo& componentInfo;
+        eastl::vector<eastl::unique_ptr<uint32_t[]>> pages;
+        eastl::vector<EntityId> entities;
+        std::byte* data = nullptr;
+        size_t capacity = 0;
+    };
+}
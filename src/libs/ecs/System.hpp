@@ -14,17 +14,27 @@ namespace RR::Ecs
     struct SystemDescription
     {
         static constexpr size_t FunctionSize = 64;
-        eastl::fixed_function<FunctionSize, void(Ecs::World&, Ecs::Event const *, ArchetypeEntitySpan span)> callback;
+        eastl::fixed_function<FunctionSize, void(Ecs::World&, Ecs::Event const *, ArchetypeEntitySpan span, const SparseFilter& sparseFilter)> callback;
+        // Delivers deferred events in batches. Could be empty, then events are delivered through callback one by one.
+        eastl::fixed_function<FunctionSize, void(Ecs::World&, const ArchetypeEventBatch& batch, const SparseFilter& sparseFilter)> eventBatchCallback;
         eastl::fixed_vector<EventId, 16> onEvents;
         eastl::fixed_vector<Meta::ComponentId, 8> require;
         eastl::fixed_vector<Meta::ComponentId, 8> produce;
         Meta::ComponentsSet tracks;
+        // Components accessed by callback, deduced from its signature. Used to find systems which could run concurrently.
+        Meta::ComponentsSet reads;
+        Meta::ComponentsSet writes;
+        // Callback has access to the world, so it can't be executed concurrently with any other system.
+        bool exclusive = false;
     };
 
     struct System
     {
         void Run() const;
 
+        // System is stored as an entity with the same id, destroying the entity destroys the system.
+        [[nodiscard]] SystemId GetId() const { return id; }
+
     private:
         friend Ecs::World;
         friend Ecs::SystemBuilder;
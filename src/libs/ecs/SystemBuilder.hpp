@@ -6,6 +6,8 @@
 #include "ecs/System.hpp"
 #include "ecs/meta/ComponentTraits.hpp"
 
+#include <EASTL/optional.h>
+
 namespace RR::Ecs
 {
     struct [[nodiscard]] SystemBuilder
@@ -82,22 +84,117 @@ namespace RR::Ecs
             return *this;
         }
 
+        // Only chunks changed since the previous run of the system are visited, see View::Changed.
+        template <typename... Components>
+        [[nodiscard]] SystemBuilder& Changed()
+        {
+            view.Changed<Components...>();
+            return *this;
+        }
+
+        // Parents are processed before their children, see View::InDepthOrder.
+        [[nodiscard]] SystemBuilder& InDepthOrder()
+        {
+            view.InDepthOrder();
+            return *this;
+        }
+
+        // Matched chunks are split into tasks and processed on the world job system, when world have one.
+        // Callback must be safe to invoke concurrently. Structural changes are deferred as usual.
+        // Event and tracking dispatch of the system stays on the calling thread.
+        [[nodiscard]] SystemBuilder& Parallel(uint32_t chunksPerTask = 1)
+        {
+            ASSERT(chunksPerTask > 0);
+            parallel = ParallelExecution {chunksPerTask};
+            return *this;
+        }
+
         template <typename Callback>
         System ForEach(Callback&& callback)
         {
 #ifdef ENABLE_ASSERTS
             Debug::ValidateLambdaArgumentsAgainstView(this->view, callback);
 #endif
-            desc.callback = [cb = std::forward<Callback>(callback)](Ecs::World& world, Ecs::Event const* event, Ecs::ArchetypeEntitySpan span) {
-                world.invokeForEntities(span, event, eastl::move(cb));
+            collectAccess<Meta::GetArgumentList<Callback>>(eastl::make_index_sequence<Meta::GetArgumentsCount<Callback>>());
+            if (!desc.onEvents.empty())
+                desc.eventBatchCallback = [cb = callback](Ecs::World& world, const ArchetypeEventBatch& batch, const SparseFilter& sparseFilter) {
+                    world.invokeForEvents(batch, sparseFilter, eastl::move(cb));
+                };
+            desc.callback = [cb = std::forward<Callback>(callback)](Ecs::World& world, Ecs::Event const* event, Ecs::ArchetypeEntitySpan span, const SparseFilter& sparseFilter) {
+                world.invokeForEntities(span, event, sparseFilter, eastl::move(cb));
+            };
+
+            return view.world.createSystem(eastl::move(desc), eastl::move(view), eastl::move(name), parallel);
+        }
+
+        // Callback is invoked once per chunk with contiguous component arrays, see Query::ForEachChunk.
+        template <typename Callback>
+        System ForEachChunk(Callback&& callback)
+        {
+#ifdef ENABLE_ASSERTS
+            Debug::ValidateChunkLambdaArgumentsAgainstView(this->view, callback);
+#endif
+            ECS_VERIFY(!view.HasSparseFilter(), "Chunks can't be filtered by sparse components.");
+            collectChunkAccess<Meta::GetArgumentList<Callback>>(eastl::make_index_sequence<Meta::GetArgumentsCount<Callback>>());
+            desc.callback = [cb = std::forward<Callback>(callback)](Ecs::World& world, Ecs::Event const* event, Ecs::ArchetypeEntitySpan span, const SparseFilter&) {
+                world.invokeForChunks(span, event, eastl::move(cb));
             };
 
-            return view.world.createSystem(eastl::move(desc), eastl::move(view), eastl::move(name));
+            return view.world.createSystem(eastl::move(desc), eastl::move(view), eastl::move(name), parallel);
+        }
+
+    private:
+        template <typename Arg>
+        void collectArgumentAccess()
+        {
+            using Component = Meta::GetComponentType<Arg>;
+
+            if constexpr (eastl::is_same_v<Component, Ecs::World>)
+                desc.exclusive = true;
+            else if constexpr (eastl::is_same_v<Component, EntityId> || eastl::is_base_of_v<Ecs::Event, Component>)
+                return; // Read only and never changed by systems.
+            else if constexpr (eastl::is_const_v<eastl::remove_pointer_t<eastl::remove_reference_t<Arg>>> ||
+                               (!eastl::is_pointer_v<Arg> && !eastl::is_reference_v<Arg>))
+                desc.reads.insert(Meta::GetComponentId<Component>);
+            else
+                desc.writes.insert(Meta::GetComponentId<Component>);
+        }
+
+        template <typename ArgumentList, size_t... Index>
+        void collectAccess(eastl::index_sequence<Index...>)
+        {
+            (collectArgumentAccess<typename ArgumentList::template Get<Index>>(), ...);
+        }
+
+        template <typename Arg>
+        void collectChunkArgumentAccess()
+        {
+            if constexpr (IsSpan<eastl::decay_t<Arg>>::value)
+            {
+                using Element = typename eastl::decay_t<Arg>::element_type;
+                using Component = eastl::remove_const_t<Element>;
+
+                if constexpr (eastl::is_same_v<Component, EntityId>)
+                    return;
+                else if constexpr (eastl::is_const_v<Element>)
+                    desc.reads.insert(Meta::GetComponentId<Component>);
+                else
+                    desc.writes.insert(Meta::GetComponentId<Component>);
+            }
+            else
+                collectArgumentAccess<Arg>();
+        }
+
+        template <typename ArgumentList, size_t... Index>
+        void collectChunkAccess(eastl::index_sequence<Index...>)
+        {
+            (collectChunkArgumentAccess<typename ArgumentList::template Get<Index>>(), ...);
         }
 
     private:
         SystemDescription desc = {};
         HashName name;
         View view;
+        eastl::optional<ParallelExecution> parallel;
     };
 }
\ No newline at end of file
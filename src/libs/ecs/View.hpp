@@ -10,24 +10,52 @@ namespace RR::Ecs
         template <typename... Components>
         View With()
         {
-            auto check = [&]([[maybe_unused]] auto id, [[maybe_unused]] auto name) {
-                ECS_VERIFY(without.find(id) == without.end(), "Component {} is already in without.", name);
+            auto check = [&]([[maybe_unused]] auto id, [[maybe_unused]] const auto& withoutSet, [[maybe_unused]] auto name) {
+                ECS_VERIFY(withoutSet.find(id) == withoutSet.end(), "Component {} is already in without.", name);
             };
-            (check(Meta::GetComponentId<Components>, Meta::GetComponentName<Components>), ...);
+            (check(Meta::GetComponentId<Components>, getWithout<Components>(), Meta::GetComponentName<Components>), ...);
 
-            (with.insert(Meta::GetComponentId<Components>), ...);
+            (getWith<Components>().insert(Meta::GetComponentId<Components>), ...);
             return *this;
         }
 
         template <typename... Components>
         View Without()
         {
-            auto check = [&]([[maybe_unused]] auto id, [[maybe_unused]] auto name) {
-                ECS_VERIFY(with.find(id) == with.end(), "Component {} is already in with.", name);
+            auto check = [&]([[maybe_unused]] auto id, [[maybe_unused]] const auto& withSet, [[maybe_unused]] auto name) {
+                ECS_VERIFY(withSet.find(id) == withSet.end(), "Component {} is already in with.", name);
             };
-            (check(Meta::GetComponentId<Components>, Meta::GetComponentName<Components>), ...);
+            (check(Meta::GetComponentId<Components>, getWith<Components>(), Meta::GetComponentName<Components>), ...);
 
-            (without.insert(Meta::GetComponentId<Components>), ...);
+            (getWithout<Components>().insert(Meta::GetComponentId<Components>), ...);
+            return *this;
+        }
+
+        // Only chunks where any of components was written since the version are visited, components are required as by With.
+        // Writes are tracked per chunk by non-const access and structural changes, so unchanged entities of changed chunk are visited too.
+        // Queries and systems filter by the version of their own last run, views by the one passed to ChangedSince.
+        // Event and tracked changes dispatch is not filtered.
+        template <typename... Components>
+        View Changed()
+        {
+            static_assert((!Meta::IsSparse<Components> && ...), "Sparse components are not stored in chunks.");
+
+            With<Components...>();
+            (changed.insert(Meta::GetComponentId<Components>), ...);
+            return *this;
+        }
+
+        // Chunks written at the version or later pass the change filter, see World::GetChangeVersion.
+        View ChangedSince(uint32_t version)
+        {
+            changedSince = version;
+            return *this;
+        }
+
+        // Matched archetypes are visited in hierarchy depth order, so parents are processed before their children.
+        View InDepthOrder()
+        {
+            depthOrdered = true;
             return *this;
         }
 
@@ -40,6 +68,14 @@ namespace RR::Ecs
 
         const Meta::ComponentsSet& GetWithSet() const { return with; }
         const Meta::ComponentsSet& GetWithoutSet() const { return without; }
+        // Sparse components are not part of archetypes, matched entities are filtered by them during iteration.
+        const Meta::ComponentsSet& GetSparseWithSet() const { return sparseWith; }
+        const Meta::ComponentsSet& GetSparseWithoutSet() const { return sparseWithout; }
+        bool HasSparseFilter() const { return !sparseWith.empty() || !sparseWithout.empty(); }
+        bool IsDepthOrdered() const { return depthOrdered; }
+        const Meta::ComponentsSet& GetChangedSet() const { return changed; }
+        bool HasChangeFilter() const { return !changed.empty(); }
+        uint32_t GetChangedSince() const { return changedSince; }
 
     private:
         friend struct World;
@@ -48,8 +84,19 @@ namespace RR::Ecs
 
         View(World& world) : world(world) { };
 
+        template <typename Component>
+        Meta::ComponentsSet& getWith() { return Meta::IsSparse<Component> ? sparseWith : with; }
+        template <typename Component>
+        Meta::ComponentsSet& getWithout() { return Meta::IsSparse<Component> ? sparseWithout : without; }
+
         World& world;
         Meta::ComponentsSet with;
         Meta::ComponentsSet without;
+        Meta::ComponentsSet sparseWith;
+        Meta::ComponentsSet sparseWithout;
+        Meta::ComponentsSet changed;
+        // Views of queries and systems are stored in their entities and updated by the world after every run.
+        mutable uint32_t changedSince = 0;
+        bool depthOrdered = false;
     };
 }
\ No newline at end of file
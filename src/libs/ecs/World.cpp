@@ -2,6 +2,7 @@
 #include "ecs/meta/ComponentTraits.hpp"
 #include "ecs/EntityBuilder.hpp"
 #include "ecs/SystemBuilder.hpp"
+#include "ecs/Serialization.hpp"
 #include <EASTL/bitvector.h>
 #include <EASTL/sort.h>
 #include <EASTL/vector_multimap.h>
@@ -89,11 +90,14 @@ namespace
 
 namespace RR::Ecs
 {
-    World::World() : creationThreadID(std::this_thread::get_id()), queriesView(*this), systemsView(*this)
+    World::World(const ChunkPoolDescription& chunkPoolDescription)
+        : creationThreadID(std::this_thread::get_id()), chunkPool(chunkPoolDescription), queriesView(*this), systemsView(*this)
     {
         RegisterComponent<EntityId>();
         RegisterComponent<Ecs::View>();
         RegisterComponent<MatchedArchetypeCache>();
+        // Registered upfront, as archetypes of depth tags are created by snapshots and deltas as well.
+        details::RegisterHierarchyComponents(metaStorage, eastl::make_index_sequence<MaxHierarchyDepth>());
 
         queriesView.With<Ecs::View, MatchedArchetypeCache>();
         systemsView.With<Ecs::View, SystemDescription, MatchedArchetypeCache>();
@@ -109,7 +113,7 @@ namespace RR::Ecs
 
             ArchetypeId archetypeId = GetArchetypeIdForComponents(Meta::SortedComponentsView(components));
             Archetype& archetype = createArchetypeNoCache(archetypeId, Meta::SortedComponentsView(components));
-            archetypesCache.push_back(&archetype);
+            archetypeIndex.Add(archetype);
         }
 
         queriesQuery = Query().With<Ecs::View, MatchedArchetypeCache>().Without<SystemDescription>().Build().id;
@@ -118,21 +122,114 @@ namespace RR::Ecs
 
     void World::Destroy(EntityId entityId)
     {
-        ASSERT_IS_CREATION_THREAD;
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        const auto guard = parallelGuard();
+        if UNLIKELY (inParallelExecution && !claimForTask(entityId))
+            return;
+
         if (!IsAlive(entityId)) return;
 
         if (IsLocked())
         {
             entityStorage.PendingDestroy(entityId);
-            commandBuffer.Destroy(entityId);
+            getCommandBuffer().Destroy(entityId);
         }
         else
             destroyImpl(entityId);
     }
 
-    Ecs::EntityBuilder<void, void> World::Entity()
+    bool World::claimForTask(EntityId entityId)
+    {
+        ASSERT(inParallelExecution);
+        ASSERT(taskCommandBuffer);
+
+        const bool reserved = entityStorage.IsReserved(entityId);
+        if LIKELY (!reserved)
+        {
+            const auto [it, claimed] = taskEditOwners.try_emplace(entityId, taskCommandBuffer);
+            if LIKELY (claimed || it->second == taskCommandBuffer)
+                return true;
+        }
+
+        if (!rejectedTaskEdit.entityId)
+            rejectedTaskEdit = {entityId, reserved};
+
+        return false;
+    }
+
+    void World::DestroyEntities(const Ecs::View& view)
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        if UNLIKELY (view.HasSparseFilter() || view.HasChangeFilter())
+        {
+            // Entities are filtered one by one, so collected first and destroyed through the generic path.
+            eastl::vector<EntityId> entities;
+            query(view, [&entities](EntityId entityId) { entities.push_back(entityId); });
+            DestroyEntities(eastl::span<const EntityId>(entities.data(), entities.size()));
+            return;
+        }
+
+        eastl::fixed_vector<Archetype*, 16> archetypes;
+        archetypeIndex.ForEachMatched(Meta::SortedComponentsView(view.with), Meta::SortedComponentsView(view.without), [&archetypes](Archetype& archetype) {
+            if (archetype.GetEntitiesCount() > 0)
+                archetypes.push_back(&archetype);
+        });
+
+        if (IsLocked())
+        {
+            // Structural changes are deferred, so entities are destroyed one by one.
+            for (const auto* archetype : archetypes)
+                for (auto index = archetype->begin(); index != archetype->end(); index = archetype->inc(index))
+                    Destroy(archetype->GetEntityIdData(index));
+            return;
+        }
+
+        LockGuard lg(this);
+        for (auto* archetype : archetypes)
+        {
+            const ArchetypeEntitySpan span(*archetype, archetype->begin(), archetype->end());
+
+            // Dying entities are already dead for structural changes made by OnDissapear subscribers.
+            for (auto index = span.begin; index != span.end; index = archetype->inc(index))
+                entityStorage.PendingDestroy(archetype->GetEntityIdData(index));
+
+            // Children out of the view are destroyed on unlock.
+            if UNLIKELY (!hierarchyChildren.empty())
+                for (auto index = span.begin; index != span.end; index = archetype->inc(index))
+                    unlinkFromHierarchy(archetype->GetEntityIdData(index));
+
+            const auto it = archetype->cache.find(GetEventId<OnDissapear>);
+            if (it != archetype->cache.end())
+                for (const auto systemId : it->second)
+                    dispatchEventImmediately(span, systemId, OnDissapear {});
+
+            const bool replicated = !details::IsRuntimeArchetype(*archetype);
+            for (auto index = span.begin; index != span.end; index = archetype->inc(index))
+            {
+                const EntityId entityId = archetype->GetEntityIdData(index);
+                removeFromSparseSets(entityId);
+                entityStorage.Destroy(entityId);
+                if (replicated)
+                    deltaJournal.Destroy(entityId);
+            }
+
+            invalidateCompiledSystems(*archetype);
+            archetype->Clear();
+        }
+    }
+
+    void World::DestroyEntities(eastl::span<const EntityId> entities)
     {
         ASSERT_IS_CREATION_THREAD;
+
+        for (const auto entityId : entities)
+            Destroy(entityId);
+    }
+
+    Ecs::EntityBuilder<void, void> World::Entity()
+    {
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
         return EntityBuilder<void, void>(*this, {});
     }
 
@@ -146,16 +243,182 @@ namespace RR::Ecs
     SystemBuilder World::System() { return Ecs::SystemBuilder(*this); }
     SystemBuilder World::System(const HashName& name) { return Ecs::SystemBuilder(*this, name); }
 
+    template <typename Callback>
+    void World::withCompiledSystem(SystemId systemId, Callback&& callback) const
+    {
+        if LIKELY (!systemsOrderDirty)
+        {
+            if (const CompiledSystem* system = findCompiledSystem(systemId))
+                callback(*system);
+            return;
+        }
+
+        // Compiled systems could be dangling until the next ordering, so system is resolved through its entity.
+        // Destroyed systems and systems, which creation is not applied yet, are skipped.
+        EntityRecord record;
+        if (!ResolveEntityRecord(EntityId(systemId.GetRaw()), record) || record.HasPendingChanges())
+            return;
+
+        systemsView.ForEntity(EntityId(systemId.GetRaw()), [systemId, &callback](const SystemDescription& desc, const Ecs::View& view, MatchedArchetypeCache& cache, const ParallelExecution* parallel) {
+            callback(CompiledSystem {systemId, &desc, &view, &cache, parallel, nullptr});
+        });
+    }
+
     void World::RunSystem(SystemId systemId) const
     {
         ASSERT_IS_CREATION_THREAD;
-        systemsView.ForEntity(EntityId(systemId.GetRaw()), [](World& world, const SystemDescription& desc, MatchedArchetypeCache& cache) {
-            for (auto archetype : cache)
+
+        // Not ordered systems are not compiled yet, so resolved through the system entity.
+        withCompiledSystem(systemId, [this](const CompiledSystem& system) { runSystem(system); });
+    }
+
+    void World::runSystem(const CompiledSystem& system) const
+    {
+        World& world = getMutableWorld();
+
+        SparseFilter sparseFilter;
+        if (!world.makeSparseFilter(*system.view, sparseFilter))
+            return;
+
+        SystemProfile* systemProfile = getSystemProfile(system);
+        const uint64_t recordedCommands = CommandBuffer::GetRecordedOnThread();
+
+        {
+            const ProfileScope scope(systemProfile ? &systemProfile->runTime : nullptr);
+            const auto spanCallback = [&world, &system, &sparseFilter](ArchetypeEntitySpan span) { system.desc->callback(world, nullptr, span, sparseFilter); };
+            if (system.parallel)
+                world.dispatchParallel(*system.cache, *system.view, *system.parallel, spanCallback);
+            else
             {
-                const ArchetypeEntitySpan span(*archetype, archetype->begin(), archetype->end());
-                desc.callback(world, nullptr, span);
+                for (auto archetype : *system.cache)
+                    forEachChangedSpan(*archetype, *system.view, spanCallback);
             }
-        });
+        }
+        world.finishRun(*system.view);
+
+        if UNLIKELY (systemProfile)
+            profileRun(*systemProfile, *system.cache, CommandBuffer::GetRecordedOnThread() - recordedCommands);
+    }
+
+    void World::RunSystems()
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT(!IsLocked());
+        ASSERT_MSG(!systemsOrderDirty, "Systems should be ordered before running.");
+
+        ranSystems.clear();
+        bool reordered = false;
+        size_t waveIndex = 0;
+        while (waveIndex < executionPlan.waves.size())
+        {
+            runWave(executionPlan.waves[waveIndex++], reordered);
+
+            // Systems were created or destroyed by the wave, so compiled systems of the next waves could be dangling.
+            // Plan is rebuilt and the run continues from its beginning with systems, which have not run yet.
+            if UNLIKELY (systemsOrderDirty)
+            {
+                OrderSystems();
+                reordered = true;
+                waveIndex = 0;
+            }
+        }
+    }
+
+    void World::runWave(const ExecutionPlan::Wave& wave, bool skipRan)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        using Clock = std::chrono::steady_clock;
+
+        struct Task
+        {
+            ExecutionPlan::Node* node;
+            const SystemDescription* desc;
+            const Ecs::View* view;
+            const MatchedArchetypeCache* cache;
+            SystemProfile* profile;
+            SparseFilter sparseFilter;
+        };
+
+        eastl::fixed_vector<Task, 16> concurrentTasks;
+        eastl::fixed_vector<ExecutionPlan::Node*, 16> callingThreadNodes;
+
+        for (const auto index : wave)
+        {
+            ExecutionPlan::Node& node = executionPlan.nodes[index];
+            if UNLIKELY (skipRan && eastl::find(ranSystems.begin(), ranSystems.end(), node.id) != ranSystems.end())
+                continue;
+
+            if (node.exclusive || node.chunkParallel)
+            {
+                callingThreadNodes.push_back(&node);
+                continue;
+            }
+
+            const CompiledSystem* system = findCompiledSystem(node.id);
+            if (!system)
+                continue;
+
+            SparseFilter sparseFilter;
+            if (makeSparseFilter(*system->view, sparseFilter))
+                concurrentTasks.push_back({&node, system->desc, system->view, system->cache, getSystemProfile(*system), eastl::move(sparseFilter)});
+        }
+
+        // Tasks of the wave are different systems, so each one updates own profile entry.
+        const auto runTask = [this](const Task& task) {
+            const uint64_t recordedCommands = CommandBuffer::GetRecordedOnThread();
+            const auto start = Clock::now();
+            for (const auto* archetype : *task.cache)
+                forEachChangedSpan(*archetype, *task.view, [this, &task](ArchetypeEntitySpan span) { task.desc->callback(*this, nullptr, span, task.sparseFilter); });
+            task.node->lastDuration = Clock::now() - start;
+
+            if UNLIKELY (task.profile)
+            {
+                task.profile->runTime += task.node->lastDuration;
+                profileRun(*task.profile, *task.cache, CommandBuffer::GetRecordedOnThread() - recordedCommands);
+            }
+        };
+
+        if (jobSystem && parallelSystems && concurrentTasks.size() > 1)
+        {
+            // Commands and events are merged in the execution plan order, so they don't depend on scheduling.
+            for (const auto& task : concurrentTasks)
+                ranSystems.push_back(task.node->id);
+
+            LockGuard lg(this);
+            dispatchTasks(static_cast<uint32_t>(concurrentTasks.size()), [&concurrentTasks, &runTask](uint32_t index) { runTask(concurrentTasks[index]); });
+        }
+        else
+        {
+            for (const auto& task : concurrentTasks)
+            {
+                if UNLIKELY (systemsOrderDirty)
+                    return;
+
+                ranSystems.push_back(task.node->id);
+                runTask(task);
+            }
+        }
+
+        // Concurrent tasks run at the same version, as they never write components read by each other.
+        // Systems could be created or destroyed by the tasks, views of the tasks could be moved then.
+        if (!concurrentTasks.empty())
+        {
+            advanceChangeVersion();
+            for (const auto& task : concurrentTasks)
+                withCompiledSystem(task.node->id, [this](const CompiledSystem& system) { system.view->changedSince = changeVersion; });
+        }
+
+        for (auto* node : callingThreadNodes)
+        {
+            if UNLIKELY (systemsOrderDirty)
+                return;
+
+            ranSystems.push_back(node->id);
+            const auto start = Clock::now();
+            if (const CompiledSystem* system = findCompiledSystem(node->id))
+                runSystem(*system);
+            node->lastDuration = Clock::now() - start;
+        }
     }
 
     void World::OrderSystems()
@@ -176,11 +439,12 @@ namespace RR::Ecs
             SystemId id;
             uint32_t index = 0xFFFFFFFF;
             HashName hashName;
+            bool chunkParallel = false;
         };
 
         eastl::vector<SystemHandle> tmpSystemList;
-        Ecs::Query(*this, systemsQuery).ForEach([&tmpSystemList](EntityId id, const SystemDescription& desc, const HashName& hashName) {
-            tmpSystemList.emplace_back(desc, SystemId(id.GetRaw()), hashName);
+        Ecs::Query(*this, systemsQuery).ForEach([&tmpSystemList](EntityId id, const SystemDescription& desc, const HashName& hashName, const ParallelExecution* parallel) {
+            tmpSystemList.emplace_back(desc, SystemId(id.GetRaw()), hashName).chunkParallel = parallel != nullptr;
         });
 
         // Sort by id to avoid depending on native ES registration order
@@ -230,10 +494,36 @@ namespace RR::Ecs
             systemsOrder[system.id] = static_cast<uint32_t>(i);
         }
 
+        {
+            // Systems without events and tracking are executed by RunSystems.
+            static constexpr uint32_t NotScheduled = 0xFFFFFFFF;
+            eastl::vector<uint32_t> scheduledIndices(tmpSystemList.size(), NotScheduled);
+            eastl::vector<ExecutionPlan::SystemInfo> scheduledSystems;
+
+            for (const auto sortedIndex : sortedList)
+            {
+                const auto& system = tmpSystemList[sortedIndex];
+                if (!system.desc->onEvents.empty() || !system.desc->tracks.empty())
+                    continue;
+
+                ExecutionPlan::SystemInfo info {system.id, system.hashName, system.desc, system.chunkParallel, {}};
+
+                const auto range = edges.equal_range(system.index);
+                for (auto edge = range.first; edge != range.second; ++edge)
+                    if (scheduledIndices[edge->second] != NotScheduled)
+                        info.producers.push_back(scheduledIndices[edge->second]);
+
+                scheduledIndices[sortedIndex] = static_cast<uint32_t>(scheduledSystems.size());
+                scheduledSystems.push_back(eastl::move(info));
+            }
+
+            executionPlan.Build(scheduledSystems);
+        }
+
         for (auto& eventSubscribersPair : eventSubscribers)
             eastl::sort(eventSubscribersPair.second.begin(), eventSubscribersPair.second.end(), [&systemsOrder](auto a, auto b) { return systemsOrder[a] < systemsOrder[b]; });
 
-        for (auto* archetype : archetypesCache)
+        for (auto* archetype : archetypeIndex.GetArchetypes())
         {
             for (auto& cache : archetype->cache)
                 eastl::sort(cache.second.begin(), cache.second.end(), [&systemsOrder](auto a, auto b) { return systemsOrder[a] < systemsOrder[b]; });
@@ -257,19 +547,72 @@ namespace RR::Ecs
                 Ecs::Entity(*this, EntityId(tmpSystemList[sortedIndex].id.GetRaw())).Edit().Remove<OrderTag>().Apply();
         }
 
+        {
+            eastl::vector<SystemId> orderedSystems;
+            orderedSystems.reserve(sortedList.size());
+            for (const auto sortedIndex : sortedList)
+                orderedSystems.push_back(tmpSystemList[sortedIndex].id);
+
+            compileSystems({orderedSystems.data(), orderedSystems.size()});
+        }
+
         systemsOrderDirty = false;
     }
 
+    void World::compileSystems(eastl::span<const SystemId> orderedSystems)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT(!IsLocked());
+
+        compiledSystems.clear();
+        compiledSystemIndices.clear();
+        compiledSystems.reserve(orderedSystems.size());
+        compiledSystemIndices.reserve(orderedSystems.size());
+        // Reserved, so profile entries are not moved.
+        profile.systems.clear();
+        profile.systems.reserve(orderedSystems.size());
+
+        for (const auto systemId : orderedSystems)
+        {
+            systemsView.ForEntity(EntityId(systemId.GetRaw()), [this, systemId](const SystemDescription& desc, const Ecs::View& view, MatchedArchetypeCache& cache, const ParallelExecution* parallel, const HashName* name) {
+                SystemProfile& systemProfile = profile.systems.emplace_back();
+                systemProfile.id = systemId;
+                if (name)
+                    systemProfile.name = *name;
+
+                compiledSystemIndices[systemId] = static_cast<uint32_t>(compiledSystems.size());
+                compiledSystems.push_back({systemId, &desc, &view, &cache, parallel, &systemProfile});
+            });
+        }
+    }
+
+    const World::CompiledSystem* World::findCompiledSystem(SystemId systemId) const
+    {
+        ASSERT_MSG(!systemsOrderDirty, "Systems should be ordered before dispatch.");
+
+        const auto it = compiledSystemIndices.find(systemId);
+        return it != compiledSystemIndices.end() ? &compiledSystems[it->second] : nullptr;
+    }
+
     void World::ProcessDefferedEvents()
     {
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
 
-        eventStorage.ProcessEvents([this](EntityId entityId, const Ecs::Event& event) {
-            if (entityId)
-                unicastEventImmediately(entityId, event);
-            else
-                broadcastEventImmediately(event);
+        eventStorage.ProcessEvents([this](eastl::span<const EventStorage::EventRecord> events) {
+            // Broadcast events split unicast ones into runs, so their relative order is kept.
+            auto runBegin = events.begin();
+            for (auto it = events.begin(); it != events.end(); ++it)
+            {
+                if (it->entityId)
+                    continue;
+
+                unicastDeferredEvents({runBegin, it});
+                broadcastEventImmediately(*it->event);
+                runBegin = eastl::next(it);
+            }
+
+            unicastDeferredEvents({runBegin, events.end()});
         });
     }
 
@@ -278,7 +621,8 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
 
-        for (auto* archetype : archetypesCache)
+        const ProfileScope scope(profilingEnabled ? &profile.trackedChangesTime : nullptr);
+        for (auto* archetype : archetypeIndex.GetArchetypes())
             archetype->ProcessTrackedChanges(*this);
     }
 
@@ -287,6 +631,7 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
         OrderSystems();
+        RunSystems();
         // Update events;
 
         ProcessDefferedEvents();
@@ -297,41 +642,190 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
 
+        // Descendants are destroyed first, so they never refer to dead parent.
+        if UNLIKELY (!hierarchyChildren.empty())
+            unlinkFromHierarchy(entityId);
+
         EntityRecord record;
         if (ResolveEntityRecord(entityId, record))
         {
             unicastEventImmediately(entityId, OnDissapear {});
+            invalidateCompiledSystems(*record.GetArchetype(false));
             record.GetArchetype(false)->Delete(entityStorage, record.GetIndex(false), false);
+
+            if (!details::IsRuntimeArchetype(*record.GetArchetype(false)))
+                deltaJournal.Destroy(entityId);
         }
 
+        removeFromSparseSets(entityId);
+
         entityStorage.Destroy(entityId);
     }
 
-    Ecs::System World::createSystem(SystemDescription&& desc, Ecs::View&& view, HashName&& name)
+    uint32_t GetCurrentChangeVersion(const World& world)
+    {
+        return world.GetChangeVersion();
+    }
+
+    void World::AdvanceChangeVersion(uint32_t count)
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        // Advanced by steps, so stale versions are clamped before their distance overflows.
+        while (count > 0)
+        {
+            const uint32_t step = eastl::min(count, VersionsCheckInterval);
+            changeVersion += step - 1;
+            advanceChangeVersion();
+            count -= step;
+        }
+    }
+
+    void World::checkChangeVersions()
+    {
+        ASSERT(!inParallelExecution);
+        lastVersionsCheck = changeVersion;
+
+        uint32_t oldestVersion = changeVersion - MaxVersionAge;
+        oldestVersion += oldestVersion == 0;
+        const auto clamp = [this, oldestVersion](uint32_t& version) {
+            if (version != 0 && changeVersion - version > MaxVersionAge)
+                version = oldestVersion;
+        };
+
+        for (const auto& [archetypeId, archetype] : archetypesMap)
+            archetype->ForEachChangeVersion(clamp);
+
+        Ecs::Query(*this, queriesQuery).ForEach([&clamp](Ecs::View& view) { clamp(view.changedSince); });
+        Ecs::Query(*this, systemsQuery).ForEach([&clamp](Ecs::View& view) { clamp(view.changedSince); });
+    }
+
+    SparseSet* FindSparseSet(World& world, Meta::ComponentId componentId)
+    {
+        const auto it = world.sparseSets.find(componentId);
+        return it != world.sparseSets.end() ? it->second.get() : nullptr;
+    }
+
+    SparseSet& World::getOrCreateSparseSet(Meta::ComponentId componentId)
     {
         ASSERT_IS_CREATION_THREAD;
-        Ecs::Entity entt = Entity()
-                               .Add<Ecs::View>(eastl::forward<Ecs::View>(view))
-                               .Add<MatchedArchetypeCache>()
-                               .Add<SystemDescription>(eastl::forward<SystemDescription>(desc))
-                               .Add<HashName>(eastl::forward<HashName>(name))
-                               .Apply();
+        ASSERT(!IsLocked());
+
+        auto& sparseSet = sparseSets[componentId];
+        if (!sparseSet)
+            sparseSet = eastl::make_unique<SparseSet>(metaStorage[componentId]);
+
+        return *sparseSet;
+    }
+
+    bool World::makeSparseFilter(const Ecs::View& view, SparseFilter& sparseFilter) const
+    {
+        if LIKELY (!view.HasSparseFilter())
+            return true;
+
+        for (const auto componentId : view.GetSparseWithSet())
+        {
+            const auto it = sparseSets.find(componentId);
+            if (it == sparseSets.end() || it->second->GetSize() == 0)
+                return false;
+
+            sparseFilter.with.push_back(it->second.get());
+        }
+
+        for (const auto componentId : view.GetSparseWithoutSet())
+        {
+            const auto it = sparseSets.find(componentId);
+            if (it != sparseSets.end() && it->second->GetSize() != 0)
+                sparseFilter.without.push_back(it->second.get());
+        }
+
+        return true;
+    }
+
+    bool World::isSparse(Meta::ComponentId componentId) const
+    {
+        const auto it = metaStorage.find(componentId);
+        return it != metaStorage.end() && it->second->isSparse;
+    }
+
+    void World::addSparseComponent(EntityId entityId, Meta::ComponentId componentId, void* data)
+    {
+        ASSERT(!IsLocked());
+
+        SparseSet& sparseSet = getOrCreateSparseSet(componentId);
+        const Meta::ComponentInfo& componentInfo = sparseSet.GetComponentInfo();
+
+        const bool added = !sparseSet.Has(entityId);
+        if (added)
+        {
+            deltaJournal.Touch(entityId);
+            void* component = sparseSet.Emplace(entityId);
+            if (componentInfo.size)
+                componentInfo.move(component, data);
+        }
+
+        // Source is owned by command buffer, it's destroyed even if component is not added.
+        if (data && componentInfo.destructor)
+            componentInfo.destructor(data);
+
+        // We could silent this error, if it's would be a case reconsider this.
+        ECS_VERIFY(added, "Can't add component {}. Only new components can be added.", componentInfo.name);
+    }
+
+    void World::removeSparseComponent(EntityId entityId, Meta::ComponentId componentId)
+    {
+        if (IsLocked())
+        {
+            getCommandBuffer().RemoveSparse(entityId, componentId);
+            return;
+        }
+
+        const auto it = sparseSets.find(componentId);
+        [[maybe_unused]] const bool removed = it != sparseSets.end() && it->second->Remove(entityId);
+        if (removed)
+            deltaJournal.Touch(entityId);
+
+        // We could silent this error, if it's would be a case reconsider this.
+        ECS_VERIFY(removed, "Can't remove component {}. Component is not present.", metaStorage[componentId].name);
+    }
+
+    void World::removeFromSparseSets(EntityId entityId)
+    {
+        for (auto& [componentId, sparseSet] : sparseSets)
+            sparseSet->Remove(entityId);
+    }
+
+    Ecs::System World::createSystem(SystemDescription&& desc, Ecs::View&& view, HashName&& name, const eastl::optional<ParallelExecution>& parallel)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ECS_VERIFY(!parallel || !view.IsDepthOrdered(), "Depth ordered system can't be executed in parallel.");
+        auto builder = Entity()
+                           .Add<Ecs::View>(eastl::forward<Ecs::View>(view))
+                           .Add<MatchedArchetypeCache>()
+                           .Add<SystemDescription>(eastl::forward<SystemDescription>(desc))
+                           .Add<HashName>(eastl::forward<HashName>(name));
+        Ecs::Entity entt = parallel ? builder.Add<ParallelExecution>(*parallel).Apply() : builder.Apply();
 
         const auto systemId = SystemId(entt.GetId().GetRaw());
-        initCache(systemId);
+        // Systems created by running systems are matched, once their entities are committed.
+        if (IsLocked())
+            commandBuffer.InitCache(systemId);
+        else
+            initCache(systemId);
 
         systemsOrderDirty = true;
 
         return Ecs::System(*this, systemId);
     }
 
-    Query World::createQuery(Ecs::View&& view)
+    Query World::createQuery(Ecs::View&& view, const eastl::optional<ParallelExecution>& parallel)
     {
         ASSERT_IS_CREATION_THREAD;
-        Ecs::Entity entt = Entity()
-                               .Add<Ecs::View>(eastl::forward<Ecs::View>(view))
-                               .Add<MatchedArchetypeCache>()
-                               .Apply();
+        ECS_VERIFY(!parallel || !view.IsDepthOrdered(), "Depth ordered query can't be executed in parallel.");
+        auto builder = Entity()
+                           .Add<Ecs::View>(eastl::forward<Ecs::View>(view))
+                           .Add<MatchedArchetypeCache>();
+        Ecs::Entity entt = parallel ? builder.Add<ParallelExecution>(*parallel).Apply() : builder.Apply();
 
         const auto queryId = QueryId(QueryId::FromValue(entt.GetId().GetRaw()));
         initCache(queryId);
@@ -344,18 +838,14 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
         systemsView.ForEntity(EntityId(id.GetRaw()), [id, this](MatchedArchetypeCache& cache, SystemDescription& systemDesc, Ecs::View& view) {
-            for (auto* archetype : archetypesCache)
-            {
-                if LIKELY (!matches(*archetype, view))
-                    continue;
-
-                cache.push_back(archetype);
+            archetypeIndex.ForEachMatched(Meta::SortedComponentsView(view.with), Meta::SortedComponentsView(view.without), [id, &cache, &systemDesc, &view](Archetype& archetype) {
+                addToCache(cache, view, archetype);
                 for (const auto event : systemDesc.onEvents)
-                    archetype->cache[event].push_back(id);
+                    archetype.cache[event].push_back(id);
 
                 if (!systemDesc.tracks.empty())
-                    archetype->UpdateTrackedCache(id, systemDesc.tracks);
-            }
+                    archetype.UpdateTrackedCache(id, systemDesc.tracks);
+            });
 
             for (const auto event : systemDesc.onEvents)
                 eventSubscribers[event].push_back(id);
@@ -367,13 +857,9 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
         queriesView.ForEntity(EntityId(id.GetRaw()), [this](MatchedArchetypeCache& cache, Ecs::View& view) {
-            for (const auto* archetype : archetypesCache)
-            {
-                if LIKELY(!matches(*archetype, view))
-                    continue;
-
-                cache.push_back(archetype);
-            }
+            archetypeIndex.ForEachMatched(Meta::SortedComponentsView(view.with), Meta::SortedComponentsView(view.without), [&cache, &view](Archetype& archetype) {
+                addToCache(cache, view, archetype);
+            });
         });
     }
 
@@ -382,13 +868,13 @@ namespace RR::Ecs
         ASSERT_IS_CREATION_THREAD;
         ASSERT(!IsLocked());
 
-        archetypesCache.push_back(&archetype);
+        archetypeIndex.Add(archetype);
 
         Ecs::Query(*this, queriesQuery).ForEach([&archetype](Ecs::View& view, MatchedArchetypeCache& cache) {
             if LIKELY (!matches(archetype, view))
                 return;
 
-            cache.push_back(&archetype);
+            addToCache(cache, view, archetype);
         });
 
         Ecs::Query(*this, systemsQuery).ForEach([&archetype](EntityId id, Ecs::View& view, MatchedArchetypeCache& cache, SystemDescription& systemDesc) {
@@ -396,7 +882,7 @@ namespace RR::Ecs
                 return;
 
             const SystemId systemId = SystemId(id.GetRaw());
-            cache.push_back(&archetype);
+            addToCache(cache, view, archetype);
 
             for (const auto event : systemDesc.onEvents)
                 archetype.cache[event].push_back(systemId);
@@ -408,20 +894,27 @@ namespace RR::Ecs
 
     Archetype& World::createArchetypeNoCache(ArchetypeId archetypeId, Meta::SortedComponentsView components)
     {
-        ASSERT_IS_CREATION_THREAD;
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
 
         auto* archetype = archetypesMap.emplace(archetypeId,
                                                 eastl::make_unique<Archetype>(
+                                                    chunkPool,
+                                                    changeVersion,
                                                     Meta::ComponentInfoIterator(metaStorage, components.begin()),
                                                     Meta::ComponentInfoIterator(metaStorage, components.end())))
                               .first->second.get();
 
+        if (archetype->GetComponentIndex<ChildOf>())
+            for (uint32_t depth = 1; depth <= MaxHierarchyDepth && !archetype->hierarchyDepth; depth++)
+                if (archetype->GetComponentIndex(details::GetHierarchyDepthId(depth)))
+                    archetype->hierarchyDepth = depth;
+
         return *archetype;
     }
 
     Archetype& World::getOrCreateArchetype(ArchetypeId archetypeId, Meta::SortedComponentsView components)
     {
-        ASSERT_IS_CREATION_THREAD;
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
         Archetype* archetype = nullptr;
 
         auto it = archetypesMap.find(archetypeId);
@@ -429,6 +922,10 @@ namespace RR::Ecs
         {
             archetype = &createArchetypeNoCache(archetypeId, components);
 
+            // Prefabs are never matched, so their archetypes are not indexed.
+            if (archetype->GetComponentIndex<Prefab>())
+                return *archetype;
+
             if (IsLocked())
                 commandBuffer.InitCache(*archetype);
             else
@@ -496,20 +993,29 @@ namespace RR::Ecs
     void World::broadcastEventImmediately(const Ecs::Event& event) const
     {
         ASSERT_IS_CREATION_THREAD;
-        ASSERT(!systemsOrderDirty);
 
         const auto it = eventSubscribers.find(event.id);
         if (it == eventSubscribers.end())
             return;
 
+        World& world = getMutableWorld();
         for (const auto systemId : it->second)
         {
-            systemsView.ForEntity(EntityId(systemId.GetRaw()), [&event](World& world, const SystemDescription& desc, MatchedArchetypeCache& cache) {
-                for (auto archetype : cache)
+            withCompiledSystem(systemId, [this, &world, &event](const CompiledSystem& system) {
+                SparseFilter sparseFilter;
+                if (!makeSparseFilter(*system.view, sparseFilter))
+                    return;
+
+                SystemProfile* systemProfile = getSystemProfile(system);
+                const ProfileScope scope(systemProfile ? &systemProfile->eventTime : nullptr);
+                for (auto archetype : *system.cache)
                 {
                     const ArchetypeEntitySpan span(*archetype, archetype->begin(), archetype->end());
-                    desc.callback(world, &event, span);
+                    system.desc->callback(world, &event, span, sparseFilter);
                 }
+
+                if UNLIKELY (systemProfile)
+                    systemProfile->eventDispatches += static_cast<uint32_t>(system.cache->size());
             });
         }
     }
@@ -517,39 +1023,47 @@ namespace RR::Ecs
     void World::dispatchEventImmediately(ArchetypeEntitySpan span, SystemId systemId, const Ecs::Event& event) const
     {
         ASSERT_IS_CREATION_THREAD;
-        ASSERT(!systemsOrderDirty);
+        withCompiledSystem(systemId, [this, span, &event](const CompiledSystem& system) { dispatchEvent(system, span, event); });
+    }
 
-        systemsView.ForEntity(EntityId(systemId.GetRaw()), [&event, span](World& world, const SystemDescription& desc) {
-            // TODO check span is valid for this system.
-            desc.callback(world, &event, span);
-        });
+    void World::dispatchEvent(const CompiledSystem& system, ArchetypeEntitySpan span, const Ecs::Event& event) const
+    {
+        SparseFilter sparseFilter;
+        if (!makeSparseFilter(*system.view, sparseFilter))
+            return;
+
+        SystemProfile* systemProfile = getSystemProfile(system);
+        const ProfileScope scope(systemProfile ? &systemProfile->eventTime : nullptr);
+        if UNLIKELY (systemProfile)
+            systemProfile->eventDispatches++;
+
+        // TODO check span is valid for this system.
+        system.desc->callback(getMutableWorld(), &event, span, sparseFilter);
     }
 
     void World::dispatchEventImmediately(EntityId entityId, SystemId systemId, const Ecs::Event& event) const
     {
         ASSERT_IS_CREATION_THREAD;
         ASSERT(entityId);
-        ASSERT(!systemsOrderDirty);
 
-        systemsView.ForEntity(EntityId(systemId.GetRaw()), [&event, entityId](World& world, const SystemDescription& desc) {
+        withCompiledSystem(systemId, [this, entityId, &event](const CompiledSystem& system) {
             // Todo check entity are ok for  Args
             EntityRecord record;
-            [[maybe_unused]] const bool resolved = world.ResolveEntityRecord(entityId, record);
+            [[maybe_unused]] const bool resolved = ResolveEntityRecord(entityId, record);
             ASSERT(resolved);
 
             // TODO check entity archetype is valid for this system.
             const Archetype* archetype = record.GetArchetype(false);
             ArchetypeEntityIndex index = record.GetIndex(false);
 
-            const ArchetypeEntitySpan span(*archetype, index, archetype->inc(index));
-            desc.callback(world, &event, span);
+            dispatchEvent(system, ArchetypeEntitySpan(*archetype, index, archetype->inc(index)), event);
         });
     }
 
     void World::unicastEventImmediately(EntityId entity, const Ecs::Event& event) const
     {
+        // Order is checked once there are subscribers, so entities could be destroyed after systems are destroyed.
         ASSERT_IS_CREATION_THREAD;
-        ASSERT(!systemsOrderDirty);
 
         EntityRecord record;
         if (!ResolveEntityRecord(entity, record))
@@ -564,4 +1078,84 @@ namespace RR::Ecs
         for (const auto systemId : subscribers)
             dispatchEventImmediately(entity, systemId, event);
     }
+
+    void World::unicastDeferredEvents(eastl::span<const EventStorage::EventRecord> events)
+    {
+        ASSERT_IS_CREATION_THREAD;
+
+        if (events.empty())
+            return;
+
+        // Tick orders systems created or destroyed by running systems before deferred events are processed.
+        ASSERT_MSG(!systemsOrderDirty, "Systems should be ordered before deferred events are processed.");
+
+        deferredEvents.clear();
+        deferredEventGroups.clear();
+        for (const auto& [entityId, event, frames, alignment] : events)
+        {
+            UNUSED(frames, alignment);
+            EntityRecord record;
+            if (!ResolveEntityRecord(entityId, record))
+                continue;
+
+            const Archetype* archetype = record.GetArchetype(false);
+            if (archetype->cache.find(event->id) == archetype->cache.end())
+                continue;
+
+            const uint32_t group = deferredEventGroups.try_emplace({event->id.GetRaw(), archetype}, uint32_t(deferredEventGroups.size())).first->second;
+            deferredEvents.push_back({group, event->id, archetype, entityId, {record.GetIndex(false), event}});
+        }
+
+        // Stable, so events within the group are kept in emission order.
+        if (deferredEventGroups.size() > 1)
+            eastl::stable_sort(deferredEvents.begin(), deferredEvents.end(), [](const DeferredEvent& lhs, const DeferredEvent& rhs) { return lhs.group < rhs.group; });
+
+        // Structural changes made by subscribers are applied after all groups are delivered, so resolved indices stay valid.
+        LockGuard lg(this);
+
+        for (auto groupBegin = deferredEvents.begin(); groupBegin != deferredEvents.end();)
+        {
+            const auto groupEnd = eastl::find_if(groupBegin, deferredEvents.end(), [groupBegin](const DeferredEvent& deferredEvent) {
+                return deferredEvent.group != groupBegin->group;
+            });
+
+            const Archetype& archetype = *groupBegin->archetype;
+            for (const auto systemId : archetype.cache.find(groupBegin->eventId)->second)
+            {
+                // Entities destroyed by previous subscribers are skipped.
+                eventBatchRecords.clear();
+                for (auto it = groupBegin; it != groupEnd; ++it)
+                    if (IsAlive(it->entityId))
+                        eventBatchRecords.push_back(it->record);
+
+                if (eventBatchRecords.empty())
+                    break;
+
+                withCompiledSystem(systemId, [this, &archetype](const CompiledSystem& system) {
+                    SparseFilter sparseFilter;
+                    if (!makeSparseFilter(*system.view, sparseFilter))
+                        return;
+
+                    SystemProfile* systemProfile = getSystemProfile(system);
+                    const ProfileScope scope(systemProfile ? &systemProfile->eventTime : nullptr);
+                    if (system.desc->eventBatchCallback)
+                    {
+                        if UNLIKELY (systemProfile)
+                            systemProfile->eventDispatches++;
+
+                        system.desc->eventBatchCallback(*this, {&archetype, {eventBatchRecords.data(), eventBatchRecords.size()}}, sparseFilter);
+                        return;
+                    }
+
+                    if UNLIKELY (systemProfile)
+                        systemProfile->eventDispatches += static_cast<uint32_t>(eventBatchRecords.size());
+
+                    for (const auto& record : eventBatchRecords)
+                        system.desc->callback(*this, record.event, ArchetypeEntitySpan(archetype, record.index, archetype.inc(record.index)), sparseFilter);
+                });
+            }
+
+            groupBegin = groupEnd;
+        }
+    }
 }
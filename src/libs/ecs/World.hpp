@@ -1,9 +1,12 @@
 #pragma once
 
 #include "common/NonCopyableMovable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/JobSystem.hpp"
 #include "ecs/ForwardDeclarations.hpp"
 
 #include "ecs/Archetype.hpp"
+#include "ecs/ArchetypeIndex.hpp"
 #include "ecs/CommandBuffer.hpp"
 #include "ecs/meta/Storage.hpp"
 #include "ecs/meta/ComponentTraits.hpp"
@@ -12,8 +15,12 @@
 #include "ecs/EntityStorage.hpp"
 #include "ecs/Event.hpp"
 #include "ecs/EventStorage.hpp"
+#include "ecs/ExecutionPlan.hpp"
 #include "ecs/Hash.hpp"
+#include "ecs/Hierarchy.hpp"
 #include "ecs/IterationHelpers.hpp"
+#include "ecs/Prefab.hpp"
+#include "ecs/Profile.hpp"
 #include "ecs/Query.hpp"
 #include "ecs/System.hpp"
 #include "ecs/View.hpp"
@@ -21,12 +28,16 @@
 #include "absl/container/flat_hash_map.h" // IWYU pragma: export
 #include "absl/container/flat_hash_set.h" // IWYU pragma: export
 
+#include <atomic>
 #include <thread>
 
 #ifdef ENABLE_ASSERTS
 #define ASSERT_IS_CREATION_THREAD ASSERT(creationThreadID == std::this_thread::get_id())
+// Parallel tasks are allowed to use only the part of api, which is serialized by parallelGuard.
+#define ASSERT_IS_CREATION_OR_PARALLEL_THREAD ASSERT(inParallelExecution || creationThreadID == std::this_thread::get_id())
 #else
 #define ASSERT_IS_CREATION_THREAD
+#define ASSERT_IS_CREATION_OR_PARALLEL_THREAD
 #endif
 
 namespace RR::Ecs
@@ -49,7 +60,8 @@ namespace RR::Ecs
             else
             {
                 constexpr Meta::ComponentId compId = Meta::GetComponentId<ComponentType>;
-                return view.GetWithSet().find(compId) != view.GetWithSet().end();
+                const auto& withSet = Meta::IsSparse<ComponentType> ? view.GetSparseWithSet() : view.GetWithSet();
+                return withSet.find(compId) != withSet.end();
             }
         }
 
@@ -66,6 +78,21 @@ namespace RR::Ecs
             }
         }
 
+        template <typename Arg>
+        void ValidateChunkArgumentAgainstView(const Ecs::View& view)
+        {
+            if constexpr (IsSpan<eastl::decay_t<Arg>>::value)
+            {
+                using ComponentType = eastl::remove_const_t<typename eastl::decay_t<Arg>::element_type>;
+                ASSERT_MSG(
+                    IsComponentInView<ComponentType>(view),
+                    "Component {} used in lambda is not specified in the View's require set. Check component type and View definition.",
+                    Meta::GetTypeName<ComponentType>);
+            }
+            else
+                ValidateArgumentAgainstView<Arg>(view);
+        }
+
         template<typename ArgumentList, size_t... Indices>
         void ValidateArgumentsAgainstView(const Ecs::View& view, eastl::index_sequence<Indices...>)
         {
@@ -80,6 +107,19 @@ namespace RR::Ecs
             if constexpr (ArgList::Count > 0)
                 ValidateArgumentsAgainstView<ArgList>(view, eastl::make_index_sequence<ArgList::Count>());
         }
+
+        template<typename Callable, size_t... Indices>
+        void ValidateChunkLambdaArgumentsAgainstView(const Ecs::View& view, Callable&& /*callable*/, eastl::index_sequence<Indices...>)
+        {
+            using ArgList = Meta::GetArgumentList<Callable>;
+            (ValidateChunkArgumentAgainstView<typename ArgList::template Get<Indices>>(view), ...);
+        }
+
+        template<typename Callable>
+        void ValidateChunkLambdaArgumentsAgainstView(const Ecs::View& view, Callable&& callable)
+        {
+            ValidateChunkLambdaArgumentsAgainstView(view, callable, eastl::make_index_sequence<Meta::GetArgumentsCount<Callable>>());
+        }
     }
 #endif
 
@@ -98,11 +138,12 @@ namespace RR::Ecs
         };
 
     public:
-        World();
+        explicit World(const ChunkPoolDescription& chunkPoolDescription = {});
 
         [[nodiscard]] bool ResolveEntityRecord(EntityId entityId, EntityRecord& record) const
         {
-            ASSERT_IS_CREATION_THREAD;
+            ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+            const auto guard = parallelGuard();
             return entityStorage.Get(entityId, record);
         }
 
@@ -110,6 +151,30 @@ namespace RR::Ecs
         [[nodiscard]] bool Has(EntityId entityId, Meta::SortedComponentsView components) const;
         void Destroy(EntityId entityId);
 
+        // Creates count entities with the same set of components at once. Components are default constructed column by column,
+        // sparse components are emplaced per entity. Then initializer is invoked for every created entity like a query callback.
+        // OnAppear is dispatched once for the whole span.
+        template <typename... Components, typename Initializer>
+        void CreateEntities(uint32_t count, Initializer&& initializer);
+        template <typename... Components>
+        void CreateEntities(uint32_t count) { CreateEntities<Components...>(count, [] {}); }
+        // Creates count copies of prefab entity, except Prefab tag and hierarchy components. Components are copied column by column,
+        // trivially copyable ones with memcpy, other ones with copy constructor. Sparse components are copied per entity.
+        // Then initializer is invoked for every created entity and OnAppear is dispatched once, the same as for CreateEntities.
+        template <typename Initializer>
+        void Instantiate(EntityId prefab, uint32_t count, Initializer&& initializer);
+        void Instantiate(EntityId prefab, uint32_t count) { Instantiate(prefab, count, [] {}); }
+        // Destroys all entities matched by view. OnDissapear is dispatched once per archetype.
+        void DestroyEntities(const Ecs::View& view);
+        void DestroyEntities(eastl::span<const EntityId> entities);
+
+        // Attaches entity to the parent, null parent detaches it. Entity and its descendants are moved to archetypes of their new depth.
+        // Destroying entity destroys all its descendants as well. Applied on unlock, if world is locked.
+        void SetParent(EntityId entityId, EntityId parent);
+        [[nodiscard]] EntityId GetParent(EntityId entityId) const;
+        // Children in the order they were attached.
+        [[nodiscard]] eastl::span<const EntityId> GetChildren(EntityId entityId) const;
+
         [[nodiscard]] Ecs::EntityBuilder<void, void> Entity();
         [[nodiscard]] Ecs::Entity EmptyEntity();
         [[nodiscard]] Ecs::Entity GetEntity(EntityId entityId) { return Ecs::Entity(*this, entityId); }
@@ -125,12 +190,39 @@ namespace RR::Ecs
         template <typename Component>
         auto RegisterComponent() { return metaStorage.Register<Component>(); }
 
+        // Job system used by systems and queries opted into parallel execution.
+        // Without a job system they are executed serially on the calling thread.
+        void SetJobSystem(Common::Threading::JobSystem* system)
+        {
+            ASSERT_IS_CREATION_THREAD;
+            ASSERT(!IsLocked());
+            jobSystem = system;
+        }
+
+        // Independent systems of the same wave are executed concurrently on the job system, once enabled.
+        // System is treated as exclusive only if it takes world as an argument, so concurrent systems should not capture
+        // the world or any other mutable shared state. Disabled by default, waves are executed on the calling thread then.
+        void SetParallelSystems(bool enabled)
+        {
+            ASSERT_IS_CREATION_THREAD;
+            ASSERT(!IsLocked());
+            parallelSystems = enabled;
+        }
+
         template <typename EventType>
         void Emit(EventType&& event);
         template <typename EventType>
         void Emit(Ecs::Entity entity, EventType&& event);
         template <typename EventType>
         void Emit(EntityId entity, EventType&& event);
+        // Event is delivered on each of the next frames deferred events processings.
+        // Unicast event is not delivered, once target entity is destroyed.
+        template <typename EventType>
+        void EmitFor(uint32_t frames, EventType&& event);
+        template <typename EventType>
+        void EmitFor(uint32_t frames, Ecs::Entity entity, EventType&& event);
+        template <typename EventType>
+        void EmitFor(uint32_t frames, EntityId entity, EventType&& event);
         template <typename EventType>
         void EmitImmediately(const EventType& event) const;
         template <typename EventType>
@@ -139,12 +231,64 @@ namespace RR::Ecs
         void EmitImmediately(EntityId entity, const EventType& event) const;
 
         void RunSystem(SystemId systemId) const;
+        // Runs all systems, which are not subscribed to events and not tracking components, according to the execution plan.
+        // Independent systems of the same wave are executed concurrently on the job system, if enabled by SetParallelSystems.
+        void RunSystems();
+        // Should be called once systems are created or destroyed, before they are run or events are dispatched.
+        // Systems created or destroyed by running systems are ordered by RunSystems between waves, the run continues
+        // with systems, which have not run yet. Systems created this way run in the same frame.
         void OrderSystems();
         void ProcessDefferedEvents();
         void ProcessTrackedChanges();
         void Tick();
 
+        // Binary snapshot of entities, their components and sparse components. Query and system entities are not saved,
+        // so the loading world should have the same queries and systems created in the same order and all components registered.
+        // Components of saved entities should be trivially copyable, every column is written with a single copy per chunk.
+        // Returns false and leaves the buffer intact, if any of them is not.
+        [[nodiscard]] bool SaveSnapshot(eastl::vector<std::byte>& buffer) const;
+        // Replaces all entities by the snapshot ones without dispatching any events. Data is only read, so it could be a mapped file.
+        // Returns false and keeps the world intact, if snapshot is malformed or doesn't match registered components and systems.
+        [[nodiscard]] bool LoadSnapshot(eastl::span<const std::byte> data);
+
+        // Starts recording of entities changed since the last capture. Recording is off by default, as it's only needed for deltas.
+        void EnableDeltaCapture(bool enable);
+        // Delta of entities created, changed and destroyed since the last capture. Created and structurally changed entities are written
+        // with all components, other ones only with changed trackable components, so the cost scales with the number of changes.
+        // Tracked changes are processed as part of the capture, so OnChange subscribers are notified as well.
+        // Returns false and leaves the buffer intact, if components to write are not trivially copyable. Changes are kept for the next capture then.
+        [[nodiscard]] bool CaptureDelta(eastl::vector<std::byte>& buffer);
+        // Replays delta onto the world, which was in the same state as the captured one, e.g. loaded from its snapshot.
+        // Entities are created with the captured ids. Changed trackable components are reported to OnChange subscribers on the next processing.
+        // Returns false and keeps the world intact, if delta is malformed or doesn't match registered components.
+        [[nodiscard]] bool ApplyDelta(eastl::span<const std::byte> data);
+
+        // Records per-system timings and counters, tracked changes processing and commands applying. Off by default,
+        // disabled profiling costs a branch per system run and event dispatch. Enabling resets the profile.
+        // Profiling could be toggled and reset from systems, e.g. from the profiler panel.
+        void EnableProfiling(bool enable);
+        [[nodiscard]] bool IsProfilingEnabled() const { return profilingEnabled; }
+        // Systems are listed after ordering, counters are accumulated since the last reset.
+        [[nodiscard]] const WorldProfile& GetProfile() const { return profile; }
+        void ResetProfile();
+        // Memory usage of archetype chunks, including prefab ones, sorted by archetype id.
+        void GetArchetypesProfile(eastl::vector<ArchetypeProfile>& archetypes) const;
+
+        // Releases memory kept since the peak: empty tail chunks, grown chunk lists and archetypes without entities,
+        // which are not matched by any query or system. Slabs with all chunks free are returned to the system at the end of the pass.
+        // Pass stops once budget is spent and continues from the same archetype on the next call, e.g. next frame.
+        // Returns true when the pass is complete.
+        bool Compact(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+        // Version stamped to chunks on writes, advanced after every run of a system or a query. See View::Changed.
+        // Writes made from now on are stamped with this or newer version.
+        [[nodiscard]] uint32_t GetChangeVersion() const { return changeVersion; }
+        // Advances version as if count runs happened, e.g. to skip the versions of a replaced world. Stale versions are clamped on the way.
+        void AdvanceChangeVersion(uint32_t count);
+
         [[nodiscard]] bool IsLocked() const noexcept { return lockCounter > 0u; }
+        [[nodiscard]] const ExecutionPlan& GetExecutionPlan() const { return executionPlan; }
+        [[nodiscard]] ChunkPoolStats GetChunkPoolStats() const { return chunkPool.GetStats(); }
 
     private:
         template <typename U>
@@ -163,9 +307,63 @@ namespace RR::Ecs
 
     private:
         void destroyImpl(EntityId entityId);
+        // Compiled systems point into archetypes of system entities, so any entity leaving such archetype requires reordering.
+        void invalidateCompiledSystems(const Archetype& archetype)
+        {
+            if UNLIKELY (archetype.GetComponentIndex<SystemDescription>())
+                systemsOrderDirty = true;
+        }
+
+        Ecs::System createSystem(SystemDescription&& desc, Ecs::View&& view, HashName&& name, const eastl::optional<ParallelExecution>& parallel);
+        Ecs::Query createQuery(Ecs::View&& view, const eastl::optional<ParallelExecution>& parallel);
+
+        // Systems already run this frame are skipped, once the plan is rebuilt in the middle of the run.
+        void runWave(const ExecutionPlan::Wave& wave, bool skipRan);
+
+        // System components resolved once per ordering, so dispatch doesn't look up the system entity.
+        struct CompiledSystem
+        {
+            SystemId id;
+            const SystemDescription* desc;
+            const Ecs::View* view;
+            const MatchedArchetypeCache* cache;
+            const ParallelExecution* parallel;
+            // Entry of the profile, null if system is not ordered yet.
+            SystemProfile* profile;
+        };
+
+        void compileSystems(eastl::span<const SystemId> orderedSystems);
+        [[nodiscard]] const CompiledSystem* findCompiledSystem(SystemId systemId) const;
+        // Calls back with the compiled system, resolved through the system entity until systems are ordered again.
+        template <typename Callback>
+        void withCompiledSystem(SystemId systemId, Callback&& callback) const;
+        void runSystem(const CompiledSystem& system) const;
+        void dispatchEvent(const CompiledSystem& system, ArchetypeEntitySpan span, const Ecs::Event& event) const;
+        using ProfileClock = std::chrono::steady_clock;
+        // Adds time elapsed till the end of the scope to the counter, does nothing without counter.
+        struct ProfileScope : public Common::NonCopyableMovable
+        {
+            explicit ProfileScope(std::chrono::nanoseconds* counter) : counter(counter)
+            {
+                if UNLIKELY (counter)
+                    start = ProfileClock::now();
+            }
+            ~ProfileScope()
+            {
+                if UNLIKELY (counter)
+                    *counter += ProfileClock::now() - start;
+            }
+
+        private:
+            std::chrono::nanoseconds* counter;
+            ProfileClock::time_point start;
+        };
+
+        [[nodiscard]] SystemProfile* getSystemProfile(const CompiledSystem& system) const { return profilingEnabled ? system.profile : nullptr; }
+        static void profileRun(SystemProfile& systemProfile, const MatchedArchetypeCache& archetypes, uint64_t commands);
 
-        Ecs::System createSystem(SystemDescription&& desc, Ecs::View&& view, HashName&& name);
-        Ecs::Query createQuery(Ecs::View&& view);
+        // Systems mutate the world even if dispatched from const methods, the same as through the systems view.
+        World& getMutableWorld() const { return systemsView.world; }
 
         void initCache(SystemId id);
         void initCache(QueryId id);
@@ -176,9 +374,66 @@ namespace RR::Ecs
             return !(!archetype.HasAll(Meta::SortedComponentsView(view.with)) ||
                     archetype.HasAny(Meta::SortedComponentsView(view.without)));
         }
+        // Invokes spanCallback for runs of chunks changed since the last run of the view, or once for the whole archetype without change filter.
+        template <typename SpanCallback>
+        static void forEachChangedSpan(const Archetype& archetype, const Ecs::View& view, SpanCallback&& spanCallback)
+        {
+            if LIKELY (!view.HasChangeFilter())
+            {
+                spanCallback(ArchetypeEntitySpan(archetype, archetype.begin(), archetype.end()));
+                return;
+            }
+
+            const ChunkChangeFilter changeFilter(archetype, Meta::SortedComponentsView(view.changed), view.changedSince);
+            eastl::fixed_vector<ArchetypeEntitySpan, 16> spans;
+            SplitByChunks(archetype, eastl::numeric_limits<uint32_t>::max(), spans, &changeFilter);
+            for (const auto& span : spans)
+                spanCallback(span);
+        }
+        // Changes made by the run itself are not reported to its next run.
+        void finishRun(const Ecs::View& view) { view.changedSince = advanceChangeVersion(); }
+        uint32_t advanceChangeVersion()
+        {
+            // Zero is left for views, which have never run.
+            if UNLIKELY (++changeVersion == 0)
+                changeVersion++;
+
+            // Parallel tasks run queries as well, versions are checked by the next run on the creation thread then.
+            if UNLIKELY (changeVersion - lastVersionsCheck >= VersionsCheckInterval && !inParallelExecution)
+                checkChangeVersions();
+
+            return changeVersion;
+        }
+        // Versions are compared by signed distance, which overflows after 2^31 runs. Chunks and views of queries and systems
+        // not touched for MaxVersionAge runs are clamped to that age, so their chunks are reported as changed once, like after a missed run.
+        // Checked every VersionsCheckInterval runs, so no version in use gets older than MaxVersionAge + VersionsCheckInterval.
+        void checkChangeVersions();
+
+        // Persistent caches of queries and systems keep matched archetypes from being dropped by compaction.
+        static void addToCache(MatchedArchetypeCache& cache, const Ecs::View& view, const Archetype& archetype)
+        {
+            archetype.cacheReferencesCount++;
+            insertToCache(cache, view, archetype);
+        }
+        // Depth ordered caches are kept sorted by depth, archetypes of the same depth are in creation order.
+        static void insertToCache(MatchedArchetypeCache& cache, const Ecs::View& view, const Archetype& archetype)
+        {
+            if LIKELY (!view.IsDepthOrdered())
+            {
+                cache.push_back(&archetype);
+                return;
+            }
+
+            const auto it = eastl::upper_bound(cache.begin(), cache.end(), archetype.GetHierarchyDepth(), [](uint32_t depth, const Archetype* other) {
+                return depth < other->GetHierarchyDepth();
+            });
+            cache.insert(it, &archetype);
+        }
 
         Archetype& createArchetypeNoCache(ArchetypeId archetypeId, Meta::SortedComponentsView components);
         Archetype& getOrCreateArchetype(ArchetypeId archetypeId, Meta::SortedComponentsView components);
+        // Shrinks archetype and destroys it, if it's empty and not referenced by caches.
+        void compactArchetype(ArchetypeId archetypeId, Archetype& archetype);
 
         void handleDisappearEvent(EntityId entity, const Archetype& from, const Archetype& to);
         void handleAppearEvent(EntityId entity, const Archetype* from, const Archetype& to);
@@ -194,20 +449,94 @@ namespace RR::Ecs
         // Dispatch event to systems, that are subscribed to this event.
         // Systems would be queried for specific entity.
         void unicastEventImmediately(EntityId entity, const Ecs::Event& event) const;
+        // Parallel tasks emit events to own streams, which are merged in task order after the dispatch.
+        template <typename EventType>
+        void emit(EntityId entity, EventType&& event, uint32_t frames);
+        // Groups events by type and target archetype, each subscriber gets the group in a single callback invocation.
+        // Groups are delivered in order of the first event, events within the group are in emission order.
+        void unicastDeferredEvents(eastl::span<const EventStorage::EventRecord> events);
 
         template <typename Component, typename ArgsTuple>
         void constructComponent(Archetype& archetype, ArchetypeEntityIndex index, ArgsTuple&& args);
         template <typename Callable>
-        void mutateEntity(EntityId entityId, Archetype* from, ArchetypeEntityIndex fromIndex, Archetype& to, Callable&& constructComponents);
+        void mutateEntity(EntityId entityId, Archetype* from, ArchetypeEntityIndex fromIndex, Archetype& to, const ArchetypeEdge* edge, Callable&& constructComponents);
         template <typename Components, typename ArgsTuple, size_t... Index>
         [[nodiscard]] EntityId commit(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...> indexSeq);
+        // Commits archetype components first, then adds and removes sparse ones.
+        template <typename Components, typename ArgsTuple, size_t... Index>
+        [[nodiscard]] EntityId commitWithSparse(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...> indexSeq);
+        // Commits only components at Index positions of the list.
+        template <typename Components, typename ArgsTuple, size_t... Index>
+        [[nodiscard]] EntityId commitSubset(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...> indexSeq);
 
+        friend SparseSet* FindSparseSet(World& world, Meta::ComponentId componentId);
+        SparseSet& getOrCreateSparseSet(Meta::ComponentId componentId);
+        // Returns false if view could not match any entity, as some of required sparse components were never added.
+        bool makeSparseFilter(const Ecs::View& view, SparseFilter& sparseFilter) const;
+        bool isSparse(Meta::ComponentId componentId) const;
+        template <typename Component, typename ArgsTuple>
+        void addSparseComponent(EntityId entityId, ArgsTuple&& args);
+        void addSparseComponent(EntityId entityId, Meta::ComponentId componentId, void* data);
+        template <typename Component>
+        void constructSparseComponents(const Archetype& archetype, ArchetypeEntityIndex begin);
+        void removeSparseComponent(EntityId entityId, Meta::ComponentId componentId);
+        void removeFromSparseSets(EntityId entityId);
+
+        // Inserts copies of prefab, returns nullptr if prefab can't be instantiated.
+        [[nodiscard]] Archetype* instantiate(EntityId prefab, uint32_t count, ArchetypeEntityIndex& begin);
+        // Finishes creation of the tail of archetype inserted in bulk.
+        template <typename Initializer>
+        void initializeEntities(Archetype& archetype, ArchetypeEntityIndex begin, uint32_t count, Initializer&& initializer);
+
+        void setParentImpl(EntityId entityId, EntityId parent);
+        // Moves entity to the archetype of the depth and writes its parent, then moves descendants, if depth is changed.
+        void placeInHierarchy(EntityId entityId, EntityId parent, uint32_t depth);
+        [[nodiscard]] uint32_t getHierarchyHeight(EntityId entityId) const;
+        // Detaches dying entity from its parent and destroys its children.
+        void unlinkFromHierarchy(EntityId entityId);
+        // Children lists are derived from ChildOf components, which could be replaced by snapshots and deltas.
+        void rebuildHierarchy();
+
+        // Places entity to the archetype of given components and copies all of them. Entity is created with the same id, if it's not alive.
+        void replicateEntity(EntityId entityId, eastl::span<const Meta::ComponentInfo* const> components, const std::byte* values);
+
+        template <typename Callable>
+        void invokeForEntities(ArchetypeEntitySpan span, const Ecs::Event* event, const SparseFilter& sparseFilter, Callable&& callable);
         template <typename Callable>
-        void invokeForEntities(ArchetypeEntitySpan span, const Ecs::Event* event, Callable&& callable);
+        void invokeForEvents(const ArchetypeEventBatch& batch, const SparseFilter& sparseFilter, Callable&& callable);
+        template <typename Callable>
+        void invokeForChunks(ArchetypeEntitySpan span, const Ecs::Event* event, Callable&& callable);
+        // Splits matched archetypes at chunk boundaries and invokes spanCallback for every span on the job system.
+        // Chunks are filtered by changes, if view has change filter.
+        // World stays locked for the whole execution, so all structural changes are deferred to the command buffer.
+        template <typename SpanCallback>
+        void dispatchParallel(const MatchedArchetypeCache& archetypes, const Ecs::View& view, const ParallelExecution& parallel, SpanCallback&& spanCallback);
+        // Invokes task(index) for every index in [0, count) on the job system. World should be locked by the caller.
+        // Tasks record structural changes and events to own buffers, which are merged in index order once all tasks are done,
+        // so changes are applied deterministically regardless of scheduling.
+        template <typename Task>
+        void dispatchTasks(uint32_t count, Task&& task);
+        // Entity could be changed by a single task of the dispatch, as task commands are recorded against the pending state it sees.
+        // Entities created by tasks have no records until the end of the dispatch, so they can't be changed either.
+        // Rejected change is dropped and reported once the dispatch is over. Should be called under the parallel guard.
+        [[nodiscard]] bool claimForTask(EntityId entityId);
+
+        struct QueryState
+        {
+            MatchedArchetypeCache* archetypes = nullptr;
+            const Ecs::View* view = nullptr;
+            const ParallelExecution* parallel = nullptr;
+        };
+        QueryState getQueryState(QueryId queryId);
+        // Invokes spanCallback for every matched archetype, or for chunk spans on the job system if query is parallel.
+        template <typename SpanCallback>
+        void forEachQuerySpan(const QueryState& state, SpanCallback&& spanCallback);
 
         template <typename Callable>
         void query(QueryId queryId, Callable&& callable);
         template <typename Callable>
+        void queryChunks(QueryId queryId, Callable&& callable);
+        template <typename Callable>
         void query(const Ecs::View& view, Callable&& callable);
         template <typename Callable>
         void queryForEntity(EntityId entityId, const Ecs::View& view, Callable&& callable);
@@ -220,29 +549,125 @@ namespace RR::Ecs
             if (lockCounter == 0u)
                 onUnlock();
         }
-        void onUnlock() { commandBuffer.ProcessCommands(*this); }
+        void onUnlock()
+        {
+            if LIKELY (!profilingEnabled)
+            {
+                commandBuffer.ProcessCommands(*this);
+                return;
+            }
+
+            // Unlocks nested into commands processing return early, so commands are counted once.
+            const size_t commandsCount = commandBuffer.GetCommandsCount();
+            const ProfileScope scope(&profile.commandsTime);
+            commandBuffer.ProcessCommands(*this);
+            profile.processedCommands += commandsCount - commandBuffer.GetCommandsCount();
+        }
+
+        // Parallel tasks record structural changes to own buffers, which are merged in task order after the dispatch.
+        CommandBuffer& getCommandBuffer() { return inParallelExecution && taskCommandBuffer ? *taskCommandBuffer : commandBuffer; }
+
+        // Serializes access of parallel tasks to the world. Does nothing outside of parallel execution.
+        [[nodiscard]] Common::Threading::UniqueLock<Common::Threading::RecursiveMutex> parallelGuard() const
+        {
+            if LIKELY (!inParallelExecution)
+                return {};
+
+            return Common::Threading::UniqueLock<Common::Threading::RecursiveMutex>(parallelMutex);
+        }
 
     private:
         bool systemsOrderDirty = false;
+        // Read by worker threads, while the dispatching thread toggles it around the dispatch.
+        std::atomic<bool> inParallelExecution = false;
+        bool profilingEnabled = false;
+        bool parallelSystems = false;
         uint32_t lockCounter {0u};
+        // Referenced by archetypes, chunks are never stamped with zero version.
+        uint32_t changeVersion = 1;
+        uint32_t lastVersionsCheck = 1;
+        static constexpr uint32_t VersionsCheckInterval = 1u << 29;
+        static constexpr uint32_t MaxVersionAge = 1u << 30;
         std::thread::id creationThreadID;
+        Common::Threading::JobSystem* jobSystem = nullptr;
+        mutable Common::Threading::RecursiveMutex parallelMutex;
+        // Should outlive archetypes.
+        ChunkPool chunkPool;
         EntityStorage entityStorage;
         EventStorage eventStorage;
+        struct DeferredEvent
+        {
+            uint32_t group;
+            EventId eventId;
+            const Archetype* archetype;
+            EntityId entityId;
+            ArchetypeEventRecord record;
+        };
+        // Scratch storage of deferred events dispatch, kept to avoid reallocations every frame.
+        eastl::vector<DeferredEvent> deferredEvents;
+        absl::flat_hash_map<std::pair<HashType, const Archetype*>, uint32_t> deferredEventGroups;
+        eastl::vector<ArchetypeEventRecord> eventBatchRecords;
         Meta::Storage metaStorage;
         CommandBuffer commandBuffer;
+        eastl::vector<eastl::unique_ptr<CommandBuffer>> taskCommandBuffers;
+        // Buffers of tasks, which changed entities during the current dispatch.
+        absl::flat_hash_map<EntityId, const CommandBuffer*, Ecs::DummyHasher<EntityId>> taskEditOwners;
+        struct RejectedTaskEdit
+        {
+            EntityId entityId;
+            // Entity was created by a task and has no record yet.
+            bool reserved = false;
+        };
+        // First change rejected by claimForTask during the current dispatch.
+        RejectedTaskEdit rejectedTaskEdit;
+        static inline thread_local CommandBuffer* taskCommandBuffer = nullptr;
+        static inline thread_local EventStorage::Stream* taskEventStream = nullptr;
+        ExecutionPlan executionPlan;
         Ecs::View queriesView;
         Ecs::View systemsView;
+        // Systems in execution order, rebuilt by OrderSystems. System entities are not moved after ordering,
+        // so pointers stay valid until the next ordering.
+        eastl::vector<CompiledSystem> compiledSystems;
+        absl::flat_hash_map<SystemId, uint32_t, Ecs::DummyHasher<SystemId>> compiledSystemIndices;
+        // Systems run by RunSystems in the current frame.
+        eastl::vector<SystemId> ranSystems;
         Ecs::QueryId queriesQuery;
         Ecs::QueryId systemsQuery;
         absl::flat_hash_set<Meta::ComponentId, Ecs::DummyHasher<Meta::ComponentId>> singletonsSet;
+        absl::flat_hash_map<Meta::ComponentId, eastl::unique_ptr<SparseSet>, Ecs::DummyHasher<Meta::ComponentId>> sparseSets;
         absl::flat_hash_map<EventId, eastl::fixed_vector<SystemId, 16>, Ecs::DummyHasher<EventId>> eventSubscribers;
         absl::flat_hash_map<ArchetypeId, eastl::unique_ptr<Archetype>, Ecs::DummyHasher<ArchetypeId>> archetypesMap;
-        eastl::vector<Archetype*> archetypesCache;
+        ArchetypeIndex archetypeIndex;
+        // Archetypes of the compaction pass in progress, archetypes created during the pass are left for the next one.
+        eastl::vector<ArchetypeId> compactionQueue;
+        size_t compactionCursor = 0;
+        WorldProfile profile;
+        absl::flat_hash_map<EntityId, eastl::fixed_vector<EntityId, 4>, Ecs::DummyHasher<EntityId>> hierarchyChildren;
+
+        // Entities changed since the last delta capture, could contain duplicates and stale ids.
+        struct DeltaJournal
+        {
+            bool enabled = false;
+            eastl::vector<EntityId> touched;
+            eastl::vector<EntityId> destroyed;
+            eastl::vector<eastl::pair<EntityId, Meta::ComponentId>> changed;
+
+            void Touch(EntityId entityId) { if (enabled) touched.push_back(entityId); }
+            void Destroy(EntityId entityId) { if (enabled) destroyed.push_back(entityId); }
+            void Change(EntityId entityId, Meta::ComponentId componentId) { if (enabled) changed.emplace_back(entityId, componentId); }
+            void Clear()
+            {
+                touched.clear();
+                destroyed.clear();
+                changed.clear();
+            }
+        } deltaJournal;
     };
 
     inline bool World::IsAlive(EntityId entityId) const
     {
-        ASSERT_IS_CREATION_THREAD;
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        const auto guard = parallelGuard();
 
         EntityRecord record;
         if (!ResolveEntityRecord(entityId, record))
@@ -253,14 +678,30 @@ namespace RR::Ecs
 
     inline bool World::Has(EntityId entityId, Meta::SortedComponentsView components) const
     {
-        ASSERT_IS_CREATION_THREAD;
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        const auto guard = parallelGuard();
         EntityRecord record;
 
         if (!ResolveEntityRecord(entityId, record))
             return false;
 
         Archetype* archetype = record.GetArchetype(IsLocked());
-        return (archetype != nullptr) ? archetype->HasAll(components) : false;
+        if (archetype == nullptr)
+            return false;
+
+        if LIKELY (sparseSets.empty())
+            return archetype->HasAll(components);
+
+        // Sparse components reflect only applied changes, they are not tracked as pending.
+        for (const auto& componentId : components)
+        {
+            const auto it = sparseSets.find(componentId);
+            const bool has = it != sparseSets.end() ? it->second->Has(entityId) : archetype->HasAll(Meta::SortedComponentsView(&componentId, 1));
+            if (!has)
+                return false;
+        }
+
+        return true;
     }
 
     template <typename Component, typename ArgsTuple>
@@ -278,7 +719,7 @@ namespace RR::Ecs
     }
 
     template <typename Callable>
-    inline void World::mutateEntity(EntityId entityId, Archetype* from, ArchetypeEntityIndex fromIndex, Archetype& to, Callable&& constructComponents)
+    inline void World::mutateEntity(EntityId entityId, Archetype* from, ArchetypeEntityIndex fromIndex, Archetype& to, const ArchetypeEdge* edge, Callable&& constructComponents)
     {
         ASSERT_IS_CREATION_THREAD;
         ASSERT(entityId);
@@ -290,7 +731,8 @@ namespace RR::Ecs
         if (from)
         {
             handleDisappearEvent(entityId, *from, to);
-            index = to.Mutate(entityStorage, *from, fromIndex);
+            invalidateCompiledSystems(*from);
+            index = to.Mutate(entityStorage, *from, fromIndex, edge);
         }
         else
         {
@@ -298,43 +740,199 @@ namespace RR::Ecs
             entityStorage.Mutate(entityId, to, index);
         }
         constructComponents(to, index);
+        deltaJournal.Touch(entityId);
 
         handleAppearEvent(entityId, from, to);
     }
 
     template <typename Callable>
-    inline void World::invokeForEntities(ArchetypeEntitySpan span, const Ecs::Event* event, Callable&& callable)
+    inline void World::invokeForEntities(ArchetypeEntitySpan span, const Ecs::Event* event, const SparseFilter& sparseFilter, Callable&& callable)
     {
-        ASSERT_IS_CREATION_THREAD;
-        IterationContext context {*this, event};
+        IterationContext context {*this, event, sparseFilter.IsEmpty() ? nullptr : &sparseFilter};
+
+        if (inParallelExecution)
+        {
+            // World is already locked by the dispatching thread.
+            ArchetypeIterator::ForEach(span, context, eastl::forward<Callable>(callable));
+            return;
+        }
 
+        ASSERT_IS_CREATION_THREAD;
         LockGuard lg(this);
         // Todo check all args in callable persist in archetype.
         ArchetypeIterator::ForEach(span, context, eastl::forward<Callable>(callable));
     }
 
+    template <typename Callable>
+    inline void World::invokeForEvents(const ArchetypeEventBatch& batch, const SparseFilter& sparseFilter, Callable&& callable)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        IterationContext context {*this, nullptr, sparseFilter.IsEmpty() ? nullptr : &sparseFilter};
+
+        LockGuard lg(this);
+        ArchetypeIterator::ForEachEvent(batch, context, eastl::forward<Callable>(callable));
+    }
+
+    template <typename Callable>
+    inline void World::invokeForChunks(ArchetypeEntitySpan span, const Ecs::Event* event, Callable&& callable)
+    {
+        IterationContext context {*this, event};
+
+        if (inParallelExecution)
+        {
+            // World is already locked by the dispatching thread.
+            ArchetypeIterator::ForEachChunk(span, context, eastl::forward<Callable>(callable));
+            return;
+        }
+
+        ASSERT_IS_CREATION_THREAD;
+        LockGuard lg(this);
+        ArchetypeIterator::ForEachChunk(span, context, eastl::forward<Callable>(callable));
+    }
+
+    inline World::QueryState World::getQueryState(QueryId queryId)
+    {
+        QueryState state;
+        queriesView.ForEntity(EntityId(queryId.GetRaw()), [&state](MatchedArchetypeCache& cache, const Ecs::View& view, const ParallelExecution* parallelExecution) {
+            state.archetypes = &cache;
+            state.view = &view;
+            state.parallel = parallelExecution;
+        });
+
+        ASSERT(state.archetypes);
+        ASSERT(state.view);
+        return state;
+    }
+
+    template <typename SpanCallback>
+    inline void World::forEachQuerySpan(const QueryState& state, SpanCallback&& spanCallback)
+    {
+        if (state.parallel)
+            dispatchParallel(*state.archetypes, *state.view, *state.parallel, spanCallback);
+        else
+        {
+            for (auto archetype : *state.archetypes)
+                forEachChangedSpan(*archetype, *state.view, spanCallback);
+        }
+
+        finishRun(*state.view);
+    }
+
     template <typename Callable>
     inline void World::query(QueryId queryId, Callable&& callable)
     {
         ASSERT_IS_CREATION_THREAD;
 
-        MatchedArchetypeCache* archetypes = nullptr;
-        const Ecs::View* queryView = nullptr;
-        queriesView.ForEntity(EntityId(queryId.GetRaw()), [&archetypes, &queryView](MatchedArchetypeCache& cache, const Ecs::View& view) {
-            archetypes = &cache;
-            queryView = &view;
+        const QueryState state = getQueryState(queryId);
+
+        #ifdef ENABLE_ASSERTS
+            Debug::ValidateLambdaArgumentsAgainstView(*state.view, callable);
+        #endif
+
+        SparseFilter sparseFilter;
+        if (!makeSparseFilter(*state.view, sparseFilter))
+            return;
+
+        forEachQuerySpan(state, [this, &sparseFilter, &callable](ArchetypeEntitySpan span) {
+            invokeForEntities(span, nullptr, sparseFilter, callable);
         });
+    }
+
+    template <typename Callable>
+    inline void World::queryChunks(QueryId queryId, Callable&& callable)
+    {
+        ASSERT_IS_CREATION_THREAD;
 
-        ASSERT(archetypes);
-        ASSERT(queryView);
+        const QueryState state = getQueryState(queryId);
 
         #ifdef ENABLE_ASSERTS
-            Debug::ValidateLambdaArgumentsAgainstView(*queryView, callable);
+            Debug::ValidateChunkLambdaArgumentsAgainstView(*state.view, callable);
         #endif
-        for (auto archetype : *archetypes)
+        ECS_VERIFY(!state.view->HasSparseFilter(), "Chunks can't be filtered by sparse components.");
+
+        forEachQuerySpan(state, [this, &callable](ArchetypeEntitySpan span) {
+            invokeForChunks(span, nullptr, callable);
+        });
+    }
+
+    template <typename SpanCallback>
+    inline void World::dispatchParallel(const MatchedArchetypeCache& archetypes, const Ecs::View& view, const ParallelExecution& parallel, SpanCallback&& spanCallback)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT_MSG(!inParallelExecution, "Nested parallel execution is not supported.");
+
+        LockGuard lg(this);
+
+        eastl::fixed_vector<ArchetypeEntitySpan, 64> spans;
+        for (const auto* archetype : archetypes)
+        {
+            if LIKELY (!view.HasChangeFilter())
+            {
+                SplitByChunks(*archetype, parallel.chunksPerTask, spans);
+                continue;
+            }
+
+            const ChunkChangeFilter changeFilter(*archetype, Meta::SortedComponentsView(view.changed), view.changedSince);
+            SplitByChunks(*archetype, parallel.chunksPerTask, spans, &changeFilter);
+        }
+
+        if (!jobSystem || spans.size() < 2)
+        {
+            for (const auto& span : spans)
+                spanCallback(span);
+            return;
+        }
+
+        dispatchTasks(static_cast<uint32_t>(spans.size()), [&spans, &spanCallback](uint32_t index) { spanCallback(spans[index]); });
+    }
+
+    template <typename Task>
+    inline void World::dispatchTasks(uint32_t count, Task&& task)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT(IsLocked());
+        ASSERT(jobSystem);
+        ASSERT_MSG(!inParallelExecution, "Nested parallel execution is not supported.");
+
+        static constexpr size_t TaskCommandBufferSize = 64 * 1024;
+        while (taskCommandBuffers.size() < count)
+            taskCommandBuffers.emplace_back(eastl::make_unique<CommandBuffer>(TaskCommandBufferSize));
+
+        eventStorage.ReserveTaskStreams(count);
+
+        inParallelExecution = true;
+        // Single task per job, as buffers are bound per task.
+        jobSystem->ParallelFor(0, count, 1, [this, &task](uint32_t begin, uint32_t end) {
+            for (uint32_t index = begin; index < end; index++)
+            {
+                CommandBuffer* prevCommandBuffer = eastl::exchange(taskCommandBuffer, taskCommandBuffers[index].get());
+                EventStorage::Stream* prevEventStream = eastl::exchange(taskEventStream, &eventStorage.GetTaskStream(index));
+                task(index);
+                taskCommandBuffer = prevCommandBuffer;
+                taskEventStream = prevEventStream;
+            }
+        });
+        inParallelExecution = false;
+
+        // Sync point. Merge order depends only on task order, so changes are applied deterministically.
+        entityStorage.CommitReserved();
+        for (uint32_t index = 0; index < count; index++)
+            commandBuffer.Merge(*taskCommandBuffers[index]);
+        eventStorage.MergeTaskStreams(count);
+
+        taskEditOwners.clear();
+        if UNLIKELY (rejectedTaskEdit.entityId)
         {
-            ArchetypeEntitySpan span(*archetype, archetype->begin(), archetype->end());
-            invokeForEntities(span, nullptr, eastl::forward<Callable>(callable));
+            const RejectedTaskEdit rejected = rejectedTaskEdit;
+            rejectedTaskEdit = {};
+            if (rejected.reserved)
+            {
+                ECS_VERIFY(false, "Entity {} created by parallel task can't be changed or destroyed until the end of the dispatch.", rejected.entityId.GetRaw());
+            }
+            else
+            {
+                ECS_VERIFY(false, "Entity {} can't be changed or destroyed by different parallel tasks of the same dispatch.", rejected.entityId.GetRaw());
+            }
         }
     }
 
@@ -348,16 +946,28 @@ namespace RR::Ecs
             Debug::ValidateLambdaArgumentsAgainstView(view, callable);
         #endif
 
-        IterationContext context {*this, nullptr};
+        SparseFilter sparseFilter;
+        if (!makeSparseFilter(view, sparseFilter))
+            return;
 
-        for (const auto* archetype : archetypesCache)
+        IterationContext context {*this, nullptr, sparseFilter.IsEmpty() ? nullptr : &sparseFilter};
+
+        if UNLIKELY (view.IsDepthOrdered())
         {
-            if LIKELY (!matches(*archetype, view))
-                continue;
+            // Temporary cache, so matched archetypes are not referenced.
+            MatchedArchetypeCache archetypes;
+            archetypeIndex.ForEachMatched(Meta::SortedComponentsView(view.with), Meta::SortedComponentsView(view.without), [&archetypes, &view](const Archetype& archetype) {
+                insertToCache(archetypes, view, archetype);
+            });
 
-            const ArchetypeEntitySpan span(*archetype, archetype->begin(), archetype->end());
-            ArchetypeIterator::ForEach(span, context, eastl::forward<Callable>(callable));
+            for (const auto* archetype : archetypes)
+                forEachChangedSpan(*archetype, view, [&context, &callable](ArchetypeEntitySpan span) { ArchetypeIterator::ForEach(span, context, callable); });
+            return;
         }
+
+        archetypeIndex.ForEachMatched(Meta::SortedComponentsView(view.with), Meta::SortedComponentsView(view.without), [&context, &callable, &view](const Archetype& archetype) {
+            forEachChangedSpan(archetype, view, [&context, &callable](ArchetypeEntitySpan span) { ArchetypeIterator::ForEach(span, context, callable); });
+        });
     }
 
     template <typename Callable>
@@ -390,6 +1000,16 @@ namespace RR::Ecs
             return;
         }
 
+        if UNLIKELY (view.HasSparseFilter())
+        {
+            SparseFilter sparseFilter;
+            if (!makeSparseFilter(view, sparseFilter) || !sparseFilter.Matches(entityId))
+            {
+                ECS_VERIFY(false, "View doesn't match with entity.");
+                return;
+            }
+        }
+
         LockGuard lg(this);
         ArchetypeEntityIndex index = record.GetIndex(false);
         ArchetypeIterator::ForEntity(*archetype, index, {*this, nullptr}, eastl::forward<Callable>(callable));
@@ -398,11 +1018,26 @@ namespace RR::Ecs
     template <typename Components, typename ArgsTuple, size_t... Index>
     EntityId World::commit(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...> indexSeq)
     {
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+
+        if constexpr ((Meta::IsSparse<typename Components::template Get<Index>> || ...))
+            return commitWithSparse<Components>(entityId, removeComponents, eastl::forward<ArgsTuple>(args), indexSeq);
+        else
+        {
+            if UNLIKELY (!sparseSets.empty() && eastl::any_of(removeComponents.begin(), removeComponents.end(), [this](Meta::ComponentId id) { return isSparse(id); }))
+                return commitWithSparse<Components>(entityId, removeComponents, eastl::forward<ArgsTuple>(args), indexSeq);
+        }
+
+        auto guard = parallelGuard();
+
         Archetype* from = nullptr;
         ArchetypeEntityIndex fromIndex;
 
         if (entityId)
         {
+            if UNLIKELY (inParallelExecution && !claimForTask(entityId))
+                return entityId;
+
             if (!IsAlive(entityId))
                 return entityId;
 
@@ -453,53 +1088,80 @@ namespace RR::Ecs
         if (!onlyNewSingletons)
             return entityId;
 
-        Meta::ComponentsSet components;
-        Meta::ComponentsSet added;
+        eastl::array<Meta::ComponentId, Components::Count> addedComponents = {Meta::GetComponentId<typename Components::template Get<Index>>...};
+        const bool singleTransition = from && (Components::Count + eastl::distance(removeComponents.begin(), removeComponents.end())) == 1;
 
-        if (from)
+        // Single component add or remove is resolved through the cached edge of the source archetype.
+        const ArchetypeEdge* edge = nullptr;
+        Archetype::EdgeType edgeType = Archetype::EdgeType::Remove;
+        Meta::ComponentId edgeComponent;
+        if (singleTransition)
         {
-            for (auto component : from->GetComponentsView())
-                components.push_back_unsorted(component); // Components already sorted
-
-            for (auto component : removeComponents)
+            if constexpr (Components::Count == 1)
             {
-                [[maybe_unused]] auto result = components.erase(component);
-
-                // We could silent this error, if it's would be a case reconsider this.
-                ECS_VERIFY(result == 1, "Can't remove component {}. Component is not present in the archetype.", getComponentName(component));
+                edgeType = Archetype::EdgeType::Add;
+                edgeComponent = addedComponents[0];
             }
+            else
+                edgeComponent = *removeComponents.begin();
+
+            edge = from->FindEdge(edgeType, edgeComponent);
         }
-        else
+
+        Archetype* to = edge ? edge->to : nullptr;
+        if (!to)
         {
-            components.push_back_unsorted(Meta::GetComponentId<EntityId>); // Adding first component.
-            ECS_VERIFY(eastl::distance(removeComponents.begin(), removeComponents.end()) == 0, "Can't remove components on creation of entity.");
-        }
+            Meta::ComponentsSet components;
+            Meta::ComponentsSet added;
 
-        auto addComponent = [&components, &getComponentName](Meta::ComponentId id) -> int {
-            [[maybe_unused]] bool added = components.insert(id).second;
-            UNUSED(getComponentName);
-            // We could silent this error, if it's would be a case reconsider this.
-            ECS_VERIFY(added, "Can't add component {}. Only new components can be added.", getComponentName(id));
-            return 0;
-        };
+            if (from)
+            {
+                for (auto component : from->GetComponentsView())
+                    components.push_back_unsorted(component); // Components already sorted
 
-        eastl::array<Meta::ComponentId, Components::Count> addedComponents = {Meta::GetComponentId<typename Components::template Get<Index>>...};
-        for (auto component : addedComponents)
-            addComponent(component);
+                for (auto component : removeComponents)
+                {
+                    [[maybe_unused]] auto result = components.erase(component);
+
+                    // We could silent this error, if it's would be a case reconsider this.
+                    ECS_VERIFY(result == 1, "Can't remove component {}. Component is not present in the archetype.", getComponentName(component));
+                }
+            }
+            else
+            {
+                components.push_back_unsorted(Meta::GetComponentId<EntityId>); // Adding first component.
+                ECS_VERIFY(eastl::distance(removeComponents.begin(), removeComponents.end()) == 0, "Can't remove components on creation of entity.");
+            }
+
+            auto addComponent = [&components, &getComponentName](Meta::ComponentId id) -> int {
+                [[maybe_unused]] bool added = components.insert(id).second;
+                UNUSED(getComponentName);
+                // We could silent this error, if it's would be a case reconsider this.
+                ECS_VERIFY(added, "Can't add component {}. Only new components can be added.", getComponentName(id));
+                return 0;
+            };
+
+            for (auto component : addedComponents)
+                addComponent(component);
 
-        ArchetypeId archetypeId = GetArchetypeIdForComponents(Meta::SortedComponentsView(components));
-        Archetype& to = getOrCreateArchetype(archetypeId, Meta::SortedComponentsView(components));
+            ArchetypeId archetypeId = GetArchetypeIdForComponents(Meta::SortedComponentsView(components));
+            to = &getOrCreateArchetype(archetypeId, Meta::SortedComponentsView(components));
 
 #ifdef ECS_ENABLE_CHEKS
-        eastl::quick_sort(addedComponents.begin(), addedComponents.end());
-        ECS_VERIFY(!Meta::SortedComponentsView(addedComponents).IsIntersects(removeComponents), "Can't add and remove components at the same time.");
+            eastl::quick_sort(addedComponents.begin(), addedComponents.end());
+            ECS_VERIFY(!Meta::SortedComponentsView(addedComponents).IsIntersects(removeComponents), "Can't add and remove components at the same time.");
 #endif
 
+            // Failed verification leaves entity in the same archetype, such transitions are not cached.
+            if (singleTransition && to != from)
+                edge = &from->CreateEdge(edgeType, edgeComponent, *to);
+        }
+
         if (!IsLocked())
         {
             if (!entityId)
-                entityId = entityStorage.Create(to);
-            mutateEntity(entityId, from, fromIndex, to, [&](Archetype& archetype, ArchetypeEntityIndex index) {
+                entityId = entityStorage.Create(*to);
+            mutateEntity(entityId, from, fromIndex, *to, edge, [&](Archetype& archetype, ArchetypeEntityIndex index) {
                 (
                     constructComponent<typename Components::template Get<Index>>(
                         archetype, index,
@@ -509,23 +1171,213 @@ namespace RR::Ecs
         }
         else
         {
+            // Entity created by parallel task is not accessible until the end of the dispatch.
             if (!entityId)
-                entityId = entityStorage.CreateAsync(to);
+                entityId = inParallelExecution ? entityStorage.Reserve() : entityStorage.CreateAsync(*to);
             else
-                entityStorage.PendingMutate(entityId, to);
-            commandBuffer.Mutate<Components>(entityId, from, to, eastl::forward<ArgsTuple>(args), indexSeq);
+                entityStorage.PendingMutate(entityId, *to);
+
+            // Components are constructed in the own buffer of parallel task, so the world is not needed to be guarded anymore.
+            if (guard.owns_lock() && taskCommandBuffer)
+                guard.unlock();
+            getCommandBuffer().Mutate<Components>(entityId, from, *to, edge, eastl::forward<ArgsTuple>(args), indexSeq);
         }
 
         ASSERT(entityId);
         return entityId;
     }
 
+    namespace details
+    {
+        template <typename Left, typename Right>
+        struct ConcatIndices;
+
+        template <size_t... Left, size_t... Right>
+        struct ConcatIndices<eastl::index_sequence<Left...>, eastl::index_sequence<Right...>>
+        {
+            using Type = eastl::index_sequence<Left..., Right...>;
+        };
+
+        // Indices of components in the list, which sparse trait is equal to Sparse.
+        template <typename Components, bool Sparse, typename Indices>
+        struct FilterSparseIndices
+        {
+            using Type = eastl::index_sequence<>;
+        };
+
+        template <typename Components, bool Sparse, size_t Head, size_t... Tail>
+        struct FilterSparseIndices<Components, Sparse, eastl::index_sequence<Head, Tail...>>
+        {
+            using HeadIndices = eastl::conditional_t<Meta::IsSparse<typename Components::template Get<Head>> == Sparse, eastl::index_sequence<Head>, eastl::index_sequence<>>;
+            using Type = typename ConcatIndices<HeadIndices, typename FilterSparseIndices<Components, Sparse, eastl::index_sequence<Tail...>>::Type>::Type;
+        };
+    }
+
+    template <typename Components, typename ArgsTuple, size_t... Index>
+    EntityId World::commitWithSparse(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...>)
+    {
+        Meta::ComponentsSet denseRemove;
+        eastl::fixed_vector<Meta::ComponentId, 8> sparseRemove;
+        for (auto component : removeComponents)
+        {
+            if (isSparse(component))
+                sparseRemove.push_back(component);
+            else
+                denseRemove.push_back_unsorted(component); // Components already sorted
+        }
+
+        using DenseIndices = typename details::FilterSparseIndices<Components, false, eastl::index_sequence<Index...>>::Type;
+        entityId = commitSubset<Components>(entityId, Meta::SortedComponentsView(denseRemove), eastl::forward<ArgsTuple>(args), DenseIndices {});
+
+        // Deferred sparse changes are dropped on processing, if entity is dead by then.
+        if (!entityId || (!IsLocked() && !IsAlive(entityId)))
+            return entityId;
+
+        ([&] {
+            using T = typename Components::template Get<Index>;
+            if constexpr (Meta::IsSparse<T>)
+                addSparseComponent<T>(entityId, std::get<Index>(eastl::move(args)));
+        }(), ...);
+
+        for (auto component : sparseRemove)
+            removeSparseComponent(entityId, component);
+
+        return entityId;
+    }
+
+    template <typename Components, typename ArgsTuple, size_t... Index>
+    EntityId World::commitSubset(EntityId entityId, Meta::SortedComponentsView removeComponents, ArgsTuple&& args, eastl::index_sequence<Index...>)
+    {
+        using SubsetComponents = TypeList<typename Components::template Get<Index>...>;
+        return commit<SubsetComponents>(entityId, removeComponents,
+                                        std::make_tuple(std::get<Index>(eastl::move(args))...),
+                                        eastl::make_index_sequence<SubsetComponents::Count>());
+    }
+
+    template <typename Component, typename ArgsTuple>
+    inline void World::addSparseComponent(EntityId entityId, ArgsTuple&& args)
+    {
+        RegisterComponent<Component>();
+
+        if (IsLocked())
+        {
+            getCommandBuffer().AddSparse<Component>(entityId, eastl::forward<ArgsTuple>(args));
+            return;
+        }
+
+        SparseSet& sparseSet = getOrCreateSparseSet(Meta::GetComponentId<Component>);
+        if (sparseSet.Has(entityId))
+        {
+            ECS_VERIFY(false, "Can't add component {}. Only new components can be added.", Meta::GetComponentName<Component>);
+            return;
+        }
+
+        deltaJournal.Touch(entityId);
+        void* data = sparseSet.Emplace(entityId);
+        if constexpr (!Meta::IsTag<Component>)
+        {
+            std::apply([data](auto&&... unpackedArgs) {
+                new (data) Component {eastl::forward<decltype(unpackedArgs)>(unpackedArgs)...};
+            },
+                       eastl::forward<ArgsTuple>(args));
+        }
+        else
+            UNUSED(data, args);
+    }
+
+    template <typename... Components, typename Initializer>
+    inline void World::CreateEntities(uint32_t count, Initializer&& initializer)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT_MSG(!IsLocked(), "Entities can't be created in bulk while world is locked.");
+        static_assert((!Meta::IsSingleton<Components> && ...), "Singleton components can't be created in bulk.");
+
+        if (count == 0)
+            return;
+
+        (RegisterComponent<Components>(), ...);
+
+        Meta::ComponentsSet components;
+        Meta::ComponentsSet sparseComponents;
+        components.push_back_unsorted(Meta::GetComponentId<EntityId>);
+        bool unique = true;
+        ([&components, &sparseComponents, &unique]() {
+            auto& set = Meta::IsSparse<Components> ? sparseComponents : components;
+            const bool added = set.insert(Meta::GetComponentId<Components>).second;
+            ECS_VERIFY(added, "Can't add component {}. Only new components can be added.", Meta::GetTypeName<Components>);
+            unique &= added;
+        }(), ...);
+
+        // Duplicated component would be constructed twice in the same column.
+        if (!unique)
+            return;
+
+        Archetype& archetype = getOrCreateArchetype(GetArchetypeIdForComponents(Meta::SortedComponentsView(components)), Meta::SortedComponentsView(components));
+
+        const ArchetypeEntityIndex begin = archetype.InsertEntities(count);
+        entityStorage.Create(archetype, begin, count);
+        ([&] {
+            if constexpr (Meta::IsSparse<Components>)
+                constructSparseComponents<Components>(archetype, begin);
+            else
+                archetype.ConstructComponents<Components>(begin, count);
+        }(), ...);
+
+        initializeEntities(archetype, begin, count, eastl::forward<Initializer>(initializer));
+    }
+
+    template <typename Component>
+    inline void World::constructSparseComponents(const Archetype& archetype, ArchetypeEntityIndex begin)
+    {
+        // Sparse components are not stored in chunks, each entity gets own entry in the sparse set.
+        SparseSet& sparseSet = getOrCreateSparseSet(Meta::GetComponentId<Component>);
+        for (auto index = begin; index != archetype.end(); index = archetype.inc(index))
+        {
+            void* data = sparseSet.Emplace(archetype.GetEntityIdData(index));
+            if constexpr (!Meta::IsTag<Component>)
+                new (data) Component {};
+            else
+                UNUSED(data);
+        }
+    }
+
+    template <typename Initializer>
+    inline void World::Instantiate(EntityId prefab, uint32_t count, Initializer&& initializer)
+    {
+        ASSERT_IS_CREATION_THREAD;
+        ASSERT_MSG(!IsLocked(), "Prefab can't be instantiated while world is locked.");
+
+        if (count == 0)
+            return;
+
+        ArchetypeEntityIndex begin;
+        if (Archetype* archetype = instantiate(prefab, count, begin))
+            initializeEntities(*archetype, begin, count, eastl::forward<Initializer>(initializer));
+    }
+
+    template <typename Initializer>
+    inline void World::initializeEntities(Archetype& archetype, ArchetypeEntityIndex begin, uint32_t count, Initializer&& initializer)
+    {
+        if (deltaJournal.enabled)
+            for (auto index = begin; index != archetype.end(); index = archetype.inc(index))
+                deltaJournal.Touch(archetype.GetEntityIdData(index));
+
+        // Structural changes made by initializer and OnAppear subscribers are deferred until all of them are done.
+        LockGuard lg(this);
+        const ArchetypeEntitySpan span(archetype, begin, archetype.end());
+        ArchetypeIterator::ForEach(span, {*this, nullptr}, eastl::forward<Initializer>(initializer));
+        archetype.ResetTrackedChanges(begin, count);
+
+        const auto it = archetype.cache.find(GetEventId<OnAppear>);
+        if (it != archetype.cache.end())
+            for (const auto systemId : it->second)
+                dispatchEventImmediately(span, systemId, OnAppear {});
+    }
+
     template <typename EventType>
     inline void World::Emit(EventType&& event)
     {
-        static_assert(eastl::is_base_of_v<Ecs::Event, EventType>, "EventType must derive from Event");
-        ASSERT_IS_CREATION_THREAD;
-        eventStorage.Push({}, std::forward<EventType>(event));
+        emit({}, std::forward<EventType>(event), 1);
     }
 
     template <typename EventType>
@@ -538,10 +1390,47 @@ namespace RR::Ecs
     template <typename EventType>
     inline void World::Emit(EntityId entity, EventType&& event)
     {
-        static_assert(eastl::is_base_of_v<Ecs::Event, EventType>, "EventType must derive from Event");
-        ASSERT_IS_CREATION_THREAD;
         ASSERT(entity);
-        eventStorage.Push(entity, std::forward<EventType>(event));
+        emit(entity, std::forward<EventType>(event), 1);
+    }
+
+    template <typename EventType>
+    inline void World::EmitFor(uint32_t frames, EventType&& event)
+    {
+        static_assert(std::is_trivially_copyable_v<eastl::decay_t<EventType>>, "Multi frame events are relocated between frames, so should be trivially copyable");
+        emit({}, std::forward<EventType>(event), frames);
+    }
+
+    template <typename EventType>
+    inline void World::EmitFor(uint32_t frames, Ecs::Entity entity, EventType&& event)
+    {
+        ASSERT(entity.world == this);
+        EmitFor<EventType>(frames, entity.GetId(), std::forward<EventType>(event));
+    }
+
+    template <typename EventType>
+    inline void World::EmitFor(uint32_t frames, EntityId entity, EventType&& event)
+    {
+        static_assert(std::is_trivially_copyable_v<eastl::decay_t<EventType>>, "Multi frame events are relocated between frames, so should be trivially copyable");
+        ASSERT(entity);
+        emit(entity, std::forward<EventType>(event), frames);
+    }
+
+    template <typename EventType>
+    inline void World::emit(EntityId entity, EventType&& event, uint32_t frames)
+    {
+        static_assert(eastl::is_base_of_v<Ecs::Event, EventType>, "EventType must derive from Event");
+        ASSERT_IS_CREATION_OR_PARALLEL_THREAD;
+        ASSERT(frames > 0);
+
+        if (inParallelExecution && taskEventStream)
+        {
+            taskEventStream->Push(entity, std::forward<EventType>(event), frames);
+            return;
+        }
+
+        const auto guard = parallelGuard();
+        eventStorage.Push(entity, std::forward<EventType>(event), frames);
     }
 
     template <typename EventType>
@@ -621,9 +1510,15 @@ namespace RR::Ecs
         world.query(id, eastl::forward<Callable>(callable));
     }
 
+    template <typename Callable>
+    inline void Query::ForEachChunk(Callable&& callable) const
+    {
+        world.queryChunks(id, eastl::forward<Callable>(callable));
+    }
+
     inline Query QueryBuilder::Build() &&
     {
-        return view.world.createQuery(eastl::move(view));
+        return view.world.createQuery(eastl::move(view), parallel);
     }
 
     inline void System::Run() const
@@ -134,6 +134,15 @@ struct PositionComponent
     float y {0.0F};
 };
 
+struct TagComponent
+{
+};
+
+struct SparseTagComponent
+{
+    ECS_SPARSE;
+};
+
 template <typename T>
 struct EntityS
 {
@@ -211,6 +220,61 @@ TEST_CASE("Create archetype", "Archetype")
     }
 }
 
+template <int Index>
+struct IndexedComponent
+{
+    int x;
+};
+
+// Creates entity with IndexedComponent for every set bit of the mask, so every mask is a separate archetype.
+template <size_t... Index>
+void createIndexedEntity(World& world, uint32_t mask, eastl::index_sequence<Index...>)
+{
+    const auto entity = world.EmptyEntity();
+    ((mask & (1u << Index) ? void(entity.Edit().Add<IndexedComponent<Index>>(int(mask)).Apply()) : void()), ...);
+}
+
+TEST_CASE("Match archetypes", "[Query]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Match archetypes")
+        .warmup(10)
+        .relative(true)
+        .performanceCounters(true);
+    bench.epochIterations(1);
+
+    for (auto archetypesCount : {100U, 1000U, 10000U})
+    {
+        bench.epochs(archetypesCount == 10000 ? 300 : 3000);
+
+        World world;
+        for (uint32_t mask = 1; mask <= archetypesCount; mask++)
+            createIndexedEntity(world, mask, eastl::make_index_sequence<14>());
+
+        {
+            bench.run("Ecs view archetypes:" + std::to_string(archetypesCount), [&](ankerl::nanobench::Meter meter) {
+                return meter.measure([&world]() {
+                    int summ = 0;
+                    world.View().With<IndexedComponent<0>, IndexedComponent<3>>().Without<IndexedComponent<5>>().ForEach([&summ](const IndexedComponent<0>& component) {
+                        summ += component.x;
+                    });
+                    ankerl::nanobench::doNotOptimizeAway(summ);
+                });
+            });
+        }
+        {
+            bench.run("Ecs query build archetypes:" + std::to_string(archetypesCount), [&](ankerl::nanobench::Meter meter) {
+                return meter.measure([&world]() {
+                    const auto query = world.Query().With<IndexedComponent<1>, IndexedComponent<4>>().Build();
+                    ankerl::nanobench::doNotOptimizeAway(&query);
+                    // Query entities would pile up over the iterations otherwise.
+                    world.Destroy(EntityId(query.GetId().GetRaw()));
+                });
+            });
+        }
+    }
+}
+
 TEST_CASE("Create Entity", "[Entity]")
 {
     ankerl::nanobench::Bench bench;
@@ -310,6 +374,41 @@ TEST_CASE("Create Entity", "[Entity]")
             });
         }
 
+        {
+            bench.run("Ecs bulk", [&](ankerl::nanobench::Meter meter) {
+                World world;
+                polluteWorldWithArchetypes(world);
+
+                return meter.measure([batchSize, &world]() {
+                    world.CreateEntities<PositionComponent, VelocityComponent, DataComponent>(batchSize, [](PositionComponent& position, VelocityComponent& velocity) {
+                        position = {1.0f, 2.0f};
+                        velocity = {1.0f, 2.0f};
+                    });
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+
+        {
+            bench.run("Ecs instantiate", [&](ankerl::nanobench::Meter meter) {
+                World world;
+                polluteWorldWithArchetypes(world);
+
+                const auto prefab = world.Entity()
+                                        .Add<Prefab>()
+                                        .Add<PositionComponent>(1.0f, 2.0f)
+                                        .Add<VelocityComponent>(1.0f, 2.0f)
+                                        .Add<DataComponent>()
+                                        .Apply()
+                                        .GetId();
+
+                return meter.measure([batchSize, &world, prefab]() {
+                    world.Instantiate(prefab, batchSize);
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+
         {
             bench.epochs(bench.epochs() / 10);
             bench.run("Flecs", [&](ankerl::nanobench::Meter meter) {
@@ -460,6 +559,87 @@ TEST_CASE("Update Entity", "[Entity]")
                 ankerl::nanobench::doNotOptimizeAway(&flecsWorld);
             });
         }
+
+        {
+            bench.run("Ecs add/remove tag", [&](ankerl::nanobench::Meter meter) {
+                eastl::vector<Entity> entities;
+
+                World world;
+                for (uint32_t i = 0; i < numEntities; i++)
+                    entities.push_back(
+                        world
+                            .Entity()
+                            .Add<PositionComponent>(1.0f, 2.0f)
+                            .Add<VelocityComponent>(1.0f, 2.0f)
+                            .Add<DataComponent>()
+                            .Apply());
+
+                std::random_device dev;
+                ankerl::nanobench::Rng rng(dev());
+
+                return meter.measure([&entities, batchSize, &rng]() {
+                    for (uint32_t i = 0; i < batchSize; i++)
+                    {
+                        auto entity = entities[rng() % numEntities];
+                        entity.Edit().Add<TagComponent>().Apply();
+                        entity.Edit().Remove<TagComponent>().Apply();
+                    }
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+
+        {
+            bench.run("Ecs add/remove sparse tag", [&](ankerl::nanobench::Meter meter) {
+                eastl::vector<Entity> entities;
+
+                World world;
+                for (uint32_t i = 0; i < numEntities; i++)
+                    entities.push_back(
+                        world
+                            .Entity()
+                            .Add<PositionComponent>(1.0f, 2.0f)
+                            .Add<VelocityComponent>(1.0f, 2.0f)
+                            .Add<DataComponent>()
+                            .Apply());
+
+                std::random_device dev;
+                ankerl::nanobench::Rng rng(dev());
+
+                return meter.measure([&entities, batchSize, &rng]() {
+                    for (uint32_t i = 0; i < batchSize; i++)
+                    {
+                        auto entity = entities[rng() % numEntities];
+                        entity.Edit().Add<SparseTagComponent>().Apply();
+                        entity.Edit().Remove<SparseTagComponent>().Apply();
+                    }
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+
+        {
+            bench.run("Flecs add/remove tag", [&](ankerl::nanobench::Meter meter) {
+                flecs::world flecsWorld;
+                eastl::vector<flecs::entity> entities;
+
+                for (uint32_t i = 0; i < numEntities; i++)
+                    entities.push_back(flecsWorld.entity().set<PositionComponent>({1.0f, 2.0f}).set<VelocityComponent>({1.0f, 2.0f}).set<DataComponent>({}));
+
+                std::random_device dev;
+                ankerl::nanobench::Rng rng(dev());
+
+                return meter.measure([&entities, batchSize, &rng]() {
+                    for (uint32_t i = 0; i < batchSize; i++)
+                    {
+                        auto entity = entities[rng() % numEntities];
+                        entity.add<TagComponent>();
+                        entity.remove<TagComponent>();
+                    }
+                });
+                ankerl::nanobench::doNotOptimizeAway(&flecsWorld);
+            });
+        }
     }
 }
 
@@ -471,6 +651,9 @@ TEST_CASE("Update entities", "[Entity]")
         .relative(true)
         .performanceCounters(true);
 
+    // Spawning workers is not a part of the measurement, so the job system is shared by all batch sizes.
+    RR::Common::Threading::JobSystem jobSystem;
+
     for (auto batchSize : {1U, 8U, 16U, 128U, 1024U, 100000U})
     {
 
@@ -544,6 +727,52 @@ TEST_CASE("Update entities", "[Entity]")
                 ankerl::nanobench::doNotOptimizeAway(&world);
             });
         }
+        {
+            bench.run("Ecs query parallel", [&](ankerl::nanobench::Meter meter) {
+                World world;
+                world.SetJobSystem(&jobSystem);
+                for (uint32_t i = 0; i < batchSize; i++)
+                    world
+                        .Entity()
+                        .Add<PositionComponent>(1.0f, 2.0f)
+                        .Add<VelocityComponent>(1.0f, 2.0f)
+                        .Add<DataComponent>()
+                        .Apply();
+
+                const auto query = world.Query().With<PositionComponent, VelocityComponent>().Parallel().Build();
+                return meter.measure([query]() {
+                    query.ForEach([&](PositionComponent& position, const VelocityComponent& velocity) {
+                        position.x += velocity.x;
+                        position.y += velocity.y;
+                    });
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+        {
+            bench.run("Ecs query chunk", [&](ankerl::nanobench::Meter meter) {
+                World world;
+                for (uint32_t i = 0; i < batchSize; i++)
+                    world
+                        .Entity()
+                        .Add<PositionComponent>(1.0f, 2.0f)
+                        .Add<VelocityComponent>(1.0f, 2.0f)
+                        .Add<DataComponent>()
+                        .Apply();
+
+                const auto query = world.Query().With<PositionComponent, VelocityComponent>().Build();
+                return meter.measure([query]() {
+                    query.ForEachChunk([&](eastl::span<PositionComponent> positions, eastl::span<const VelocityComponent> velocities) {
+                        for (size_t i = 0; i < positions.size(); i++)
+                        {
+                            positions[i].x += velocities[i].x;
+                            positions[i].y += velocities[i].y;
+                        }
+                    });
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
         {
             bench.run("Ecs system", [&](ankerl::nanobench::Meter meter) {
                 World world;
@@ -660,6 +889,197 @@ TEST_CASE("Update entities", "[Entity]")
     }
 }
 
+struct DamageEvent : public Event
+{
+    DamageEvent(float damage) : Event(GetEventId<DamageEvent>, sizeof(DamageEvent)), damage(damage) { }
+    float damage;
+};
+
+TEST_CASE("Unicast events", "[Event]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Unicast events")
+        .warmup(100)
+        .relative(true)
+        .performanceCounters(true);
+
+    static constexpr uint32_t numEntities = 10000;
+
+    for (auto batchSize : {128U, 1024U, 100000U})
+    {
+        bench.complexityN(batchSize);
+        bench.batch(batchSize);
+        bench.minEpochTime(std::chrono::milliseconds(40));
+        bench.epochs(100);
+        bench.relative(true);
+
+        // Immediate unicast is the per entity dispatch, which deferred events used before batching.
+        for (const bool deferred : {false, true})
+        {
+            bench.run(deferred ? "Ecs deferred unicast" : "Ecs immediate unicast", [&](ankerl::nanobench::Meter meter) {
+                World world;
+                eastl::vector<Entity> entities;
+                for (uint32_t i = 0; i < numEntities; i++)
+                    entities.push_back(
+                        world
+                            .Entity()
+                            .Add<PositionComponent>(1.0f, 2.0f)
+                            .Add<VelocityComponent>(1.0f, 2.0f)
+                            .Add<DataComponent>()
+                            .Apply());
+
+                world.System().With<PositionComponent>().OnEvent<DamageEvent>().ForEach([](const DamageEvent& event, PositionComponent& position) {
+                    position.x -= event.damage;
+                });
+                world.OrderSystems();
+
+                std::random_device dev;
+                ankerl::nanobench::Rng rng(dev());
+
+                return meter.measure([&world, &entities, &rng, batchSize, deferred]() {
+                    for (uint32_t i = 0; i < batchSize; i++)
+                    {
+                        auto entity = entities[rng() % numEntities];
+                        if (deferred)
+                            entity.Emit<DamageEvent>({1.0f});
+                        else
+                            entity.EmitImmediately<DamageEvent>({1.0f});
+                    }
+
+                    if (deferred)
+                        world.ProcessDefferedEvents();
+                });
+                ankerl::nanobench::doNotOptimizeAway(&world);
+            });
+        }
+    }
+}
+
+TEST_CASE("Snapshot", "[Snapshot]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Snapshot 1M entities")
+        .warmup(3)
+        .relative(true)
+        .unit("byte")
+        .minEpochIterations(5);
+
+    static constexpr uint32_t numEntities = 1000000;
+
+    World world;
+    world.CreateEntities<PositionComponent, VelocityComponent>(numEntities / 2);
+    world.CreateEntities<PositionComponent, VelocityComponent, TagComponent>(numEntities / 2);
+
+    eastl::vector<std::byte> snapshot;
+    REQUIRE(world.SaveSnapshot(snapshot));
+    bench.batch(snapshot.size());
+
+    bench.run("Ecs save", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&snapshot, &world]() {
+            snapshot.clear();
+            ankerl::nanobench::doNotOptimizeAway(world.SaveSnapshot(snapshot));
+            ankerl::nanobench::doNotOptimizeAway(snapshot.data());
+        });
+    });
+
+    bench.run("Ecs load", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&snapshot, &world]() {
+            const bool loaded = world.LoadSnapshot(snapshot);
+            ankerl::nanobench::doNotOptimizeAway(loaded);
+        });
+    });
+
+    // Lower bound, plain copy of the same amount of memory.
+    eastl::vector<std::byte> copy(snapshot.size());
+    bench.run("memcpy", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&snapshot, &copy]() {
+            std::memcpy(copy.data(), snapshot.data(), snapshot.size());
+            ankerl::nanobench::doNotOptimizeAway(copy.data());
+        });
+    });
+}
+
+struct LocalTransform
+{
+    float x, y, z;
+};
+
+struct WorldTransform
+{
+    float x, y, z;
+};
+
+TEST_CASE("Hierarchy", "[Hierarchy]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Transform propagation 100k nodes")
+        .warmup(3)
+        .relative(true)
+        .minEpochIterations(5);
+
+    static constexpr uint32_t numNodes = 100000;
+    static constexpr uint32_t numRoots = 1000;
+    bench.batch(numNodes);
+
+    World world;
+    eastl::vector<EntityId> nodes;
+    for (uint32_t i = 0; i < numNodes; i++)
+        nodes.push_back(world.Entity().Add<LocalTransform>(1.0f, 2.0f, 3.0f).Add<WorldTransform>().Apply().GetId());
+
+    // Every node is attached to a random node created earlier, roots go first.
+    const eastl::array<Meta::ComponentId, 1> deepestLevel = {Meta::GetComponentId<HierarchyDepth<MaxHierarchyDepth>>};
+    ankerl::nanobench::Rng rng(42);
+    for (uint32_t i = numRoots; i < numNodes; i++)
+    {
+        EntityId parent = nodes[rng.bounded(i)];
+        while (world.Has(parent, Meta::SortedComponentsView(deepestLevel)))
+            parent = world.GetParent(parent);
+        world.SetParent(nodes[i], parent);
+    }
+
+    const auto accumulate = [&world](const LocalTransform& local, WorldTransform& global, EntityId parent) {
+        global = {local.x, local.y, local.z};
+        if (!parent)
+            return;
+
+        world.View().With<WorldTransform>().ForEntity(parent, [&global](const WorldTransform& parentGlobal) {
+            global.x += parentGlobal.x;
+            global.y += parentGlobal.y;
+            global.z += parentGlobal.z;
+        });
+    };
+
+    const auto query = world.Query().With<LocalTransform, WorldTransform>().InDepthOrder().Build();
+    bench.run("Ecs depth ordered query", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&query, &accumulate]() {
+            query.ForEach([&accumulate](const LocalTransform& local, WorldTransform& global, const ChildOf* childOf) {
+                accumulate(local, global, childOf ? childOf->parent : EntityId());
+            });
+        });
+    });
+
+    // Baseline, walk from roots through the children lists.
+    const auto roots = world.View().With<LocalTransform, WorldTransform>().Without<ChildOf>();
+    bench.run("Ecs recursive walk", [&](ankerl::nanobench::Meter meter) {
+        return meter.measure([&world, &roots, &accumulate]() {
+            const auto visit = [&world, &accumulate](EntityId parent, const auto& self) -> void {
+                for (const auto child : world.GetChildren(parent))
+                {
+                    world.View().With<LocalTransform, WorldTransform>().ForEntity(child, [&](const LocalTransform& local, WorldTransform& global) {
+                        accumulate(local, global, parent);
+                    });
+                    self(child, self);
+                }
+            };
+
+            roots.ForEach([&](EntityId root, const LocalTransform& local, WorldTransform& global) {
+                accumulate(local, global, {});
+                visit(root, visit);
+            });
+        });
+    });
+}
+
 template <typename T>
 struct TrackableType
 {
@@ -724,6 +1144,92 @@ TEST_CASE("Tracking", "[Tracking]")
     }
 }
 
+struct UntrackedInt
+{
+    int x;
+};
+
+TEST_CASE("Tracking change rate", "[Tracking]")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Tracking change rate")
+        .warmup(100)
+        .relative(true)
+        .performanceCounters(true);
+
+    constexpr uint32_t entitiesCount = 100000;
+
+    for (auto changePercent : {1U, 10U, 100U})
+    {
+        const uint32_t changedCount = entitiesCount * changePercent / 100;
+        bench.batch(entitiesCount);
+        bench.minEpochTime(std::chrono::milliseconds(100));
+        bench.epochs(100);
+
+        // Changed entities are scattered over all chunks, as they would be in a game.
+        const auto pickChanged = [changedCount](const eastl::vector<EntityId>& entities) {
+            eastl::vector<EntityId> changed = entities;
+            ankerl::nanobench::Rng rng(42);
+            rng.shuffle(changed);
+            changed.resize(changedCount);
+            return changed;
+        };
+
+        bench.run("ECS changed:" + std::to_string(changePercent) + "%", [&](ankerl::nanobench::Meter meter) {
+            World world;
+            eastl::vector<EntityId> entities;
+            entities.reserve(entitiesCount);
+            for (uint32_t i = 0; i < entitiesCount; i++)
+                entities.push_back(world.Entity().Add<TrackableInt>(1).Apply().GetId());
+
+            world.System().Track<TrackableInt>().ForEach([&](const TrackableInt& trackableInt) {
+                ankerl::nanobench::doNotOptimizeAway(trackableInt.x);
+            });
+
+            world.OrderSystems();
+            world.ProcessTrackedChanges();
+
+            const auto changed = pickChanged(entities);
+            const auto view = world.View().With<TrackableInt>();
+            return meter.measure([&world, &changed, &view]() {
+                for (const auto entity : changed)
+                    view.ForEntity(entity, [](TrackableInt& trackableInt) { trackableInt.x++; });
+
+                world.ProcessTrackedChanges();
+            });
+        });
+
+        // Baseline without dirty flags, every component is compared against its copy from the previous run.
+        bench.run("Full compare changed:" + std::to_string(changePercent) + "%", [&](ankerl::nanobench::Meter meter) {
+            World world;
+            eastl::vector<EntityId> entities;
+            entities.reserve(entitiesCount);
+            for (uint32_t i = 0; i < entitiesCount; i++)
+                entities.push_back(world.Entity().Add<UntrackedInt>(1).Apply().GetId());
+
+            // Iteration order is stable without structural changes, so copies are matched by position.
+            eastl::vector<int> previous(entitiesCount, 1);
+
+            const auto changed = pickChanged(entities);
+            const auto view = world.View().With<UntrackedInt>();
+            return meter.measure([&changed, &view, &previous]() {
+                for (const auto entity : changed)
+                    view.ForEntity(entity, [](UntrackedInt& untrackedInt) { untrackedInt.x++; });
+
+                uint32_t index = 0;
+                view.ForEach([&previous, &index](const UntrackedInt& untrackedInt) {
+                    if (untrackedInt.x != previous[index])
+                    {
+                        previous[index] = untrackedInt.x;
+                        ankerl::nanobench::doNotOptimizeAway(untrackedInt.x);
+                    }
+                    index++;
+                });
+            });
+        });
+    }
+}
+
 /*
 TEST_CASE("hashmap", "[Entity]")
 {
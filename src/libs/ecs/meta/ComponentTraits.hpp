@@ -103,6 +103,12 @@ namespace RR::Ecs::Meta
         template <typename T>
         constexpr bool is_singleton_v<T, std::void_t<decltype(T::Singleton)>> = T::Singleton;
 
+        template <typename T, typename = void>
+        constexpr bool is_sparse_v = false;
+
+        template <typename T>
+        constexpr bool is_sparse_v<T, std::void_t<decltype(T::Sparse)>> = T::Sparse;
+
         template <typename T, typename = void>
         struct is_comparable : std::false_type
         {
@@ -208,6 +214,9 @@ namespace RR::Ecs::Meta
         std::string_view name;
         bool isTrackable : 1;
         bool isSingleton : 1;
+        bool isSparse : 1;
+        // Could be saved to snapshot and restored by memcpy.
+        bool isTriviallyCopyable : 1;
         size_t alignment : 14;
         DefaultConstructor constructDefault;
         Destructor destructor;
@@ -221,6 +230,8 @@ namespace RR::Ecs::Meta
             return id == other.id &&
                    isTrackable == other.isTrackable &&
                    isSingleton == other.isSingleton &&
+                   isSparse == other.isSparse &&
+                   isTriviallyCopyable == other.isTriviallyCopyable &&
                    size == other.size &&
                    alignment == other.alignment;
         }
@@ -230,6 +241,8 @@ namespace RR::Ecs::Meta
         static ComponentInfo Create()
         {
             constexpr bool trackable = details::is_trackable_v<T>;
+            static_assert(!details::is_sparse_v<T> || (!trackable && !details::is_singleton_v<T>),
+                          "Sparse component can't be trackable or singleton");
 
             return {
                 ComponentId(GetTypeId<T>.GetRaw()),
@@ -237,6 +250,8 @@ namespace RR::Ecs::Meta
                 GetTypeName<T>,
                 trackable,
                 details::is_singleton_v<T>,
+                details::is_sparse_v<T>,
+                std::is_trivially_copyable_v<T>,
                 alignof(T),
                 eastl::is_trivially_default_constructible_v<T> ? nullptr : &details::DefaultConstructor<T>,
                 eastl::is_trivially_destructible_v<T> ? nullptr : &details::Destructor<T>,
@@ -323,6 +338,8 @@ namespace RR::Ecs::Meta
         static constexpr bool IsTag = std::is_empty_v<T>;
         static constexpr bool IsTrackable = details::is_trackable_v<T>;
         static constexpr bool IsSingleton = details::is_singleton_v<T>;
+        // Sparse components are stored out of archetypes, so adding and removing them doesn't move entity.
+        static constexpr bool IsSparse = details::is_sparse_v<T>;
     };
 
     template <typename T>
@@ -345,4 +362,7 @@ namespace RR::Ecs::Meta
 
     template <typename T>
     static constexpr bool IsSingleton = ComponentTraits<T>::IsSingleton;
+
+    template <typename T>
+    static constexpr bool IsSparse = ComponentTraits<T>::IsSparse;
 }
\ No newline at end of file
@@ -376,6 +376,217 @@ TEST_CASE_METHOD(WorldFixture, "Entities chunking", "[Comonents]")
     REQUIRE(!entities.back().Has<int>());
 }
 
+TEST_CASE_METHOD(WorldFixture, "Chunks recycling", "[Comonents]")
+{
+    Entity entt = world.Entity().Add<int>().Apply();
+    Archetype& intArch = resolveArchetype(entt);
+    const auto initialStats = world.GetChunkPoolStats();
+
+    std::vector<Entity> entities;
+    for (size_t i = 0; i < intArch.GetChunkCapacity() * 3; i++)
+        entities.push_back(world.Entity().Add<int>().Apply());
+
+    REQUIRE(intArch.GetChunksCount() == 4);
+    const auto grownStats = world.GetChunkPoolStats();
+    REQUIRE(grownStats.usedChunks == initialStats.usedChunks + 3);
+
+    for (auto entity : entities)
+        entity.Destroy();
+
+    // Empty tail chunks are returned to the pool.
+    REQUIRE(intArch.GetChunksCount() == 1);
+    REQUIRE(world.GetChunkPoolStats().usedChunks == initialStats.usedChunks);
+    REQUIRE(world.GetChunkPoolStats().freeChunks == grownStats.freeChunks + 3);
+
+    const auto slabsCount = world.GetChunkPoolStats().slabsCount;
+    for (size_t i = 0; i < intArch.GetChunkCapacity() * 3; i++)
+        world.Entity().Add<int>().Apply();
+
+    REQUIRE(world.GetChunkPoolStats().slabsCount == slabsCount);
+    REQUIRE(world.GetChunkPoolStats().pooledChunks == world.GetChunkPoolStats().usedChunks + world.GetChunkPoolStats().freeChunks);
+}
+
+TEST_CASE("Chunk size policy", "[Comonents]")
+{
+    ChunkPoolDescription description;
+    description.baseChunkSize = 4 * 1024;
+    description.minEntitiesPerChunk = 16;
+    description.slabSize = 64 * 1024;
+
+    World world(description);
+    Entity entt = world.Entity().Add<int>().Apply();
+    Archetype& intArch = resolveArchetype(entt);
+
+    REQUIRE(intArch.GetChunkSize() == 4 * 1024);
+    REQUIRE(intArch.GetChunkCapacity() >= 16);
+
+    const auto stats = world.GetChunkPoolStats();
+    REQUIRE(stats.slabsCount > 0);
+    REQUIRE(stats.reservedBytes >= stats.slabsCount * 64 * 1024);
+}
+
+TEST_CASE("Compaction", "[Comonents]")
+{
+    struct Tag { };
+
+    ChunkPoolDescription description;
+    description.baseChunkSize = 4 * 1024;
+    description.minEntitiesPerChunk = 16;
+    description.slabSize = 4 * 1024;
+
+    World world(description);
+    // Archetypes matched by query are kept even if empty.
+    Query query = world.Query().With<int>().Build();
+
+    world.CreateEntities<float, Tag>(3000);
+    world.CreateEntities<int>(10);
+    Entity entt = world.Entity().Add<double>(1.0).Apply();
+    REQUIRE(world.Compact());
+
+    eastl::vector<ArchetypeProfile> archetypes;
+    world.GetArchetypesProfile(archetypes);
+    const size_t archetypesCount = archetypes.size();
+    const auto peakStats = world.GetChunkPoolStats();
+
+    entt.Edit().Add<float>(1.0f).Apply();
+    entt.Edit().Remove<float>().Apply();
+
+    // Depth ordered view sorts matched archetypes in a temporary cache, which doesn't keep them.
+    int matched = 0;
+    world.View().With<float>().InDepthOrder().ForEach([&matched](float) { matched++; });
+    REQUIRE(matched == 3000);
+
+    world.DestroyEntities(world.View().With<Tag>());
+    world.DestroyEntities(world.View().With<int>());
+
+    SECTION("Full pass") { REQUIRE(world.Compact()); }
+    SECTION("Incremental pass")
+    {
+        uint32_t calls = 1;
+        while (!world.Compact(std::chrono::nanoseconds(0)))
+            calls++;
+        REQUIRE(calls > 1);
+    }
+
+    // Float and tag, double and float archetypes are dropped.
+    world.GetArchetypesProfile(archetypes);
+    REQUIRE(archetypes.size() == archetypesCount - 1);
+    REQUIRE(world.GetChunkPoolStats().reservedBytes < peakStats.reservedBytes);
+    REQUIRE(world.GetChunkPoolStats().usedChunks < peakStats.usedChunks);
+
+    Archetype& doubleArch = resolveArchetype(entt);
+    REQUIRE(!doubleArch.FindEdge(Archetype::EdgeType::Add, Meta::GetComponentId<float>));
+
+    entt.Edit().Add<float>(2.0f).Apply();
+    REQUIRE(doubleArch.FindEdge(Archetype::EdgeType::Add, Meta::GetComponentId<float>));
+    world.CreateEntities<float, Tag>(10);
+    world.CreateEntities<int>(10);
+
+    int count = 0;
+    world.View().With<float>().ForEach([&count]() { count++; });
+    REQUIRE(count == 11);
+
+    count = 0;
+    query.ForEach([&count](int) { count++; });
+    REQUIRE(count == 10);
+}
+
+TEST_CASE("Archetype edges", "[Comonents]")
+{
+    struct Tag { };
+
+    auto test = [](World& world) {
+        for (int i = 0; i < 3; i++)
+        {
+            Entity entt = world.Entity().Add<int>(i).Apply();
+            entt.Edit().Add<Tag>().Apply();
+            entt.Edit().Add<float>(1.0f).Apply();
+            entt.Edit().Remove<Tag>().Apply();
+        }
+    };
+
+    auto check = [](World& world) {
+        int count = 0;
+        world.View().With<int, float>().Without<Tag>().ForEach([&count](int value, float) { REQUIRE(value == count++); });
+        REQUIRE(count == 3);
+
+        Entity entt = world.Entity().Add<int>(0).Apply();
+        Archetype& intArch = resolveArchetype(entt);
+        const ArchetypeEdge* addTag = intArch.FindEdge(Archetype::EdgeType::Add, Meta::GetComponentId<Tag>);
+        REQUIRE(addTag);
+        REQUIRE(addTag->to->FindEdge(Archetype::EdgeType::Add, Meta::GetComponentId<float>));
+        REQUIRE(!intArch.FindEdge(Archetype::EdgeType::Remove, Meta::GetComponentId<Tag>));
+
+        entt.Edit().Add<Tag>().Apply();
+        REQUIRE(&resolveArchetype(entt) == addTag->to);
+        REQUIRE_THROWS(entt.Edit().Add<Tag>().Apply());
+    };
+
+    SECTION("Immediate") { immediateTest(test, check); }
+    SECTION("Deffered") { defferedTest(test, check); }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Bulk create and destroy", "[Comonents]")
+{
+    struct Tag { };
+
+    int appearCalls = 0;
+    int appearSum = 0;
+    int dissapearCalls = 0;
+    // Initializer is done before OnAppear.
+    world.System().With<int>().OnEvent<OnAppear>().ForEach([&appearCalls, &appearSum](const int& value) { appearCalls++; appearSum += value; });
+    world.System().With<int>().OnEvent<OnDissapear>().ForEach([&dissapearCalls]() { dissapearCalls++; });
+    world.OrderSystems();
+
+    constexpr uint32_t count = 3000;
+    eastl::vector<EntityId> entities;
+    world.CreateEntities<int, float, Tag>(count, [&entities](EntityId id, int& value, float& floatValue) {
+        value = int(entities.size());
+        floatValue = float(value);
+        entities.push_back(id);
+    });
+
+    REQUIRE(entities.size() == count);
+    REQUIRE(appearCalls == count);
+    REQUIRE(appearSum == count * (count - 1) / 2);
+    REQUIRE(resolveArchetype(world.GetEntity(entities.back())).GetChunksCount() > 1);
+
+    int index = 0;
+    world.View().With<int, float, Tag>().ForEach([&](EntityId id, int value, float floatValue) {
+        REQUIRE(id == entities[index]);
+        REQUIRE(value == index);
+        REQUIRE(floatValue == float(index));
+        index++;
+    });
+    REQUIRE(index == count);
+
+    world.CreateEntities<int>(10);
+    REQUIRE(appearCalls == count + 10);
+
+    world.DestroyEntities(world.View().With<Tag>());
+    REQUIRE(dissapearCalls == count);
+
+    for (auto entity : entities)
+        REQUIRE(!world.IsAlive(entity));
+
+    index = 0;
+    world.View().With<int>().ForEach([&index]() { index++; });
+    REQUIRE(index == 10);
+
+    SECTION("Reused ids")
+    {
+        eastl::vector<EntityId> reused;
+        world.CreateEntities<int>(count, [&reused](EntityId id) { reused.push_back(id); });
+        REQUIRE(reused.size() == count);
+        for (auto entity : reused)
+            REQUIRE(world.IsAlive(entity));
+
+        world.DestroyEntities(reused);
+        for (auto entity : reused)
+            REQUIRE(!world.IsAlive(entity));
+    }
+}
+
 TEST_CASE("Remove and Move NonTrivial Components", "[Components]")
 {
     World& world  = *new World();
@@ -511,6 +722,420 @@ TEST_CASE_METHOD(WorldFixture, "Trackable singleton size", "[Singleton]")
     REQUIRE(arch.GetChunkCapacity() == 1);
     REQUIRE(arch.GetEntitySize() == sizeof(EntityId) + sizeof(int) + sizeof(TrackableSingleton<int>) + sizeof(TrackableSingleton<int>));
 }
+namespace
+{
+    struct SparseValue
+    {
+        ECS_SPARSE;
+        int value;
+    };
+
+    struct SparseTag
+    {
+        ECS_SPARSE;
+    };
+}
+
+TEST_CASE_METHOD(WorldFixture, "Sparse components", "[Components]")
+{
+    auto entt1 = world.Entity().Add<int>(1).Add<SparseValue>(10).Apply();
+    auto entt2 = world.Entity().Add<int>(2).Apply();
+    Archetype& archetype = resolveArchetype(entt2);
+
+    // Sparse components don't move entity between archetypes.
+    REQUIRE(&resolveArchetype(entt1) == &archetype);
+    entt2.Edit().Add<SparseTag>().Apply();
+    REQUIRE(&resolveArchetype(entt2) == &archetype);
+    REQUIRE(entt1.Has<int, SparseValue>());
+    REQUIRE(!entt1.Has<SparseTag>());
+    REQUIRE(entt2.Has<SparseTag>());
+    REQUIRE_THROWS(entt2.Edit().Add<SparseTag>().Apply());
+
+    int sum = 0;
+    world.View().With<int, SparseValue>().ForEach([&sum](int i, const SparseValue& sparse) { sum += i + sparse.value; });
+    REQUIRE(sum == 11);
+
+    sum = 0;
+    world.View().With<int>().Without<SparseTag>().ForEach([&sum](int i, SparseValue* sparse) { sum += i + (sparse ? sparse->value : 0); });
+    REQUIRE(sum == 11);
+
+    sum = 0;
+    world.View().With<int>().ForEach([&sum](int i, SparseTag* tag) { sum += tag ? i : 0; });
+    REQUIRE(sum == 2);
+
+    // Changes made while the world is locked are deferred.
+    world.View().With<int>().ForEach([this](EntityId entityId, const int& i) {
+        auto entity = world.GetEntity(entityId);
+        if (i == 1)
+            entity.Edit().Add<SparseTag>().Remove<SparseValue>().Apply();
+        else
+            entity.Edit().Add<SparseValue>(20).Apply();
+    });
+
+    REQUIRE(entt1.Has<SparseTag>());
+    REQUIRE(!entt1.Has<SparseValue>());
+    REQUIRE(entt2.Has<SparseValue>());
+    REQUIRE(&resolveArchetype(entt1) == &archetype);
+
+    sum = 0;
+    world.View().With<int, SparseValue, SparseTag>().ForEach([&sum](int i, const SparseValue& sparse) { sum += i + sparse.value; });
+    REQUIRE(sum == 22);
+
+    entt2.Edit().Remove<SparseTag>().Apply();
+    REQUIRE(!entt2.Has<SparseTag>());
+    REQUIRE_THROWS(entt2.Edit().Remove<SparseTag>().Apply());
+
+    entt2.Destroy();
+    sum = 0;
+    world.View().With<int, SparseValue>().ForEach([&sum](int) { sum++; });
+    REQUIRE(sum == 0);
+
+    // Recycled entity doesn't inherit sparse components of the destroyed one.
+    auto entt3 = world.Entity().Add<int>(3).Apply();
+    REQUIRE(!entt3.Has<SparseValue>());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Bulk create sparse components", "[Components]")
+{
+    constexpr int count = 3000;
+    world.CreateEntities<int, SparseValue, SparseTag>(count, [](int& value, SparseValue& sparse) {
+        sparse.value = value = 1;
+    });
+    world.CreateEntities<int>(10);
+
+    // Sparse components stay out of the archetype, so bulk created entities share it with the rest.
+    eastl::vector<EntityId> ids;
+    world.View().With<int>().ForEach([&ids](EntityId id) { ids.push_back(id); });
+    REQUIRE(ids.size() == size_t(count) + 10);
+
+    const Archetype& archetype = resolveArchetype(world.GetEntity(ids.front()));
+    REQUIRE(&resolveArchetype(world.GetEntity(ids.back())) == &archetype);
+    REQUIRE(archetype.GetChunksCount() > 1);
+
+    int sum = 0;
+    world.View().With<int, SparseValue, SparseTag>().ForEach([&sum](int value, const SparseValue& sparse) { sum += value + sparse.value; });
+    REQUIRE(sum == count * 2);
+
+    int entities = 0;
+    world.View().With<int>().Without<SparseTag>().ForEach([&entities]() { entities++; });
+    REQUIRE(entities == 10);
+}
+
+TEST_CASE("Snapshot", "[Snapshot]")
+{
+    struct Position { float x, y; };
+    struct Tag { };
+
+    const auto setup = [](World& world) {
+        world.System().With<Position>().OnEvent<OnAppear>().ForEach([]() { });
+        world.Query().With<int>().Build();
+        world.OrderSystems();
+
+        world.RegisterComponent<int>();
+        world.RegisterComponent<float>();
+        world.RegisterComponent<Tag>();
+        world.RegisterComponent<SparseValue>();
+        world.RegisterComponent<SingletonComponent<int>>();
+    };
+
+    World world;
+    setup(world);
+
+    eastl::vector<EntityId> entities;
+    for (int i = 0; i < 300; i++)
+        entities.push_back(world.Entity().Add<int>(i).Add<float>(float(i)).Apply().GetId());
+    for (int i = 0; i < 100; i++)
+        entities.push_back(world.Entity().Add<int>(i).Add<Tag>().Apply().GetId());
+
+    const auto sparseEntt = world.GetEntity(entities[5]);
+    sparseEntt.Edit().Add<SparseValue>(42).Apply();
+    world.Entity().Add<SingletonComponent<int>>(7).Apply();
+    world.Destroy(entities[1]);
+    world.Destroy(entities[350]);
+
+    const auto checkWorld = [&entities, &sparseEntt](World& world) {
+        int sum = 0, count = 0;
+        world.View().With<int, float>().ForEach([&](int i, float f) { sum += i + int(f); count++; });
+        REQUIRE(count == 299);
+        REQUIRE(sum == 2 * (299 * 300 / 2 - 1));
+
+        count = 0;
+        world.View().With<int, Tag>().ForEach([&count]() { count++; });
+        REQUIRE(count == 99);
+
+        REQUIRE(!world.IsAlive(entities[1]));
+        REQUIRE(!world.IsAlive(entities[350]));
+        REQUIRE(world.IsAlive(entities[0]));
+        REQUIRE(world.GetEntity(entities[5]).Has<SparseValue>());
+        REQUIRE(!world.GetEntity(entities[6]).Has<SparseValue>());
+
+        sum = 0;
+        world.View().With<SparseValue>().ForEach([&sum](const SparseValue& value) { sum += value.value; });
+        REQUIRE(sum == 42);
+        UNUSED(sparseEntt);
+
+        count = 0;
+        world.View().With<SingletonComponent<int>>().ForEach([&count](const SingletonComponent<int>& singleton) { count += singleton.x; });
+        REQUIRE(count == 7);
+    };
+
+    eastl::vector<std::byte> buffer;
+    REQUIRE(world.SaveSnapshot(buffer));
+
+    const auto createdBefore = world.Entity().Add<int>(0).Apply().GetId();
+    world.Destroy(entities[0]);
+    world.Destroy(entities[5]);
+    world.View().With<int>().ForEach([](int& i) { i = -1; });
+    world.Entity().Add<Position>().Apply();
+
+    REQUIRE(world.LoadSnapshot(buffer));
+    checkWorld(world);
+
+    // Free list is restored, so the same ids are handed out.
+    REQUIRE(world.Entity().Add<int>(0).Apply().GetId() == createdBefore);
+
+    SECTION("Same snapshot")
+    {
+        World other;
+        setup(other);
+        REQUIRE(other.LoadSnapshot(buffer));
+        checkWorld(other);
+
+        eastl::vector<std::byte> otherBuffer;
+        REQUIRE(other.SaveSnapshot(otherBuffer));
+        REQUIRE(otherBuffer == buffer);
+    }
+
+    SECTION("Different systems")
+    {
+        World other;
+        REQUIRE(!other.LoadSnapshot(buffer));
+    }
+
+    SECTION("Malformed")
+    {
+        REQUIRE(!world.LoadSnapshot({buffer.data(), buffer.size() - 1}));
+        REQUIRE(!world.LoadSnapshot({buffer.data() + 1, buffer.size() - 1}));
+        REQUIRE(world.IsAlive(entities[0]));
+    }
+
+    SECTION("Non trivially copyable")
+    {
+        // Save is refused in every build, so raw bytes of the string are never written.
+        world.Entity().Add<eastl::string>("string").Apply();
+        const size_t size = buffer.size();
+        REQUIRE(!world.SaveSnapshot(buffer));
+        REQUIRE(buffer.size() == size);
+    }
+
+    SECTION("Singletons")
+    {
+        World other;
+        setup(other);
+        other.Entity().Add<int>(0).Apply();
+
+        eastl::vector<std::byte> otherBuffer;
+        REQUIRE(other.SaveSnapshot(otherBuffer));
+
+        // Singleton is replaced by the load, so it could be created again.
+        other.Entity().Add<SingletonComponent<int>>(1).Apply();
+        REQUIRE(other.LoadSnapshot(otherBuffer));
+        other.Entity().Add<SingletonComponent<int>>(2).Apply();
+
+        REQUIRE(other.LoadSnapshot(buffer));
+        REQUIRE_THROWS(other.Entity().Add<SingletonComponent<int>>(3).Apply());
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Hierarchy", "[Hierarchy]")
+{
+    const auto root = world.Entity().Add<int>(0).Apply().GetId();
+    const auto child = world.Entity().Add<int>(1).Apply().GetId();
+    const auto grandChild = world.Entity().Add<int>(2).Apply().GetId();
+    const auto other = world.Entity().Add<int>(3).Apply().GetId();
+
+    world.SetParent(child, root);
+    world.SetParent(grandChild, child);
+
+    auto getDepth = [&](EntityId entityId) {
+        Archetype* archetype = nullptr;
+        ArchetypeEntityIndex index;
+        REQUIRE(world.GetEntity(entityId).ResolveArhetype(archetype, index));
+        return archetype->GetHierarchyDepth();
+    };
+
+    REQUIRE(world.GetParent(root) == EntityId());
+    REQUIRE(world.GetParent(child) == root);
+    REQUIRE(world.GetParent(grandChild) == child);
+    REQUIRE(world.GetChildren(root).size() == 1);
+    REQUIRE(world.GetChildren(root)[0] == child);
+    REQUIRE(getDepth(root) == 0);
+    REQUIRE(getDepth(child) == 1);
+    REQUIRE(getDepth(grandChild) == 2);
+
+    SECTION("Components are kept")
+    {
+        world.View().With<int>().ForEntity(grandChild, [](int value) { REQUIRE(value == 2); });
+        world.View().With<int, ChildOf>().ForEntity(child, [&](int value, const ChildOf& childOf) {
+            REQUIRE(value == 1);
+            REQUIRE(childOf.parent == root);
+        });
+    }
+
+    SECTION("Reparent moves descendants")
+    {
+        world.SetParent(root, other);
+        REQUIRE(getDepth(root) == 1);
+        REQUIRE(getDepth(child) == 2);
+        REQUIRE(getDepth(grandChild) == 3);
+
+        world.SetParent(child, other);
+        REQUIRE(world.GetChildren(root).empty());
+        REQUIRE(world.GetChildren(other).size() == 2);
+        REQUIRE(getDepth(child) == 1);
+        REQUIRE(getDepth(grandChild) == 2);
+
+        world.SetParent(child, {});
+        REQUIRE(world.GetParent(child) == EntityId());
+        REQUIRE(getDepth(child) == 0);
+        REQUIRE(getDepth(grandChild) == 1);
+        REQUIRE(!world.Has(child, Meta::SortedComponentsView(eastl::array {Meta::GetComponentId<ChildOf>})));
+    }
+
+    SECTION("Cycles are rejected")
+    {
+        REQUIRE_THROWS(world.SetParent(root, grandChild));
+        REQUIRE_THROWS(world.SetParent(root, root));
+        REQUIRE(world.GetParent(root) == EntityId());
+    }
+
+    SECTION("Destroy destroys descendants")
+    {
+        world.Destroy(child);
+        REQUIRE(world.IsAlive(root));
+        REQUIRE(!world.IsAlive(child));
+        REQUIRE(!world.IsAlive(grandChild));
+        REQUIRE(world.GetChildren(root).empty());
+    }
+
+    SECTION("Bulk destroy destroys descendants")
+    {
+        world.SetParent(other, grandChild);
+        world.DestroyEntities(world.View().With<int>().Without<ChildOf>());
+        REQUIRE(!world.IsAlive(root));
+        REQUIRE(!world.IsAlive(child));
+        REQUIRE(!world.IsAlive(grandChild));
+        REQUIRE(!world.IsAlive(other));
+    }
+
+    SECTION("Deferred")
+    {
+        world.View().With<int>().ForEntity(other, [&](int) {
+            world.SetParent(other, grandChild);
+            REQUIRE(world.GetParent(other) == EntityId());
+        });
+        REQUIRE(world.GetParent(other) == grandChild);
+        REQUIRE(getDepth(other) == 3);
+    }
+
+    SECTION("Snapshot")
+    {
+        eastl::vector<std::byte> buffer;
+        REQUIRE(world.SaveSnapshot(buffer));
+
+        World loaded;
+        loaded.RegisterComponent<int>();
+        REQUIRE(loaded.LoadSnapshot(buffer));
+        REQUIRE(loaded.GetParent(grandChild) == child);
+        REQUIRE(loaded.GetChildren(root).size() == 1);
+
+        loaded.Destroy(root);
+        REQUIRE(!loaded.IsAlive(grandChild));
+    }
+}
+
+namespace
+{
+    struct Health
+    {
+        ECS_TRACKABLE;
+        int value;
+        bool operator==(const Health& other) const { return value == other.value; }
+    };
+}
+
+TEST_CASE_METHOD(WorldFixture, "Prefab", "[Prefab]")
+{
+    int appeared = 0;
+    eastl::vector<int> changed;
+    world.System().With<int>().OnEvent<OnAppear>().ForEach([&appeared]() { appeared++; });
+    world.System().Track<Health>().ForEach([&changed](const Health& health) { changed.push_back(health.value); });
+    world.OrderSystems();
+
+    const auto prefab = world.Entity().Add<Prefab>().Add<int>(7).Add<Health>(100).Add<eastl::string>("name").Add<SparseValue>(3).Apply().GetId();
+    REQUIRE(appeared == 0);
+
+    int matched = 0;
+    world.View().With<int>().ForEach([&matched]() { matched++; });
+    REQUIRE(matched == 0);
+
+    // Prefab is accessed by id as usual.
+    world.View().With<int>().ForEntity(prefab, [](int& value) { value = 8; });
+
+    SECTION("Instantiate")
+    {
+        constexpr uint32_t Count = 1000;
+        int initialized = 0;
+        world.Instantiate(prefab, Count, [&initialized](int& value) { value += initialized++; });
+        world.Instantiate(prefab, 1);
+        REQUIRE(initialized == int(Count));
+        REQUIRE(appeared == int(Count) + 1);
+
+        eastl::vector<int> values;
+        world.View().With<int, Health, eastl::string>().Without<Prefab>().ForEach([&values](EntityId entityId, int value, const Health& health, const eastl::string& name) {
+            UNUSED(entityId);
+            REQUIRE(health.value == 100);
+            REQUIRE(name == "name");
+            values.push_back(value);
+        });
+        REQUIRE(values.size() == Count + 1);
+        eastl::sort(values.begin(), values.end());
+        for (uint32_t index = 0; index < Count; index++)
+            REQUIRE(values[index + 1] == 8 + int(index));
+
+        int sparse = 0;
+        world.View().With<SparseValue>().ForEach([&sparse](const SparseValue& value) { sparse += value.value; });
+        REQUIRE(sparse == 3 * int(Count + 1));
+
+        // Instances are created with the prefab values, so nothing is changed.
+        world.ProcessTrackedChanges();
+        REQUIRE(changed.empty());
+
+        world.View().With<Health>().ForEach([](Health& health) { health.value--; });
+        world.ProcessTrackedChanges();
+        REQUIRE(changed.size() == Count + 1);
+    }
+
+    SECTION("Hierarchy")
+    {
+        const auto parent = world.Entity().Add<float>().Apply().GetId();
+        world.SetParent(prefab, parent);
+        world.Instantiate(prefab, 2);
+
+        int roots = 0;
+        world.View().With<int>().Without<ChildOf>().ForEach([&roots]() { roots++; });
+        REQUIRE(roots == 2);
+        REQUIRE(world.GetChildren(parent).size() == 1);
+    }
+
+    SECTION("Not a prefab")
+    {
+        const auto entity = world.Entity().Add<int>(1).Apply().GetId();
+        REQUIRE_THROWS(world.Instantiate(entity, 1));
+        REQUIRE_THROWS(world.Instantiate(EntityId(), 1));
+    }
+}
+
 /*
 #include <flecs.h>
 
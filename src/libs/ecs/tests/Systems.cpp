@@ -283,6 +283,70 @@ TEST_CASE_METHOD(WorldFixture, "Unicast event deffered", "[Event]")
     REQUIRE(data[4].second == 3);
 }
 
+TEST_CASE_METHOD(WorldFixture, "Unicast event deffered batch", "[Event]")
+{
+    eastl::vector<Entity> entities;
+    for (int i = 0; i < 1000; i++)
+        entities.push_back(i % 2 ? world.Entity().Add<int>(i).Apply() : world.Entity().Add<int>(i).Add<float>(0.0f).Apply());
+
+    int mismatches = 0;
+    eastl::vector<int> received(entities.size(), 0);
+    world.System().With<int>().OnEvent<IntEvent>().ForEach([&](const IntEvent& event, const int& value) {
+        // Every entity gets own events in emission order.
+        if (event.value != value * 10 + received[value])
+            mismatches++;
+        received[value]++;
+    });
+
+    world.System().With<float>().OnEvent<TestEvent>().ForEach([&](EntityId id) { world.Destroy(id); });
+    world.System().With<float>().OnEvent<TestEvent>().ForEach([&]() { mismatches++; });
+    world.OrderSystems();
+
+    for (int i = int(entities.size()) - 1; i >= 0; i--)
+        for (int j = 0; j < 3; j++)
+            entities[i].Emit<IntEvent>({i * 10 + j});
+
+    entities[0].Emit<TestEvent>({});
+    entities[2].Emit<TestEvent>({});
+
+    world.ProcessDefferedEvents();
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(eastl::all_of(received.begin(), received.end(), [](int count) { return count == 3; }));
+    REQUIRE(!entities[0].IsAlive());
+    REQUIRE(!entities[2].IsAlive());
+    REQUIRE(entities[4].IsAlive());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Multi frame event", "[Event]")
+{
+    const auto entt1 = world.Entity().Add<int>(1).Apply();
+    const auto entt2 = world.Entity().Add<int>(2).Apply();
+
+    eastl::vector<eastl::pair<int, int>> data;
+    world.System().With<int>().OnEvent<IntEvent>().ForEach([&data](const IntEvent& event, const int& value) { data.emplace_back(value, event.value); });
+    world.OrderSystems();
+
+    world.EmitFor<IntEvent>(3, entt1, {10});
+    world.EmitFor<IntEvent>(2, entt2, {20});
+    world.ProcessDefferedEvents();
+    REQUIRE(data == eastl::vector<eastl::pair<int, int>> {{1, 10}, {2, 20}});
+
+    // Events emitted earlier are delivered first.
+    data.clear();
+    entt2.Emit<IntEvent>({30});
+    world.ProcessDefferedEvents();
+    REQUIRE(data == eastl::vector<eastl::pair<int, int>> {{1, 10}, {2, 20}, {2, 30}});
+
+    data.clear();
+    world.Destroy(entt1.GetId());
+    world.ProcessDefferedEvents();
+    REQUIRE(data.empty());
+
+    world.ProcessDefferedEvents();
+    REQUIRE(data.empty());
+}
+
 TEST_CASE_METHOD(WorldFixture, "OnAppear", "[Event]")
 {
     SECTION("Simple")
@@ -445,3 +509,703 @@ TEST_CASE_METHOD(WorldFixture, "Produce and require same token", "[System]")
 {
     REQUIRE_THROWS_WITH(world.System("system1").Produce<System1>().Require<System1>().ForEach([&]() { }), "Token System1 can't be produced and required at the same time.");
 }
+
+TEST_CASE_METHOD(WorldFixture, "Parallel system", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+
+    auto check = [&] {
+        std::atomic<int> calls = 0;
+        const auto system = world.System().With<Foo>().Parallel().ForEach([&calls](Foo& foo) {
+            foo.x *= 2;
+            calls++;
+        });
+
+        system.Run();
+        REQUIRE(calls == EntitiesCount);
+        REQUIRE(!world.IsLocked());
+
+        int64_t summ = 0;
+        world.View().With<Foo>().ForEach([&summ](const Foo& foo) { summ += foo.x; });
+        REQUIRE(summ == int64_t(EntitiesCount) * (EntitiesCount - 1));
+    };
+
+    SECTION("Serial fallback") { check(); }
+    SECTION("Job system")
+    {
+        world.SetJobSystem(&jobSystem);
+        check();
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Chunk system", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+
+    auto check = [&] {
+        std::atomic<int> calls = 0;
+        const auto system = world.System().With<Foo>().Parallel().ForEachChunk([&calls](eastl::span<Foo> foos) {
+            for (auto& foo : foos)
+                foo.x *= 2;
+            calls += int(foos.size());
+        });
+
+        system.Run();
+        REQUIRE(calls == EntitiesCount);
+        REQUIRE(!world.IsLocked());
+
+        int64_t summ = 0;
+        world.View().With<Foo>().ForEach([&summ](const Foo& foo) { summ += foo.x; });
+        REQUIRE(summ == int64_t(EntitiesCount) * (EntitiesCount - 1));
+    };
+
+    SECTION("Serial fallback") { check(); }
+    SECTION("Job system")
+    {
+        world.SetJobSystem(&jobSystem);
+        check();
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Parallel system structural changes", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    struct Bar { };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+
+    const auto system = world.System().With<Foo>().Parallel(4).ForEach([](World& world, EntityId id, const Foo& foo) {
+        if (foo.x % 2)
+            world.Destroy(id);
+        else
+            world.GetEntity(id).Edit().Add<Bar>().Apply();
+    });
+    world.OrderSystems();
+
+    system.Run();
+    REQUIRE(!world.IsLocked());
+
+    int fooCount = 0;
+    world.View().With<Foo>().ForEach([&fooCount]() { fooCount++; });
+    REQUIRE(fooCount == EntitiesCount / 2);
+
+    int barCount = 0;
+    world.View().With<Foo, Bar>().ForEach([&barCount](const Foo& foo) {
+        REQUIRE(foo.x % 2 == 0);
+        barCount++;
+    });
+    REQUIRE(barCount == EntitiesCount / 2);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Parallel command buffers stress", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+    struct Baz { };
+    constexpr int EntitiesCount = 20000;
+    constexpr int RunsCount = 3;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(4);
+    world.SetJobSystem(&jobSystem);
+
+    eastl::vector<int> appeared;
+    world.System().With<Bar>().OnEvent<OnAppear>().ForEach([&appeared](const Bar& bar) { appeared.push_back(bar.x); });
+
+    std::atomic<int> visibleCreated = 0;
+    const auto system = world.System().With<Foo>().Without<Baz>().Parallel().ForEach([&visibleCreated](World& world, EntityId id, const Foo& foo) {
+        const auto created = world.Entity().Add<Bar>(foo.x).Apply();
+        if (world.IsAlive(created.GetId()))
+            visibleCreated++;
+
+        if (foo.x % 3 == 0)
+            world.Destroy(id);
+        else if (foo.x % 3 == 1)
+            world.GetEntity(id).Edit().Add<Baz>().Apply();
+    });
+    world.OrderSystems();
+
+    int barCount = 0;
+    for (int run = 0; run < RunsCount; run++)
+    {
+        // Changes are applied in the iteration order, regardless of the tasks scheduling.
+        eastl::vector<int> expected;
+        world.View().With<Foo>().Without<Baz>().ForEach([&expected](const Foo& foo) { expected.push_back(foo.x); });
+
+        appeared.clear();
+        system.Run();
+        REQUIRE(!world.IsLocked());
+        REQUIRE(appeared == expected);
+        REQUIRE(visibleCreated == 0);
+        barCount += int(expected.size());
+    }
+
+    absl::flat_hash_set<uint32_t> barIds;
+    world.View().With<Bar>().ForEach([&](EntityId id) {
+        REQUIRE(world.IsAlive(id));
+        barIds.insert(id.GetRaw());
+    });
+    REQUIRE(int(barIds.size()) == barCount);
+
+    int fooCount = 0;
+    world.View().With<Foo>().ForEach([&fooCount](const Foo& foo) {
+        REQUIRE(foo.x % 3 != 0);
+        fooCount++;
+    });
+    REQUIRE(fooCount == EntitiesCount - (EntitiesCount + 2) / 3);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Parallel changes of the same entity", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    struct Bar { };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+
+    SECTION("Different tasks")
+    {
+        const EntityId shared = world.Entity().Add<int>(0).Apply().GetId();
+
+        // First and last entities are in different chunks, so they are processed by different tasks.
+        const auto system = world.System().With<Foo>().Parallel(1).ForEach([shared](World& world, const Foo& foo) {
+            if (foo.x == 0)
+                world.GetEntity(shared).Edit().Add<Bar>().Apply();
+            else if (foo.x == EntitiesCount - 1)
+                world.Destroy(shared);
+        });
+        world.OrderSystems();
+
+        REQUIRE_THROWS_WITH(system.Run(), Catch::Matchers::ContainsSubstring("can't be changed or destroyed by different parallel tasks"));
+        REQUIRE(!world.IsLocked());
+
+        // Change of the task, which came first, is applied.
+        REQUIRE((!world.IsAlive(shared) || world.GetEntity(shared).Has<Bar>()));
+    }
+
+    SECTION("Created by task")
+    {
+        std::atomic<int> created = 0;
+        const auto system = world.System().With<Foo>().Parallel(1).ForEach([&created](World& world, const Foo& foo) {
+            const auto entity = world.Entity().Add<int>(foo.x).Apply();
+            created++;
+            if (foo.x == 0)
+                entity.Edit().Add<Bar>().Apply();
+        });
+        world.OrderSystems();
+
+        REQUIRE_THROWS_WITH(system.Run(), Catch::Matchers::ContainsSubstring("created by parallel task can't be changed or destroyed"));
+        REQUIRE(!world.IsLocked());
+
+        // Created entities are committed, only the change is dropped.
+        int count = 0;
+        world.View().With<int>().Without<Bar>().ForEach([&count]() { count++; });
+        REQUIRE(count == created);
+        REQUIRE(world.Entity().Add<int>(-1).Apply().IsAlive());
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Parallel spawns reuse ids", "[System][Parallel]")
+{
+    struct Foo { int x; };
+    struct Spawned { int x; };
+    constexpr int EntitiesCount = 1000;
+    constexpr int FramesCount = 50;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+
+    const auto despawn = world.System().With<Spawned>().Parallel(4).ForEach([](World& world, EntityId id) { world.Destroy(id); });
+    const auto spawn = world.System().With<Foo>().Parallel(4).ForEach([](World& world, const Foo& foo) { world.Entity().Add<Spawned>(foo.x).Apply(); });
+    world.OrderSystems();
+
+    // Ids freed by the previous frame are reused, so records don't grow.
+    uint32_t firstFrameMaxIndex = 0;
+    for (int frame = 0; frame < FramesCount; frame++)
+    {
+        despawn.Run();
+        spawn.Run();
+        REQUIRE(!world.IsLocked());
+
+        uint32_t maxIndex = 0;
+        int64_t sum = 0;
+        int count = 0;
+        world.View().With<Spawned>().ForEach([&](EntityId id, const Spawned& spawned) {
+            maxIndex = eastl::max(maxIndex, id.GetIndex());
+            sum += spawned.x;
+            count++;
+        });
+
+        REQUIRE(count == EntitiesCount);
+        REQUIRE(sum == int64_t(EntitiesCount) * (EntitiesCount - 1) / 2);
+
+        if (frame == 0)
+            firstFrameMaxIndex = maxIndex;
+        REQUIRE(maxIndex == firstFrameMaxIndex);
+    }
+
+    // Reused ids are alive and editable after the dispatch.
+    world.View().With<Spawned>().ForEach([&](EntityId id) { REQUIRE(world.IsAlive(id)); });
+    REQUIRE(world.Entity().Add<Spawned>(-1).Apply().IsAlive());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Systems run on the calling thread by default", "[System][Schedule][Parallel]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+    world.Entity().Add<Foo>(0).Apply();
+    world.Entity().Add<Bar>(0).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+
+    // Systems capture the world instead of taking it as an argument, so they are not exclusive and share the wave.
+    World& captured = world;
+    eastl::vector<std::thread::id> threads;
+    world.System("foo").With<Foo>().ForEach([&captured, &threads](Foo& foo) {
+        threads.push_back(std::this_thread::get_id());
+        foo.x = int(captured.IsLocked());
+    });
+    world.System("bar").With<Bar>().ForEach([&captured, &threads](Bar& bar) {
+        threads.push_back(std::this_thread::get_id());
+        bar.x = int(captured.IsLocked());
+    });
+    world.OrderSystems();
+    REQUIRE(world.GetExecutionPlan().GetWaves().size() == 1);
+
+    for (int frame = 0; frame < 10; frame++)
+        world.RunSystems();
+
+    REQUIRE(threads.size() == 20);
+    for (const auto thread : threads)
+        REQUIRE(thread == std::this_thread::get_id());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Concurrent systems structural changes", "[System][Schedule][Parallel]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+    struct Created { int x; };
+    struct FooDone { };
+    struct BarDone { };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+    {
+        world.Entity().Add<Foo>(i).Apply();
+        world.Entity().Add<Bar>(i).Apply();
+    }
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+    world.SetParallelSystems(true);
+
+    // Systems don't take world as an argument, so they are not exclusive and run concurrently in the same wave.
+    // Captured world is used only for structural changes, which are recorded to the task command buffers.
+    World& captured = world;
+    world.System("foo").With<Foo>().Without<FooDone>().ForEach([&captured](EntityId id, const Foo& foo) {
+        captured.Entity().Add<Created>(foo.x).Apply();
+        captured.GetEntity(id).Edit().Add<FooDone>().Apply();
+    });
+    world.System("bar").With<Bar>().Without<BarDone>().ForEach([&captured](EntityId id, const Bar& bar) {
+        captured.Entity().Add<Created>(-bar.x - 1).Apply();
+        if (bar.x % 2)
+            captured.Destroy(id);
+        else
+            captured.GetEntity(id).Edit().Add<BarDone>().Apply();
+    });
+    world.OrderSystems();
+
+    const auto& nodes = world.GetExecutionPlan().GetNodes();
+    REQUIRE(nodes.size() == 2);
+    REQUIRE(nodes[0].wave == nodes[1].wave);
+
+    for (int run = 0; run < 2; run++)
+    {
+        world.RunSystems();
+        REQUIRE(!world.IsLocked());
+    }
+
+    // Commands of each system are applied in its iteration order.
+    int nextFoo = 0;
+    int nextBar = -1;
+    world.View().With<Created>().ForEach([&](EntityId id, const Created& created) {
+        REQUIRE(world.IsAlive(id));
+        if (created.x >= 0)
+            REQUIRE(created.x == nextFoo++);
+        else
+            REQUIRE(created.x == nextBar--);
+    });
+    REQUIRE(nextFoo == EntitiesCount);
+    REQUIRE(nextBar == -EntitiesCount - 1);
+
+    int fooDone = 0;
+    world.View().With<Foo, FooDone>().ForEach([&fooDone]() { fooDone++; });
+    REQUIRE(fooDone == EntitiesCount);
+
+    int barDone = 0;
+    world.View().With<Bar>().ForEach([&barDone](const Bar& bar) {
+        REQUIRE(bar.x % 2 == 0);
+        barDone++;
+    });
+    REQUIRE(barDone == EntitiesCount / 2);
+
+    // Ids reserved by tasks are committed, so records are created as usual afterwards.
+    REQUIRE(world.Entity().Add<Created>(0).Apply().IsAlive());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Parallel events", "[Event][Parallel]")
+{
+    struct Foo { int x; };
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Add<int>(i).Apply();
+
+    RR::Common::Threading::JobSystem jobSystem(4);
+    world.SetJobSystem(&jobSystem);
+
+    eastl::vector<int> received;
+    world.System().With<int>().OnEvent<IntEvent>().ForEach([&received](const IntEvent& event) { received.push_back(event.value); });
+
+    int broadcasts = 0;
+    world.System().With<Foo>().OnEvent<FloatEvent>().ForEach([&broadcasts]() { broadcasts++; });
+
+    const auto system = world.System().With<Foo>().Parallel(8).ForEach([](World& world, EntityId id, const Foo& foo) {
+        world.Emit<IntEvent>(id, {foo.x});
+        if (foo.x % 100 == 0)
+            world.Emit(FloatEvent {0.0f});
+    });
+    world.OrderSystems();
+
+    // Events are merged in the iteration order, regardless of the tasks scheduling.
+    eastl::vector<int> expected;
+    world.View().With<Foo>().ForEach([&expected](const Foo& foo) { expected.push_back(foo.x); });
+
+    system.Run();
+    REQUIRE(received.empty());
+
+    world.ProcessDefferedEvents();
+    REQUIRE(received == expected);
+    // Broadcast events are delivered to every entity.
+    REQUIRE(broadcasts == EntitiesCount / 100 * EntitiesCount);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Execution plan", "[System][Schedule]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+    struct Baz { int x; };
+
+    world.System("writeFoo").With<Foo>().ForEach([](Foo& foo) { foo.x = 1; });
+    world.System("readFoo").With<Foo, Baz>().ForEach([](const Foo& foo, Baz& baz) { baz.x = foo.x * 2; });
+    world.System("writeBar").With<Bar>().ForEach([](Bar& bar) { bar.x = 3; });
+    world.System("readBar").With<Bar>().ForEach([](Bar bar) { UNUSED(bar); });
+    world.System("world").ForEach([](World& world) { UNUSED(world); });
+    world.System("event").With<Foo>().OnEvent<TestEvent>().ForEach([](Foo& foo) { UNUSED(foo); });
+    world.OrderSystems();
+
+    const auto& plan = world.GetExecutionPlan();
+    REQUIRE(plan.GetNodes().size() == 5);
+
+    auto getWave = [&plan](const char* name) {
+        for (const auto& node : plan.GetNodes())
+            if (node.name.string == name)
+                return node.wave;
+
+        FAIL("System not found");
+        return 0u;
+    };
+
+    REQUIRE(getWave("writeFoo") != getWave("readFoo"));
+    REQUIRE(getWave("writeBar") != getWave("readBar"));
+    REQUIRE((getWave("writeFoo") == getWave("writeBar") || getWave("writeFoo") == getWave("readBar")));
+
+    const auto worldWave = getWave("world");
+    for (const auto& node : plan.GetNodes())
+        REQUIRE((node.wave != worldWave || node.name.string == "world"));
+
+    REQUIRE(plan.Dump().find("digraph") != std::string::npos);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Run systems", "[System][Schedule]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+    struct Baz { int x; };
+
+    constexpr int EntitiesCount = 1000;
+    for (int i = 0; i < EntitiesCount; i++)
+        world.Entity().Add<Foo>(i).Add<Bar>(i).Add<Baz>(0).Apply();
+
+    world.System("system1").Produce<System1>().With<Foo>().ForEach([](Foo& foo) { foo.x += 1; });
+    world.System("system2").Require<System1>().With<Foo, Baz>().ForEach([](const Foo& foo, Baz& baz) { baz.x += foo.x; });
+    world.System("system3").With<Bar>().ForEach([](Bar& bar) { bar.x *= 2; });
+    world.System("system4").Require<System1>().With<Baz>().ForEach([](World& world, EntityId id, const Baz& baz) {
+        if (baz.x % 2)
+            world.Destroy(id);
+    });
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+
+    auto check = [&] {
+        world.Tick();
+
+        int count = 0;
+        world.View().With<Foo, Bar, Baz>().ForEach([&count](const Foo& foo, const Bar& bar, const Baz& baz) {
+            REQUIRE(baz.x == foo.x);
+            REQUIRE(bar.x == (foo.x - 1) * 2);
+            count++;
+        });
+        REQUIRE(count == EntitiesCount / 2);
+    };
+
+    SECTION("Serial") { check(); }
+    SECTION("Job system")
+    {
+        world.SetJobSystem(&jobSystem);
+        world.SetParallelSystems(true);
+        check();
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Changed systems", "[System][Schedule]")
+{
+    struct Transform { float x; };
+    struct Proxy { float x; };
+    struct Velocity { float x; };
+
+    constexpr int EntitiesCount = 1000;
+    eastl::vector<EntityId> staticEntities;
+    for (int i = 0; i < EntitiesCount; i++)
+    {
+        if (i % 2)
+            world.Entity().Add<Transform>(float(i)).Add<Proxy>(0.0f).Add<Velocity>(1.0f).Apply();
+        else
+            staticEntities.push_back(world.Entity().Add<Transform>(float(i)).Add<Proxy>(0.0f).Apply().GetId());
+    }
+
+    int rebuilt = 0;
+    world.System("move").Produce<System1>().With<Velocity, Transform>().ForEach([](const Velocity& velocity, Transform& transform) { transform.x += velocity.x; });
+    world.System("rebuild").Require<System1>().With<Proxy>().Changed<Transform>().ForEach([&rebuilt](const Transform& transform, Proxy& proxy) {
+        proxy.x = transform.x;
+        rebuilt++;
+    });
+    world.OrderSystems();
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+
+    auto check = [&] {
+        auto run = [&] {
+            rebuilt = 0;
+            world.RunSystems();
+
+            bool synced = true;
+            world.View().With<Transform, Proxy>().ForEach([&synced](const Transform& transform, const Proxy& proxy) { synced &= transform.x == proxy.x; });
+            REQUIRE(synced);
+            return rebuilt;
+        };
+
+        // Created entities are changed.
+        REQUIRE(run() == EntitiesCount);
+        REQUIRE(run() == EntitiesCount / 2);
+
+        world.View().With<Transform>().ForEntity(staticEntities.front(), [](Transform& transform) { transform.x = -1.0f; });
+        REQUIRE(run() > EntitiesCount / 2);
+        REQUIRE(run() == EntitiesCount / 2);
+    };
+
+    SECTION("Serial") { check(); }
+    SECTION("Job system")
+    {
+        world.SetJobSystem(&jobSystem);
+        world.SetParallelSystems(true);
+        check();
+    }
+}
+
+TEST_CASE_METHOD(WorldFixture, "Reorder systems", "[System][Schedule]")
+{
+    world.Entity().Add<int>(0).Apply();
+
+    int calls = 0;
+    world.System("system1").With<int>().ForEach([&calls](int) { calls += 1; });
+    world.System("system2").With<int>().OnEvent<TestEvent>().ForEach([&calls](int) { calls += 10; });
+    world.OrderSystems();
+
+    world.RunSystems();
+    world.EmitImmediately<TestEvent>({});
+    REQUIRE(calls == 11);
+
+    // System could be run directly before ordering.
+    const auto system3 = world.System("system3").With<int>().ForEach([&calls](int) { calls += 100; });
+    system3.Run();
+    REQUIRE(calls == 111);
+
+    world.System("system4").With<int>().OnEvent<TestEvent>().ForEach([&calls](int) { calls += 1000; });
+    world.OrderSystems();
+
+    calls = 0;
+    world.RunSystems();
+    world.EmitImmediately<TestEvent>({});
+    REQUIRE(calls == 1111);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Destroy systems", "[System][Schedule]")
+{
+    world.Entity().Add<int>(0).Apply();
+
+    int calls = 0;
+    const auto system1 = world.System("system1").With<int>().ForEach([&calls](int) { calls += 1; });
+    const auto system2 = world.System("system2").With<int>().ForEach([&calls](int) { calls += 10; });
+    const auto system3 = world.System("system3").With<int>().OnEvent<TestEvent>().ForEach([&calls](int) { calls += 100; });
+    world.System("system4").With<int>().OnEvent<TestEvent>().ForEach([&calls](int) { calls += 1000; });
+    world.OrderSystems();
+
+    // Rest of the systems are moved within the archetype, so they have to be ordered again.
+    world.Destroy(EntityId(system1.GetId().GetRaw()));
+    world.Destroy(EntityId(system3.GetId().GetRaw()));
+
+    // System could be run directly before ordering.
+    system2.Run();
+    REQUIRE(calls == 10);
+
+    world.OrderSystems();
+    REQUIRE(world.GetExecutionPlan().GetNodes().size() == 1);
+
+    calls = 0;
+    world.RunSystems();
+    world.EmitImmediately<TestEvent>({});
+    REQUIRE(calls == 1010);
+
+    world.DestroyEntities(world.View().With<SystemDescription>());
+    world.OrderSystems();
+    REQUIRE(world.GetExecutionPlan().GetNodes().empty());
+
+    calls = 0;
+    world.RunSystems();
+    world.EmitImmediately<TestEvent>({});
+    REQUIRE(calls == 0);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Systems created by running systems", "[System][Schedule]")
+{
+    struct Spawner { };
+    world.Entity().Add<int>(0).Apply();
+
+    int spawnerCalls = 0;
+    int laterCalls = 0;
+    int spawnedCalls = 0;
+    int eventCalls = 0;
+    world.System("spawner").Produce<Spawner>().With<int>().ForEach([&spawnerCalls, &spawnedCalls](World& world, EntityId id, int) {
+        if (spawnerCalls++ == 0)
+            world.System("spawned").With<int>().ForEach([&spawnedCalls](int) { spawnedCalls++; });
+
+        world.Emit(TestEvent {});
+        world.Emit(id, TestEvent {});
+    });
+    world.System("later").Require<Spawner>().With<int>().ForEach([&laterCalls](int) { laterCalls++; });
+    world.System("listener").With<int>().OnEvent<TestEvent>().ForEach([&eventCalls](int) { eventCalls++; });
+
+    // Rest of the frame and the new system run after the plan is rebuilt, deferred events are delivered with the new order.
+    world.Tick();
+    REQUIRE(spawnerCalls == 1);
+    REQUIRE(laterCalls == 1);
+    REQUIRE(spawnedCalls == 1);
+    REQUIRE(eventCalls == 2);
+    REQUIRE(world.GetExecutionPlan().GetNodes().size() == 3);
+
+    world.Tick();
+    REQUIRE(spawnerCalls == 2);
+    REQUIRE(laterCalls == 2);
+    REQUIRE(spawnedCalls == 2);
+    REQUIRE(eventCalls == 4);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Profiling", "[System][Profile]")
+{
+    struct Foo { int x; };
+    struct Bar { int x; };
+
+    constexpr int EntitiesCount = 1000;
+    world.CreateEntities<Foo>(EntitiesCount, [](Foo& foo) { foo.x = 1; });
+
+    world.System("spawner").With<Foo>().ForEach([](World& world, EntityId id, const Foo& foo) {
+        if (foo.x == 1)
+            world.GetEntity(id).Edit().Add<Bar>(0).Apply();
+    });
+    world.System("listener").With<Foo>().OnEvent<TestEvent>().ForEach([](Foo&) { });
+    world.OrderSystems();
+
+    const auto findSystem = [this](const char* name) {
+        const auto& systems = world.GetProfile().systems;
+        const auto it = eastl::find_if(systems.begin(), systems.end(), [name](const SystemProfile& system) { return system.name.string == name; });
+        REQUIRE(it != systems.end());
+        return *it;
+    };
+
+    SECTION("Disabled")
+    {
+        world.RunSystems();
+        REQUIRE(findSystem("spawner").runs == 0);
+        REQUIRE(world.GetProfile().processedCommands == 0);
+    }
+
+    SECTION("Enabled")
+    {
+        world.EnableProfiling(true);
+        world.RunSystems();
+        world.EmitImmediately<TestEvent>({});
+        world.ProcessTrackedChanges();
+
+        const auto spawner = findSystem("spawner");
+        REQUIRE(spawner.runs == 1);
+        REQUIRE(spawner.entities == EntitiesCount);
+        REQUIRE(spawner.chunks > 0);
+        // Mutations and the cache initialization of the created archetype.
+        REQUIRE(spawner.commands == EntitiesCount + 1);
+        REQUIRE(spawner.eventDispatches == 0);
+        REQUIRE(world.GetProfile().processedCommands == EntitiesCount + 1);
+
+        // Broadcast is dispatched once per matched archetype, the emptied one as well.
+        const auto listener = findSystem("listener");
+        REQUIRE(listener.runs == 0);
+        REQUIRE(listener.eventDispatches == 2);
+
+        world.ResetProfile();
+        REQUIRE(findSystem("spawner").runs == 0);
+        REQUIRE(world.GetProfile().processedCommands == 0);
+    }
+
+    SECTION("Archetypes")
+    {
+        eastl::vector<ArchetypeProfile> archetypes;
+        world.GetArchetypesProfile(archetypes);
+        REQUIRE(eastl::is_sorted(archetypes.begin(), archetypes.end(), [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; }));
+
+        const auto it = eastl::find_if(archetypes.begin(), archetypes.end(), [](const ArchetypeProfile& archetype) { return archetype.entitiesCount == EntitiesCount; });
+        REQUIRE(it != archetypes.end());
+        REQUIRE(it->chunksCount == (EntitiesCount + it->chunkCapacity - 1) / it->chunkCapacity);
+        REQUIRE(it->fillRatio > 0.0f);
+        REQUIRE(it->fillRatio <= 1.0f);
+        REQUIRE(it->wastedBytes < it->chunkSize * it->chunksCount);
+    }
+}
@@ -188,4 +188,141 @@ TEST_CASE("Trackable singleton", "[Singleton][Tracking]")
 
     SECTION("Immediate") { immediateTest(test, check); }
     SECTION("Deffered") { defferedTest(test, check); }
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(WorldFixture, "Tracked changes follow moved entity", "[Tracking]")
+{
+    eastl::vector<EntityId> entities;
+    for (int i = 0; i < 5000; i++)
+        entities.push_back(world.Entity().Add<TrackableInt>(i).Apply().GetId());
+
+    eastl::vector<int> results;
+    world.System().Track<TrackableInt>().ForEach([&](const TrackableInt& trackableInt) {
+        results.push_back(trackableInt.x);
+    });
+    world.OrderSystems();
+
+    // Last entity lives in the last chunk, after deletion it's moved to the first one.
+    world.View().With<TrackableInt>().ForEntity(entities.back(), [](TrackableInt& trackableInt) { trackableInt.x = -1; });
+    world.Destroy(entities.front());
+
+    world.ProcessTrackedChanges();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0] == -1);
+
+    // Read only access doesn't produce changes.
+    world.View().With<TrackableInt>().ForEach([](const TrackableInt& trackableInt) { UNUSED(trackableInt); });
+    world.ProcessTrackedChanges();
+    REQUIRE(results.size() == 1);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Bulk created tracked components", "[Tracking]")
+{
+    eastl::vector<int> results;
+    world.System().Track<TrackableInt>().ForEach([&](const TrackableInt& trackableInt) {
+        results.push_back(trackableInt.x);
+    });
+    world.OrderSystems();
+
+    world.CreateEntities<TrackableInt>(100, [](TrackableInt& trackableInt) { trackableInt.x = 1; });
+    world.ProcessTrackedChanges();
+    REQUIRE(results.empty());
+
+    world.View().With<TrackableInt>().ForEach([](TrackableInt& trackableInt) { trackableInt.x = 2; });
+    world.ProcessTrackedChanges();
+    REQUIRE(results.size() == 100);
+}
+
+TEST_CASE("Delta replication", "[Tracking][Snapshot]")
+{
+    struct Tag { };
+
+    const auto setup = [](World& world, eastl::vector<int>& changes) {
+        world.System().Track<TrackableInt>().ForEach([&changes](const TrackableInt& trackableInt) { changes.push_back(trackableInt.x); });
+        world.OrderSystems();
+
+        world.RegisterComponent<TrackableInt>();
+        world.RegisterComponent<float>();
+        world.RegisterComponent<Tag>();
+    };
+
+    const auto getState = [](World& world) {
+        eastl::vector<eastl::pair<uint32_t, int>> state;
+        world.View().With<TrackableInt>().ForEach([&state](EntityId id, const TrackableInt& trackableInt) { state.emplace_back(id.GetRaw(), trackableInt.x); });
+        world.View().With<float>().ForEach([&state](EntityId id, float value) { state.emplace_back(id.GetRaw(), int(value) + 1000); });
+        world.View().With<Tag>().ForEach([&state](EntityId id) { state.emplace_back(id.GetRaw(), -1); });
+        eastl::sort(state.begin(), state.end());
+        return state;
+    };
+
+    eastl::vector<int> sourceChanges, replicaChanges;
+    World source, replica;
+    setup(source, sourceChanges);
+    setup(replica, replicaChanges);
+
+    eastl::vector<EntityId> entities;
+    for (int i = 0; i < 200; i++)
+        entities.push_back(source.Entity().Add<TrackableInt>(i).Apply().GetId());
+
+    eastl::vector<std::byte> buffer;
+    REQUIRE(source.SaveSnapshot(buffer));
+    REQUIRE(replica.LoadSnapshot(buffer));
+    source.EnableDeltaCapture(true);
+
+    // Nothing is changed, so delta is empty.
+    buffer.clear();
+    REQUIRE(source.CaptureDelta(buffer));
+    const size_t emptyDeltaSize = buffer.size();
+    REQUIRE(replica.ApplyDelta(buffer));
+    REQUIRE(getState(source) == getState(replica));
+
+    source.View().With<TrackableInt>().ForEntity(entities[10], [](TrackableInt& trackableInt) { trackableInt.x = -10; });
+    source.View().With<TrackableInt>().ForEntity(entities[20], [](TrackableInt& trackableInt) { trackableInt.x = -20; });
+    source.GetEntity(entities[30]).Edit().Add<float>(30.0f).Apply();
+    source.Destroy(entities[40]);
+    const auto created = source.Entity().Add<float>(50.0f).Add<Tag>().Apply().GetId();
+    // Created and destroyed in between of captures.
+    source.Destroy(source.Entity().Add<Tag>().Apply().GetId());
+
+    buffer.clear();
+    REQUIRE(source.CaptureDelta(buffer));
+    REQUIRE(sourceChanges.size() == 2);
+    // Only changed entities are written, not the whole world.
+    REQUIRE(buffer.size() < emptyDeltaSize + 256);
+
+    REQUIRE(replica.ApplyDelta(buffer));
+    REQUIRE(getState(source) == getState(replica));
+    REQUIRE(replica.IsAlive(created));
+    REQUIRE(!replica.IsAlive(entities[40]));
+
+    replica.ProcessTrackedChanges();
+    eastl::sort(replicaChanges.begin(), replicaChanges.end());
+    REQUIRE(replicaChanges == eastl::vector<int> {-20, -10});
+
+    // Recycled id is replicated with its generation.
+    source.Destroy(created);
+    const auto recycled = source.Entity().Add<TrackableInt>(60).Apply().GetId();
+    REQUIRE(recycled.GetIndex() == created.GetIndex());
+
+    buffer.clear();
+    REQUIRE(source.CaptureDelta(buffer));
+    REQUIRE(replica.ApplyDelta(buffer));
+    REQUIRE(getState(source) == getState(replica));
+    REQUIRE(!replica.IsAlive(created));
+    REQUIRE(replica.IsAlive(recycled));
+
+    REQUIRE(!replica.ApplyDelta({buffer.data(), buffer.size() - 1}));
+    REQUIRE(getState(source) == getState(replica));
+
+    // Capture is refused in every build, changes are kept until the component is gone.
+    const auto named = source.Entity().Add<TrackableInt>(70).Add<eastl::string>("string").Apply().GetId();
+    buffer.clear();
+    REQUIRE(!source.CaptureDelta(buffer));
+    REQUIRE(buffer.empty());
+
+    source.GetEntity(named).Edit().Remove<eastl::string>().Apply();
+    REQUIRE(source.CaptureDelta(buffer));
+    REQUIRE(replica.ApplyDelta(buffer));
+    REQUIRE(getState(source) == getState(replica));
+    REQUIRE(replica.IsAlive(named));
+}
@@ -331,3 +331,301 @@ TEST_CASE_METHOD(WorldFixture, "Mixed components and singleton", "[Query]")
     query.ForEach([&](SingletonComponent<int>& singleton, int i) { result = singleton.x + i; });
     REQUIRE(result == 146);
 }
+
+TEST_CASE_METHOD(WorldFixture, "Query parallel", "[Query][Parallel]")
+{
+    // clang-format off
+    struct Foo { int x; };
+    struct Bar { int x; };
+    // clang-format on
+
+    constexpr int EntitiesCount = 10000;
+    for (int i = 0; i < EntitiesCount; i++)
+    {
+        if (i % 2)
+            world.Entity().Add<Foo>(1).Apply();
+        else
+            world.Entity().Add<Foo>(1).Add<Bar>(1).Apply();
+    }
+
+    RR::Common::Threading::JobSystem jobSystem(3);
+    world.SetJobSystem(&jobSystem);
+
+    std::atomic<int> summ = 0;
+    const auto query = world.Query().With<Foo>().Parallel().Build();
+    query.ForEach([&summ](const Foo& foo) {
+        summ += foo.x;
+    });
+
+    REQUIRE(summ == EntitiesCount);
+    REQUIRE(!world.IsLocked());
+}
+
+TEST_CASE_METHOD(WorldFixture, "Query chunks", "[Query]")
+{
+    // clang-format off
+    struct Position { float x; };
+    struct Velocity { float x; };
+    struct Bar { char x; };
+    // clang-format on
+
+    constexpr int EntitiesCount = 1000;
+    for (int i = 0; i < EntitiesCount; i++)
+    {
+        if (i % 2)
+            world.Entity().Add<Position>(0.0f).Add<Velocity>(float(i)).Apply();
+        else
+            world.Entity().Add<Bar>('a').Add<Position>(0.0f).Add<Velocity>(float(i)).Apply();
+    }
+
+    const auto query = world.Query().With<Position, Velocity>().Build();
+
+    size_t entities = 0;
+    size_t chunks = 0;
+    query.ForEachChunk([&](eastl::span<Position> positions, eastl::span<const Velocity> velocities, eastl::span<const EntityId> ids) {
+        REQUIRE(positions.size() == velocities.size());
+        REQUIRE(positions.size() == ids.size());
+        REQUIRE(positions.size() > 0);
+        REQUIRE(RR::IsAlignedTo(positions.data(), Archetype::ColumnAlignment));
+        REQUIRE(RR::IsAlignedTo(velocities.data(), Archetype::ColumnAlignment));
+
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i].x += velocities[i].x;
+
+        entities += positions.size();
+        chunks++;
+    });
+
+    REQUIRE(entities == EntitiesCount);
+    REQUIRE(chunks >= 2);
+    REQUIRE(!world.IsLocked());
+
+    float summ = 0;
+    world.View().With<Position>().ForEach([&summ](const Position& position) { summ += position.x; });
+    REQUIRE(summ == float(EntitiesCount * (EntitiesCount - 1) / 2));
+}
+
+TEST_CASE("Query changed filter", "[Query]")
+{
+    // clang-format off
+    struct Position { float x; };
+    struct Velocity { float x; };
+    // clang-format on
+
+    ChunkPoolDescription description;
+    description.baseChunkSize = 4 * 1024;
+    description.minEntitiesPerChunk = 16;
+    World world(description);
+
+    eastl::vector<EntityId> entities;
+    world.CreateEntities<Position, Velocity>(1000, [&entities](EntityId id) { entities.push_back(id); });
+
+    const auto query = world.Query().Changed<Position>().Build();
+    auto changedChunks = [&query]() {
+        size_t chunks = 0;
+        query.ForEachChunk([&chunks](eastl::span<const Position>) { chunks++; });
+        return chunks;
+    };
+
+    // Created entities are changed.
+    const size_t chunksCount = changedChunks();
+    REQUIRE(chunksCount > 2);
+    REQUIRE(changedChunks() == 0);
+
+    world.View().With<Position>().ForEach([](const Position&) { });
+    world.View().With<Velocity>().ForEach([](Velocity& velocity) { velocity.x = 1.0f; });
+    REQUIRE(changedChunks() == 0);
+
+    world.View().With<Position>().ForEntity(entities.back(), [](Position& position) { position.x = 1.0f; });
+    REQUIRE(changedChunks() == 1);
+
+    world.Entity().Add<Position>(0.0f).Add<Velocity>(0.0f).Apply();
+    REQUIRE(changedChunks() == 1);
+
+    // Last entity is moved to the place of destroyed one.
+    world.Destroy(entities.front());
+    REQUIRE(changedChunks() == 1);
+
+    SECTION("Own changes")
+    {
+        const auto moveQuery = world.Query().Changed<Velocity>().Build();
+        size_t moved = 0;
+        auto move = [&moveQuery, &moved]() {
+            moved = 0;
+            moveQuery.ForEach([&moved](Velocity& velocity) { velocity.x += 1.0f; moved++; });
+            return moved;
+        };
+
+        REQUIRE(move() == 1000);
+        REQUIRE(move() == 0);
+        REQUIRE(changedChunks() == 0);
+    }
+
+    SECTION("View")
+    {
+        const uint32_t version = world.GetChangeVersion();
+        world.View().With<Position>().ForEntity(entities[1], [](Position& position) { position.x = 2.0f; });
+
+        size_t count = 0;
+        world.View().Changed<Position>().ChangedSince(version).ForEach([&count](const Position&) { count++; });
+        REQUIRE(count > 0);
+        REQUIRE(count < entities.size());
+
+        count = 0;
+        world.View().Changed<Position>().ForEach([&count](const Position&) { count++; });
+        REQUIRE(count == entities.size());
+    }
+}
+
+TEST_CASE("Change version wrap", "[Query]")
+{
+    // clang-format off
+    struct Position { float x; };
+    struct Tag { };
+    // clang-format on
+
+    World world;
+    const auto moved = world.Entity().Add<Position>(0.0f).Apply().GetId();
+    world.Entity().Add<Position>(0.0f).Add<Tag>().Apply();
+
+    const auto query = world.Query().Changed<Position>().Build();
+    auto changedCount = [&query]() {
+        size_t count = 0;
+        query.ForEach([&count](const Position&) { count++; });
+        return count;
+    };
+    auto move = [&world, moved]() { world.View().With<Position>().ForEntity(moved, [](Position& position) { position.x += 1.0f; }); };
+
+    REQUIRE(changedCount() == 2);
+    REQUIRE(changedCount() == 0);
+
+    SECTION("Stale query")
+    {
+        // Query is older than the signed distance, its version is clamped on the way.
+        world.AdvanceChangeVersion((1u << 31) + 1000);
+        move();
+        // Clamped chunk is reported as changed to the clamped query, the same as after a missed run.
+        REQUIRE(changedCount() == 2);
+        REQUIRE(changedCount() == 0);
+
+        move();
+        REQUIRE(changedCount() == 1);
+    }
+
+    SECTION("Counter wrap")
+    {
+        world.AdvanceChangeVersion(0u - world.GetChangeVersion() - 10);
+        REQUIRE(changedCount() == 2);
+
+        for (int run = 0; run < 20; run++)
+        {
+            move();
+            REQUIRE(changedCount() == 1);
+            REQUIRE(changedCount() == 0);
+        }
+        REQUIRE(world.GetChangeVersion() < 100);
+
+        // Views, which have never run, see all chunks.
+        size_t count = 0;
+        world.View().Changed<Position>().ForEach([&count](const Position&) { count++; });
+        REQUIRE(count == 2);
+    }
+}
+
+namespace
+{
+    template <int Index>
+    struct IndexedComponent { int x; };
+}
+
+TEST_CASE_METHOD(WorldFixture, "Query many archetypes", "[Query]")
+{
+    using C0 = IndexedComponent<0>;
+    using C1 = IndexedComponent<1>;
+    using C2 = IndexedComponent<2>;
+    using C3 = IndexedComponent<3>;
+    using C4 = IndexedComponent<4>;
+    using C5 = IndexedComponent<5>;
+    using C6 = IndexedComponent<6>;
+    using C7 = IndexedComponent<7>;
+
+    const auto queryBefore = world.Query().With<C0, C3>().Without<C5>().Build();
+
+    // Every non empty combination of components is a separate archetype.
+    constexpr uint32_t CombinationsCount = 256;
+    for (uint32_t mask = 1; mask < CombinationsCount; mask++)
+    {
+        const auto entity = world.EmptyEntity();
+        auto add = [&](uint32_t bit, auto component) {
+            if (mask & (1u << bit))
+                entity.Edit().Add<decltype(component)>(int(mask)).Apply();
+        };
+        add(0, C0 {}); add(1, C1 {}); add(2, C2 {}); add(3, C3 {});
+        add(4, C4 {}); add(5, C5 {}); add(6, C6 {}); add(7, C7 {});
+    }
+
+    const auto queryAfter = world.Query().With<C0, C3>().Without<C5>().Build();
+
+    uint32_t expected = 0;
+    for (uint32_t mask = 1; mask < CombinationsCount; mask++)
+        expected += (mask & 0b1001) == 0b1001 && !(mask & 0b100000) ? mask : 0;
+
+    auto check = [expected](auto&& iterable) {
+        uint32_t summ = 0;
+        iterable.ForEach([&summ](const C0& c0, const C3& c3) {
+            REQUIRE(c0.x == c3.x);
+            summ += c0.x;
+        });
+        REQUIRE(summ == expected);
+    };
+
+    check(queryBefore);
+    check(queryAfter);
+    check(world.View().With<C0, C3>().Without<C5>());
+
+    uint32_t total = 0;
+    world.View().With<C7>().ForEach([&total](const C7&) { total++; });
+    REQUIRE(total == CombinationsCount / 2);
+}
+
+TEST_CASE_METHOD(WorldFixture, "Depth ordered query", "[Query][Hierarchy]")
+{
+    struct Node
+    {
+        int local;
+        int global;
+    };
+
+    // Children are created before parents, so creation order of archetypes is reversed.
+    const auto leaf = world.Entity().Add<Node>(1, 0).Apply().GetId();
+    const auto middle = world.Entity().Add<Node>(10, 0).Apply().GetId();
+    const auto root = world.Entity().Add<Node>(100, 0).Apply().GetId();
+    world.SetParent(leaf, middle);
+    world.SetParent(middle, root);
+
+    const auto query = world.Query().With<Node>().InDepthOrder().Build();
+    // Archetypes created after the query are inserted in depth order as well.
+    const auto secondLeaf = world.Entity().Add<Node>(2, 0).Add<float>().Apply().GetId();
+    world.SetParent(secondLeaf, middle);
+
+    auto propagate = [this](EntityId entityId, Node& node, const ChildOf* childOf) {
+        UNUSED(entityId);
+        node.global = node.local;
+        if (childOf)
+            world.View().With<Node>().ForEntity(childOf->parent, [&node](const Node& parent) { node.global += parent.global; });
+    };
+
+    auto check = [&] {
+        world.View().With<Node>().ForEntity(leaf, [](const Node& node) { REQUIRE(node.global == 111); });
+        world.View().With<Node>().ForEntity(secondLeaf, [](const Node& node) { REQUIRE(node.global == 112); });
+    };
+
+    query.ForEach(propagate);
+    check();
+
+    world.View().With<Node>().ForEach([](Node& node) { node.global = 0; });
+    world.View().With<Node>().InDepthOrder().ForEach(propagate);
+    check();
+
+    REQUIRE_THROWS(world.Query().With<Node>().InDepthOrder().Parallel().Build());
+}
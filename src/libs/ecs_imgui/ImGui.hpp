@@ -8,6 +8,8 @@ namespace RR::ImGuiEcs
 {
     void Init(RR::Ecs::World& world, ImGuiContext* ctx);
     void Draw(RR::Ecs::World& world);
+    // Window with the world profile and archetypes memory report, should be called between ImGui frame begin and render.
+    void DrawProfiler(RR::Ecs::World& world, bool* open = nullptr);
 
     struct Context
     {
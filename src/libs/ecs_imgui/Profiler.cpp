@@ -0,0 +1,148 @@
+#include "ImGui.hpp"
+#include "ecs/Ecs.hpp"
+#include <imgui.h>
+
+namespace RR::ImGuiEcs
+{
+    namespace
+    {
+        float toMilliseconds(std::chrono::nanoseconds duration)
+        {
+            return std::chrono::duration<float, std::milli>(duration).count();
+        }
+
+        void drawSystems(const Ecs::WorldProfile& profile)
+        {
+            ImGui::Text("Tracked changes: %.3f ms", toMilliseconds(profile.trackedChangesTime));
+            ImGui::Text("Commands: %.3f ms, %llu processed", toMilliseconds(profile.commandsTime), static_cast<unsigned long long>(profile.processedCommands));
+
+            constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+            if (!ImGui::BeginTable("Systems", 8, flags))
+                return;
+
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("System");
+            ImGui::TableSetupColumn("Runs");
+            ImGui::TableSetupColumn("Run ms");
+            ImGui::TableSetupColumn("Entities");
+            ImGui::TableSetupColumn("Chunks");
+            ImGui::TableSetupColumn("Commands");
+            ImGui::TableSetupColumn("Events");
+            ImGui::TableSetupColumn("Event ms");
+            ImGui::TableHeadersRow();
+
+            for (const auto& system : profile.systems)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(system.name.string.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", system.runs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", toMilliseconds(system.runTime));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(system.entities));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(system.chunks));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(system.commands));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", system.eventDispatches);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", toMilliseconds(system.eventTime));
+            }
+
+            ImGui::EndTable();
+        }
+
+        void drawArchetypes(const Ecs::World& world)
+        {
+            // Kept to avoid reallocations every frame.
+            static eastl::vector<Ecs::ArchetypeProfile> archetypes;
+            world.GetArchetypesProfile(archetypes);
+
+            size_t reservedBytes = 0;
+            size_t wastedBytes = 0;
+            for (const auto& archetype : archetypes)
+            {
+                reservedBytes += archetype.chunksCount * archetype.chunkSize;
+                wastedBytes += archetype.wastedBytes;
+            }
+            ImGui::Text("Archetypes: %zu, chunks memory: %zu KiB, wasted: %zu KiB", archetypes.size(), reservedBytes / 1024, wastedBytes / 1024);
+
+            constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+            if (!ImGui::BeginTable("Archetypes", 8, flags))
+                return;
+
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Archetype");
+            ImGui::TableSetupColumn("Components");
+            ImGui::TableSetupColumn("Depth");
+            ImGui::TableSetupColumn("Entities");
+            ImGui::TableSetupColumn("Chunks");
+            ImGui::TableSetupColumn("Chunk size");
+            ImGui::TableSetupColumn("Fill");
+            ImGui::TableSetupColumn("Wasted");
+            ImGui::TableHeadersRow();
+
+            for (const auto& archetype : archetypes)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%016llx", static_cast<unsigned long long>(archetype.id.GetRaw()));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", archetype.componentsCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", archetype.hierarchyDepth);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", archetype.entitiesCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", archetype.chunksCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu x %zu", archetype.chunkSize, archetype.chunkCapacity);
+                ImGui::TableNextColumn();
+                ImGui::ProgressBar(archetype.fillRatio);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", archetype.wastedBytes);
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    void DrawProfiler(RR::Ecs::World& world, bool* open)
+    {
+        if (!ImGui::Begin("Ecs profiler", open))
+        {
+            ImGui::End();
+            return;
+        }
+
+        bool enabled = world.IsProfilingEnabled();
+        if (ImGui::Checkbox("Enabled", &enabled))
+            world.EnableProfiling(enabled);
+
+        ImGui::SameLine();
+        if (ImGui::Button("Reset"))
+            world.ResetProfile();
+
+        if (ImGui::BeginTabBar("Profile"))
+        {
+            if (ImGui::BeginTabItem("Systems"))
+            {
+                drawSystems(world.GetProfile());
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Archetypes"))
+            {
+                drawArchetypes(world);
+                ImGui::EndTabItem();
+            }
+
+            ImGui::EndTabBar();
+        }
+
+        ImGui::End();
+    }
+}
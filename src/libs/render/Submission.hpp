@@ -3,7 +3,7 @@
 #include "gapi/Device.hpp"
 
 #include "common/threading/Thread.hpp"
-#include "common/threading/BlockingRingQueue.hpp"
+#include "common/threading/MpscRingQueue.hpp"
 #include "common/threading/Event.hpp"
 
 #include <EASTL/fixed_function.h>
@@ -118,6 +118,6 @@ namespace RR::Render
         eastl::unique_ptr<Threading::Thread> submissionThread;
         Common::Threading::Event submissionEvent;
         Common::Threading::Mutex mutex;
-        Common::Threading::BlockingRingQueue<SubmissionThreadWork, 64> workQueue;
+        Common::Threading::MpscRingQueue<SubmissionThreadWork, 64> workQueue;
     };
 }
\ No newline at end of file